@@ -5,12 +5,275 @@
 #include <stdio.h>
 
 #include "Assembler.h"
+#include "BatchRunner.h"
+#include "Errors.h"
+#include "Telemetry.h"
+
+/*
+NAME:
+
+    RunBatch() - assembles the programs in a manifest and runs each on its inputs
+
+SYNOPSIS:
+
+    int RunBatch( const string& a_manifest, int a_threads, bool a_isLockstep, const string& a_telemetry );
+    a_manifest  --> the name of the manifest file
+    a_threads   --> the number of threads to run on, or 0 for one per processor
+    a_isLockstep --> true to run the inputs of each program in lockstep
+    a_telemetry --> the name to publish each thread's counters under, or empty
+
+DESCRIPTION:
+
+    Each line of the manifest names a source file, a file of input for the program's READs
+    and the file its output is written to. Each source file is assembled once, however many
+    lines name it, and its translation is run on every input by the batch runner. The
+    listing of a program that has errors is displayed and its runs are skipped, as are the
+    runs of a source file that cannot be opened.
+    With -lockstep, several inputs of a program are run at once by a LockstepEmulator.
+    With -telemetry, each thread's counters can be watched from another process with -watch.
+
+RETURNS:
+
+    int - 0 if every run was made, 1 otherwise
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+static int RunBatch( const string& a_manifest, int a_threads, bool a_isLockstep, const string& a_telemetry )
+{
+    ifstream manifest( a_manifest );
+    if( ! manifest ) {
+        cerr << "Manifest file " << a_manifest << " could not be opened." << endl;
+        return 1;
+    }
+
+    BatchRunner runner;
+    runner.setLockstep( a_isLockstep );
+    runner.setTelemetry( a_telemetry );
+    map<string, int> programs;      // The image of each source file, or -1 if it has errors.
+    vector<string> outputFiles;     // The output file of each run.
+    bool isComplete = true;
+
+    string line;
+    while( getline( manifest, line ) ) {
+        istringstream fields( line );
+        string source, inputFile, outputFile, extra;
+        if( ! ( fields >> source ) ) {
+            continue;
+        }
+        if( ! ( fields >> inputFile >> outputFile ) || ( fields >> extra ) ) {
+            cerr << "Error! Manifest line must be <SourceFile> <InputFile> <OutputFile>: " << line << endl;
+            isComplete = false;
+            continue;
+        }
+
+        // Assemble the program the first time it is named, keeping its listing quiet.  A source
+        // file that cannot be opened skips its runs, rather than ending the batch.
+        if( programs.find( source ) == programs.end() && ! ifstream( source ) ) {
+            cerr << "Error! Source file " << source << " could not be opened: " << line << endl;
+            programs[source] = -1;
+        }
+        if( programs.find( source ) == programs.end() ) {
+            ostringstream listing;
+            streambuf* console = cout.rdbuf( listing.rdbuf() );
+            Assembler assem( source );
+            assem.PassI();
+            assem.PassII();
+            cout.rdbuf( console );
+            if( Errors::NoError() ) {
+                programs[source] = runner.addProgram( assem.TakeProgramImage() );
+            }
+            else {
+                cout << listing.str();
+                cout << source << " cannot be run because of Errors!" << endl;
+                programs[source] = -1;
+            }
+        }
+        if( programs[source] < 0 ) {
+            isComplete = false;
+            continue;
+        }
+
+        ifstream input( inputFile );
+        if( ! input ) {
+            cerr << "Error! Input file " << inputFile << " could not be opened." << endl;
+            isComplete = false;
+            continue;
+        }
+        ostringstream contents;
+        contents << input.rdbuf();
+        runner.addRun( programs[source], contents.str() );
+        outputFiles.push_back( outputFile );
+    }
+
+    auto start = chrono::steady_clock::now();
+    runner.runAll( a_threads );
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+    for( int run = 0; run < runner.getRunCount(); run++ ) {
+        ofstream output( outputFiles[run] );
+        output << runner.getRun( run ).m_output;
+        if( ! output ) {
+            cerr << "Error! Output file " << outputFiles[run] << " could not be written." << endl;
+            isComplete = false;
+        }
+    }
+    cout << runner.getRunCount() << " runs of " << programs.size() << " programs in "
+        << elapsed.count() << " seconds" << endl;
+    return isComplete ? 0 : 1;
+}
+
+/*
+NAME:
+
+    WatchTelemetry() - displays the counters emulators publish, and their rates
+
+SYNOPSIS:
+
+    int WatchTelemetry( const string& a_name );
+    a_name      --> the name the counters are published under
+
+DESCRIPTION:
+
+    The segment of that name is watched, or if there is none, the segments of a batch's
+    threads, named a_name.0, a_name.1 and so on. The reader waits up to ten seconds for the
+    first of them to appear. Once a second the totals of all the segments are displayed,
+    with the rates since the last display, until every emulator has closed its segment.
+    Then the sampled share of each op code is displayed. The reader only maps the segments,
+    so it does not slow the emulators.
+
+RETURNS:
+
+    int - 0 if the counters were watched, 1 if no segment could be attached to
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+static int WatchTelemetry( const string& a_name )
+{
+    const char* opCodeNames[TelemetryStats::OP_CODES] = { "other", "ADD", "SUB", "MULT", "DIV", "LOAD", "STORE",
+        "ADDR", "SUBR", "MULTR", "DIVR", "READ", "WRITE", "B", "BM", "BZ", "BP", "HALT" };
+
+    vector<unique_ptr<TelemetrySegment>> segments;
+    for( int wait = 0; wait < 100 && segments.empty(); wait++ ) {
+        segments.emplace_back( new TelemetrySegment( a_name, false ) );
+        if( ! segments.back()->isOpen() ) {
+            segments.clear();
+            for( int worker = 0; ; worker++ ) {
+                unique_ptr<TelemetrySegment> segment( new TelemetrySegment( a_name + "." + to_string( worker ), false ) );
+                if( ! segment->isOpen() ) {
+                    break;
+                }
+                segments.push_back( move( segment ) );
+            }
+        }
+        if( segments.empty() ) {
+            this_thread::sleep_for( chrono::milliseconds( 100 ) );
+        }
+    }
+    if( segments.empty() ) {
+        cerr << "No telemetry is published under " << a_name << "." << endl;
+        return 1;
+    }
+    cout << "Watching " << segments.size() << " emulator(s) publishing under " << a_name << endl;
+
+    auto start = chrono::steady_clock::now();
+    auto last = start;
+    long long lastInstructions = 0, lastWrites = 0;
+    for( ; ; ) {
+        this_thread::sleep_for( chrono::seconds( 1 ) );
+
+        long long instructions = 0, writes = 0, readWaits = 0;
+        int running = 0, closed = 0;
+        for( auto& segment : segments ) {
+            TelemetryStats& stats = segment->getStats();
+            instructions += stats.m_instructions.load( memory_order_relaxed );
+            writes += stats.m_writes.load( memory_order_relaxed );
+            readWaits += stats.m_readWaits.load( memory_order_relaxed );
+            running += stats.m_isRunning.load( memory_order_relaxed );
+            closed += stats.m_isClosed.load( memory_order_acquire );
+        }
+        auto now = chrono::steady_clock::now();
+        chrono::duration<double> interval = now - last;
+        chrono::duration<double> elapsed = now - start;
+        last = now;
+
+        cout << fixed << setprecision( 1 ) << setw( 7 ) << elapsed.count() << " s  "
+            << setw( 14 ) << instructions << " instructions " << setw( 8 )
+            << ( instructions - lastInstructions ) / interval.count() / 1e6 << " M/s  "
+            << setw( 10 ) << writes << " writes " << setw( 10 ) << ( writes - lastWrites ) / interval.count() << " /s  "
+            << readWaits << " read waits  " << running << " running" << endl;
+        lastInstructions = instructions;
+        lastWrites = writes;
+
+        if( closed == static_cast<int>( segments.size() ) ) {
+            break;
+        }
+    }
+
+    cout << "Sampled share of instructions by op code:" << endl;
+    for( int opCode = 0; opCode < TelemetryStats::OP_CODES; opCode++ ) {
+        long long count = 0;
+        for( auto& segment : segments ) {
+            count += segment->getStats().m_opCodes[opCode].load( memory_order_relaxed );
+        }
+        if( count > 0 && lastInstructions > 0 ) {
+            cout << "\t" << left << setw( 8 ) << opCodeNames[opCode] << right << setw( 6 )
+                << 100.0 * count / lastInstructions << "%" << endl;
+        }
+    }
+    return 0;
+}
 
 int main( int argc, char *argv[] )
 {
+    // With -batch, run the programs and inputs listed in a manifest.
+    if( argc >= 3 && string( argv[1] ) == "-batch" ) {
+        int threads = 0;
+        bool isLockstep = false;
+        string telemetry;
+        for( int arg = 3; arg < argc; arg++ ) {
+            if( string( argv[arg] ) == "-lockstep" ) {
+                isLockstep = true;
+            }
+            else if( string( argv[arg] ) == "-telemetry" && arg + 1 < argc ) {
+                telemetry = argv[++arg];
+            }
+            else {
+                threads = atoi( argv[arg] );
+            }
+        }
+        return RunBatch( argv[2], threads, isLockstep, telemetry );
+    }
+
+    // With -watch, display the counters another process publishes under a name.
+    if( argc == 3 && string( argv[1] ) == "-watch" ) {
+        return WatchTelemetry( argv[2] );
+    }
+
 
     Assembler assem( argc, argv );
 
+    // With -perf, measure the passes and the run with the host's performance counters.
+    if( argc == 3 && string( argv[2] ) == "-perf" ) {
+        assem.MeasurePhases();
+        return 0;
+    }
+
     // Establish the location of the labels:
     assem.PassI( );
 
@@ -20,6 +283,54 @@ int main( int argc, char *argv[] )
     // Output the translation.
     assem.PassII( );
     
+    // With -cost, display the estimated instructions of the translation instead of running it.
+    if( argc == 3 && string( argv[2] ) == "-cost" ) {
+        assem.EstimateCost();
+        return 0;
+    }
+
+    // With -verify, display whether the translation can run without checks on its stores, then run it.
+    if( argc == 3 && string( argv[2] ) == "-verify" ) {
+        assem.VerifyProgram();
+    }
+
+    // With -cores, run the translation on one core for each label that follows.
+    if( argc >= 4 && string( argv[2] ) == "-cores" ) {
+        assem.RunProgramOnCores( vector<string>( argv + 3, argv + argc ) );
+        return 0;
+    }
+
+    // With -record, write a trace of the run, and with -replay, run it again from a trace.
+    if( argc >= 4 && string( argv[2] ) == "-record" ) {
+        assem.RecordProgramInEmulator( argv[3], argc == 5 );
+        return 0;
+    }
+    if( argc == 4 && string( argv[2] ) == "-replay" ) {
+        assem.ReplayProgramInEmulator( argv[3] );
+        return 0;
+    }
+
+    // With -cpp, write the translation as a C++ program instead of emulating it.
+    if( argc == 4 ) {
+        assem.TranslateToCpp( argv[3] );
+        return 0;
+    }
+
+    // With -profile, display what each statement did during the run.
+    if( argc == 3 && string( argv[2] ) == "-profile" ) {
+        assem.ProfileProgramInEmulator();
+        return 0;
+    }
+
+    // With -limits, stop the run after a number of instructions, milliseconds or pages written.
+    if( argc == 6 && string( argv[2] ) == "-limits" ) {
+        Emulator::RunLimits limits;
+        limits.m_maxInstructions = atoll( argv[3] );
+        limits.m_maxMilliseconds = atoll( argv[4] );
+        limits.m_maxPages = atoi( argv[5] );
+        assem.SetRunLimits( limits );
+    }
+
     // Run the emulator on the translation of the assembler language program that was generated in Pass II.
     assem.RunProgramInEmulator();
 
@@ -5,6 +5,8 @@
 #include "Assembler.h"
 #include "Errors.h"
 #include "SymTab.h"
+#include "CppTranslator.h"
+#include "MultiCoreEmulator.h"
 
 /*
 NAME:
@@ -40,11 +42,47 @@ DATE:
 //  access constructor.
 // See main program.  
 Assembler::Assembler( int argc, char *argv[] )
-: m_facc( argc, argv )
+: m_facc( argc, argv ),
+  m_emul( make_shared<ConsoleInput>(), make_shared<BufferedOutput>( cout ) )
 {
     // Nothing else to do here at this point.
 }  
 
+/*
+NAME:
+
+    Assembler();
+
+SYNOPSIS:
+
+    Assembler::Assembler( const string& a_fileName );
+    a_fileName  --> the name of the source file
+
+DESCRIPTION:
+
+    Opens a source file named other than on the command line. Batch mode creates one
+    assembler for each program in its manifest.
+
+RETURNS:
+
+    constructor class so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+Assembler::Assembler( const string& a_fileName )
+: m_facc( a_fileName ),
+  m_emul( make_shared<ConsoleInput>(), make_shared<BufferedOutput>( cout ) )
+{
+}
+
 
 
 /*
@@ -139,6 +177,8 @@ DESCRIPTION:
     Initially, the function rewinds to the beginning of the file. It creates a location variable and sets it to
     0. Inside a while loop, if there is not a next line, an error is returned, as the last line should be of type 
     'END'. Instruction object is called, which parses the line into its fileds. 
+    Each statement is kept with the locations it occupies, so that a profile of the run can be
+    displayed beside it.
 
 RETURN:
 
@@ -163,6 +203,7 @@ void Assembler::PassII()
     // Initialize for error reporting
     Errors::InitErrorReporting();
     string content;
+    m_listing.clear();
 
     //print title
     std::cout << std::setw(70) << std::setfill('-') << "" << std::endl;
@@ -187,11 +228,13 @@ void Assembler::PassII()
             return;
         }
         Instruction::InstructionType st = m_inst.ParseInstruction(line);
+        int start = loc;
 
             switch (st)
             {
             case Instruction::InstructionType::ST_End: {
                 cout << "\t\t\t" << m_inst.GetInstruction() << endl;
+                m_listing.push_back({ -1, -1, false, m_inst.GetInstruction() });
                 bool foundNonEmpty = false;
                 if (m_facc.GetNextLine(line))
                 {
@@ -249,6 +292,17 @@ void Assembler::PassII()
                     MachineInstruction(content, loc);
                 }
             }
+
+        // remember the words the statement occupies, for the profile; ORG occupies none
+        if (loc > start && m_inst.GetOpCode() != "ORG" && st != Instruction::InstructionType::ST_Comment) {
+            const string& OpCode = m_inst.GetOpCode();
+            bool isBranch = st == Instruction::InstructionType::ST_MachineLanguage &&
+                (OpCode == "B" || OpCode == "BM" || OpCode == "BZ" || OpCode == "BP");
+            m_listing.push_back({ start, loc, isBranch, m_inst.GetInstruction() });
+        }
+        else {
+            m_listing.push_back({ -1, -1, false, m_inst.GetInstruction() });
+        }
     }
 
 }
@@ -848,6 +902,8 @@ DESCRIPTION:
     This function processes machine instructions by formatting the opcode,
     checking for errors in operands and labels, handling numeric and symbolic operands,
     and inserting the content into memory. It updates the location counter accordingly.
+    The location of the first machine instruction is recorded as the entry point of the
+    program, where the emulator starts executing.
 
 RETURN:
 
@@ -880,6 +936,12 @@ void Assembler::ProcessMachineInstruction(string& a_content, int& a_loc) {
         HandleNumericOperand1(a_content, location, locate, OpCode);
     }
 
+    // The program starts at its first machine instruction
+    if (!m_isEntryPointSet) {
+        m_emul.setEntryPoint(a_loc);
+        m_isEntryPointSet = true;
+    }
+
     // Inserting into memory and calculating location of next instruction
     m_emul.insertMemory(a_loc, stoll(a_content));
     cout << a_loc << "\t\t" << a_content << "\t\t" << m_inst.GetInstruction() << endl;
@@ -926,17 +988,23 @@ void Assembler::MachineInstruction(string& a_content, int& a_loc) {
 /*
 NAME:
 
-    RunProgramInEmulator() - Runs the program in the emulator
+    RunProgramInEmulator(), EmulateProgram() - Runs the program in the emulator
 
 SYNOPSIS:
 
     Assembler::RunProgramInEmulator();
+    Assembler::EmulateProgram();
 
 DESCRIPTION:
 
     This function runs the assembled program in the emulator, displaying the results.
     It first checks if there are no errors reported, then runs the emulator. If there are errors,
-    it outputs a message indicating that the emulator cannot run due to errors.
+    it outputs a message indicating that the emulator cannot run due to errors. A run stopped
+    by one of the limits set with SetRunLimits() is reported as an error here; the emulator
+    reports the errors in the program itself, which are not displayed again. The run's errors
+    are cleared once displayed. The run is measured when MeasurePhases() has
+    given it performance counters. EmulateProgram() makes the run itself, without waiting
+    for the user, so that a replay can run with no console.
 
 RETURN:
 
@@ -956,12 +1024,44 @@ void Assembler::RunProgramInEmulator() {
     std::cout << std::setw(70) << std::setfill('-') << "" << std::endl;
     cout << "Press Enter to continue..." << endl;
     cin.ignore();
+    EmulateProgram();
+}
+
+void Assembler::EmulateProgram() {
     cout << "Results from Emulating Program:" << endl;
 
     //run only when there are no errors
     /**/
     if (Errors::NoError()) {
+        if (m_counters != nullptr) {
+            m_counters->start();
+        }
         m_emul.runProgram();
+        if (m_counters != nullptr) {
+            m_runReading = m_counters->stop();
+        }
+        // an error that stopped the program was displayed as the emulator reported it, so
+        // only a limit is displayed here; the run's errors are then cleared, so that nothing
+        // displayed after the run repeats them
+        string limit;
+        switch (m_emul.getTermination()) {
+        case Emulator::Termination::InstructionLimit:
+            limit = "Error! Instruction limit reached";
+            break;
+        case Emulator::Termination::TimeLimit:
+            limit = "Error! Time limit reached";
+            break;
+        case Emulator::Termination::MemoryLimit:
+            limit = "Error! Memory limit reached";
+            break;
+        default:
+            break;
+        }
+        if (!limit.empty()) {
+            Errors::RecordError(limit);
+            Errors::DisplayErrors();
+        }
+        Errors::InitErrorReporting();
     }
     else {
         cout << "Emulator cannot run because of Errors!" << endl;
@@ -970,3 +1070,739 @@ void Assembler::RunProgramInEmulator() {
     cout << "End of Emulation" << endl;
     std::cout << std::setw(70) << std::setfill('-') << "" << std::endl;
 }
+
+
+/*
+NAME:
+
+    ProfileProgramInEmulator() - Runs the program in the emulator and displays its profile
+
+SYNOPSIS:
+
+    Assembler::ProfileProgramInEmulator();
+
+DESCRIPTION:
+
+    The program is run as RunProgramInEmulator() runs it, but with a profile that counts each
+    instruction executed, each branch taken and each read and write of memory. The run goes
+    through the emulator's debugging engine, so the other engines pay nothing for profiling.
+    Afterwards the listing of Pass II is displayed again with the counts beside each statement,
+    followed by the labels and loops that executed the most instructions.
+
+RETURN:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void Assembler::ProfileProgramInEmulator() {
+    ExecutionProfile profile(Emulator::MEMSZ);
+    m_emul.setProfile(&profile);
+    RunProgramInEmulator();
+    m_emul.setProfile(nullptr);
+
+    if (profile.getTotal() > 0) {
+        cout << setfill(' ');
+        DisplayProfile(profile);
+        DisplayHottestLabels(profile);
+        DisplayHottestLoops(profile);
+        cout << setw(70) << setfill('-') << "" << setfill(' ') << endl;
+    }
+}
+
+/*
+NAME:
+
+    DisplayProfile() - Displays the listing with the counts of the run beside each statement
+
+SYNOPSIS:
+
+    Assembler::DisplayProfile(const ExecutionProfile& a_profile);
+    a_profile   --> the counts of the run
+
+DESCRIPTION:
+
+    Each statement that occupies memory shows how many instructions were executed in its words
+    and their share of all the instructions executed. A branch also shows how often it was
+    taken and not taken, and a statement whose words were read or written by instructions
+    shows how often.
+
+RETURN:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void Assembler::DisplayProfile(const ExecutionProfile& a_profile) {
+    long long total = a_profile.getTotal();
+    cout << "Profile of the run: " << total << " instructions executed" << endl;
+    cout << endl;
+    cout << "Location\tHits\t  Share\tBranches and Memory\t\tOriginal Statement" << endl;
+
+    for (const ListingLine& line : m_listing) {
+        if (line.m_start < 0) {
+            cout << "\t\t\t\t\t\t\t" << line.m_statement << endl;
+            continue;
+        }
+        long long hits = 0, taken = 0, reads = 0, writes = 0;
+        for (int loc = line.m_start; loc < line.m_end; loc++) {
+            hits += a_profile.getExecutions(loc);
+            taken += a_profile.getTaken(loc);
+            reads += a_profile.getReads(loc);
+            writes += a_profile.getWrites(loc);
+        }
+
+        ostringstream share, detail;
+        share << fixed << setprecision(1) << setw(6) << 100.0 * hits / total << "%";
+        if (line.m_isBranch && hits > 0) {
+            detail << "taken " << taken << ", not " << hits - taken;
+        }
+        if (reads > 0 || writes > 0) {
+            detail << "read " << reads << ", written " << writes;
+        }
+        cout << line.m_start << "\t\t" << hits << "\t" << share.str() << "\t" << left << setw(24)
+            << detail.str() << right << line.m_statement << endl;
+    }
+    cout << endl;
+}
+
+/*
+NAME:
+
+    DisplayHottestLabels() - Displays the labels whose code executed the most instructions
+
+SYNOPSIS:
+
+    Assembler::DisplayHottestLabels(const ExecutionProfile& a_profile);
+    a_profile   --> the counts of the run
+
+DESCRIPTION:
+
+    The code of a label runs from its location up to the location of the next label. The
+    labels are taken from the symbol table, and the five with the most instructions executed
+    are displayed.
+
+RETURN:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void Assembler::DisplayHottestLabels(const ExecutionProfile& a_profile) {
+    const size_t shown = 5;
+
+    // the labels in the order of their locations
+    vector<pair<int, string>> labels;
+    for (const auto& symbol : m_symtab.GetSymbols()) {
+        if (symbol.second != m_symtab.multipleDefinedSymbol) {
+            labels.push_back(make_pair(symbol.second, symbol.first));
+        }
+    }
+    sort(labels.begin(), labels.end());
+
+    vector<pair<long long, string>> hits;
+    for (size_t i = 0; i < labels.size(); i++) {
+        int end = (i + 1 < labels.size()) ? labels[i + 1].first : a_profile.size();
+        long long count = 0;
+        for (int loc = labels[i].first; loc < end; loc++) {
+            count += a_profile.getExecutions(loc);
+        }
+        if (count > 0) {
+            hits.push_back(make_pair(count, labels[i].second));
+        }
+    }
+    sort(hits.begin(), hits.end(), greater<pair<long long, string>>());
+
+    cout << "Hottest labels:" << endl;
+    for (size_t i = 0; i < hits.size() && i < shown; i++) {
+        cout << "\t" << left << setw(16) << hits[i].second << right << hits[i].first << " instructions, "
+            << fixed << setprecision(1) << 100.0 * hits[i].first / a_profile.getTotal() << "%" << endl;
+        cout.unsetf(ios::fixed);
+    }
+    cout << endl;
+}
+
+/*
+NAME:
+
+    DisplayHottestLoops() - Displays the loops that executed the most instructions
+
+SYNOPSIS:
+
+    Assembler::DisplayHottestLoops(const ExecutionProfile& a_profile);
+    a_profile   --> the counts of the run
+
+DESCRIPTION:
+
+    A loop is a branch that was taken back to its own location or an earlier one. Its body
+    runs from the branch's target to the branch, and each time the branch was taken is an
+    iteration. The five loops whose bodies executed the most instructions are displayed,
+    named by the label at their targets.
+
+RETURN:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void Assembler::DisplayHottestLoops(const ExecutionProfile& a_profile) {
+    const size_t shown = 5;
+
+    // a loop's instructions executed, and its branch location and target
+    vector<pair<long long, pair<int, int>>> loops;
+    for (const ListingLine& line : m_listing) {
+        if (!line.m_isBranch || a_profile.getTaken(line.m_start) == 0) {
+            continue;
+        }
+        int target = static_cast<int>(m_emul.getMemory(line.m_start) % 1'000'000);
+        if (target > line.m_start) {
+            continue;
+        }
+        long long count = 0;
+        for (int loc = target; loc <= line.m_start; loc++) {
+            count += a_profile.getExecutions(loc);
+        }
+        loops.push_back(make_pair(count, make_pair(line.m_start, target)));
+    }
+    sort(loops.begin(), loops.end(), greater<pair<long long, pair<int, int>>>());
+
+    cout << "Hottest loops:" << endl;
+    for (size_t i = 0; i < loops.size() && i < shown; i++) {
+        int branch = loops[i].second.first;
+        int target = loops[i].second.second;
+        string name = "location " + to_string(target);
+        for (const auto& symbol : m_symtab.GetSymbols()) {
+            if (symbol.second == target) {
+                name = symbol.first;
+            }
+        }
+        cout << "\t" << left << setw(16) << name << right << target << " - " << branch << ": "
+            << a_profile.getTaken(branch) << " iterations, " << loops[i].first << " instructions, "
+            << fixed << setprecision(1) << 100.0 * loops[i].first / a_profile.getTotal() << "%" << endl;
+        cout.unsetf(ios::fixed);
+    }
+    cout << endl;
+}
+
+/*
+NAME:
+
+    RecordProgramInEmulator() - Runs the program in the emulator, recording a trace of the run
+
+SYNOPSIS:
+
+    Assembler::RecordProgramInEmulator(const string& a_fileName, bool a_hasInstructions);
+    a_fileName  --> the name of the trace file
+    a_hasInstructions --> true to record every instruction, false to record only the numbers read
+
+DESCRIPTION:
+
+    The program is run as RunProgramInEmulator() runs it, with every number it reads, and
+    if asked every instruction it executes, written to the trace as it goes. What the trace
+    cost is displayed afterwards: its size, its bytes per instruction and the time the run
+    took, which is the overhead of recording when compared with a run that is not recorded.
+
+RETURN:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void Assembler::RecordProgramInEmulator(const string& a_fileName, bool a_hasInstructions) {
+    TraceWriter trace(a_fileName, a_hasInstructions);
+    if (!trace.isOpen()) {
+        Errors::RecordError("Error! Trace file " + a_fileName + " could not be created");
+        Errors::DisplayErrors();
+        return;
+    }
+    m_emul.recordTrace(trace);
+
+    // the counters time the run alone, leaving out waiting for the user to press Enter
+    PerfCounters counters;
+    m_runReading = PerfCounters::Reading();
+    m_counters = &counters;
+    RunProgramInEmulator();
+    m_counters = nullptr;
+    trace.flush();
+    if (!trace.isOpen()) {
+        Errors::RecordError("Error! Trace file " + a_fileName + " could not be written");
+        Errors::DisplayErrors();
+        return;
+    }
+
+    long long instructions = a_hasInstructions ? trace.getInstructions() : m_emul.getInstructionsExecuted();
+    cout << "Recorded " << trace.getInputs() << " numbers read";
+    if (a_hasInstructions) {
+        cout << " and " << trace.getInstructions() << " instructions";
+    }
+    cout << " in " << trace.getBytes() << " bytes" << endl;
+    if (instructions > 0) {
+        cout << fixed << setprecision(3) << static_cast<double>(trace.getBytes()) / instructions
+            << " bytes per instruction, " << m_runReading.m_seconds * 1e9 / instructions
+            << " nanoseconds per instruction" << endl;
+        cout.unsetf(ios::fixed);
+    }
+    cout << setw(70) << setfill('-') << "" << setfill(' ') << endl;
+}
+
+/*
+NAME:
+
+    VerifyProgram() - Verifies that the translation never stores into its own code
+
+SYNOPSIS:
+
+    Assembler::VerifyProgram();
+
+DESCRIPTION:
+
+    The emulator follows every path from the entry point through the translation. A
+    translation that is verified runs on the engines that do not check its stores; one that
+    is not runs on the checked engines, and the word that kept it from being verified is
+    displayed with the statement that generated it.
+
+RETURN:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void Assembler::VerifyProgram() {
+    ProgramVerifier verifier = m_emul.verifyProgram();
+
+    cout << endl << setfill(' ');
+    if (verifier.isVerified()) {
+        cout << "Verified: the code is " << verifier.getCodeWords() << " words, and the program stores into "
+            << verifier.getStoreTargets().size() << " others; stores are not checked" << endl;
+        return;
+    }
+    cout << "Not verified: " << verifier.getFailure() << "; stores are checked" << endl;
+    int location = verifier.getFailureLocation();
+    for (const ListingLine& line : m_listing) {
+        if (location >= 0 && location >= line.m_start && location < line.m_end) {
+            cout << "	" << location << "	" << line.m_statement << endl;
+        }
+    }
+}
+
+/*
+NAME:
+
+    EstimateCost() - Estimates the instructions the translation executes, without running it
+
+SYNOPSIS:
+
+    Assembler::EstimateCost();
+
+DESCRIPTION:
+
+    The estimate from the entry point is displayed first, then one for each label control
+    reaches from it, as if the run started at the label with memory as loaded. A label of
+    data is not displayed. The most instructions are "unbounded" when a loop's trip count
+    could not be found from its constants, as when it counts numbers read. Nothing is known
+    of a run that may store into its own code.
+
+RETURN:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void Assembler::EstimateCost() {
+    CostEstimator estimator = m_emul.estimateCost();
+    vector<pair<string, int>> starts(1, { "(entry)", m_emul.getEntryPoint() });
+    CostEstimator::Cost entry = estimator.estimate(m_emul.getEntryPoint());
+    for (const auto& symbol : m_symtab.GetSymbols()) {
+        if (estimator.isCode(symbol.second) && m_emul.getMemory(symbol.second) != 0) {
+            starts.push_back(symbol);
+        }
+    }
+
+    cout << endl << "Estimated instructions to HALT:" << endl;
+    cout << setw(50) << setfill('-') << "" << endl << setfill(' ');
+    cout << "Label\t\tLocation\tFewest\t\tMost" << endl;
+    for (const pair<string, int>& start : starts) {
+        CostEstimator::Cost cost = start.first == "(entry)" ? entry : estimator.estimate(start.second);
+        cout << start.first << "\t\t" << start.second << "\t\t";
+        if (cost.m_isUnknown) {
+            cout << "unknown, it may write its code" << endl;
+            continue;
+        }
+        if (cost.m_best == CostEstimator::UNBOUNDED) {
+            cout << "never halts" << endl;
+            continue;
+        }
+        cout << cost.m_best << "\t\t";
+        if (cost.isUnbounded()) {
+            cout << "unbounded" << endl;
+        }
+        else {
+            cout << cost.m_worst << endl;
+        }
+    }
+    cout << setw(70) << setfill('-') << "" << endl << setfill(' ');
+}
+
+/*
+NAME:
+
+    ReplayProgramInEmulator() - Runs the program in the emulator, replaying a recorded run
+
+SYNOPSIS:
+
+    Assembler::ReplayProgramInEmulator(const string& a_fileName);
+    a_fileName  --> the name of the trace file
+
+DESCRIPTION:
+
+    The program reads the numbers recorded in the trace rather than the console, and the
+    user is not asked to press Enter, so a replay needs no console at all. If the trace has
+    instructions, each instruction of the replay is checked against it, and a replay that
+    differs, because the program or the assembler changed since the recording, is reported
+    as an error at the first instruction that differed.
+
+RETURN:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void Assembler::ReplayProgramInEmulator(const string& a_fileName) {
+    TraceReader trace(a_fileName);
+    if (!trace.isOpen()) {
+        Errors::RecordError("Error! Trace file " + a_fileName + " could not be read");
+        Errors::DisplayErrors();
+        return;
+    }
+    m_emul.replayTrace(trace);
+
+    std::cout << std::setw(70) << std::setfill('-') << "" << std::endl;
+    EmulateProgram();
+    if (!trace.hasInstructions()) {
+        return;
+    }
+    if (!trace.hasDiverged()) {
+        cout << "Replay matched the " << trace.getMatched() << " instructions recorded" << endl;
+    }
+    else if (trace.getDivergence() < 0) {
+        Errors::RecordError("Error! Replay ran past the end of the trace after " + to_string(trace.getMatched()) +
+            " instructions");
+    }
+    else {
+        Errors::RecordError("Error! Replay differed from the trace at location " + to_string(trace.getDivergence()) +
+            " after " + to_string(trace.getMatched()) + " instructions");
+    }
+    Errors::DisplayErrors();
+}
+
+/*
+NAME:
+
+    MeasurePhases() - Assembles and runs the program, measuring each phase
+
+SYNOPSIS:
+
+    Assembler::MeasurePhases();
+
+DESCRIPTION:
+
+    Pass I, Pass II and the emulator's run are each measured with the host's performance
+    counters, and what they cost is displayed after the run. Only the emulator's runProgram()
+    is measured of the run, so waiting for the user to press Enter is left out. Where the
+    counters are not available, the phases are only timed.
+
+RETURN:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void Assembler::MeasurePhases() {
+    PerfCounters counters;
+
+    counters.start();
+    PassI();
+    PerfCounters::Reading passI = counters.stop();
+    DisplaySymbolTable();
+
+    counters.start();
+    PassII();
+    PerfCounters::Reading passII = counters.stop();
+
+    m_runReading = PerfCounters::Reading();
+    m_counters = &counters;
+    RunProgramInEmulator();
+    m_counters = nullptr;
+
+    cout << setfill(' ');
+    if (counters.isAvailable()) {
+        cout << "Performance of the phases, from the host's performance counters:" << endl;
+    }
+    else {
+        cout << "Performance counters are not available, so the phases are only timed:" << endl;
+    }
+    DisplayPhase("PassI", passI, 0);
+    DisplayPhase("PassII", passII, 0);
+    DisplayPhase("runProgram", m_runReading, m_emul.getInstructionsExecuted());
+    cout << setw(70) << setfill('-') << "" << setfill(' ') << endl;
+}
+
+/*
+NAME:
+
+    DisplayPhase() - Displays what a phase cost
+
+SYNOPSIS:
+
+    Assembler::DisplayPhase(const string& a_phase, const PerfCounters::Reading& a_reading, long long a_emulated);
+    a_phase     --> the name of the phase
+    a_reading   --> what was measured of it
+    a_emulated  --> the instructions the emulator executed in it, or 0 if it ran none
+
+DESCRIPTION:
+
+    The time and each event counted are displayed, and then the host instructions per cycle.
+    A phase that ran the emulator also shows the host instructions and cycles it took for each
+    instruction emulated, which is the cost of dispatching and executing one instruction.
+
+RETURN:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void Assembler::DisplayPhase(const string& a_phase, const PerfCounters::Reading& a_reading, long long a_emulated) {
+    const long long* counts = a_reading.m_counts;
+    const bool* isCounted = a_reading.m_isCounted;
+
+    cout << endl << a_phase << ": " << fixed << setprecision(6) << a_reading.m_seconds << " seconds" << endl;
+    for (int event = 0; event < PerfCounters::EVENT_COUNT; event++) {
+        cout << "\t" << left << setw(36) << PerfCounters::getName(static_cast<PerfCounters::Event>(event)) << right;
+        if (isCounted[event]) {
+            cout << counts[event] << endl;
+        }
+        else {
+            cout << "not counted" << endl;
+        }
+    }
+
+    cout << setprecision(2);
+    if (isCounted[PerfCounters::Cycles] && isCounted[PerfCounters::Instructions] && counts[PerfCounters::Cycles] > 0) {
+        cout << "\t" << left << setw(36) << "Instructions per cycle" << right
+            << static_cast<double>(counts[PerfCounters::Instructions]) / counts[PerfCounters::Cycles] << endl;
+    }
+    if (a_emulated > 0) {
+        cout << "\t" << left << setw(36) << "Emulated instructions" << right << a_emulated << endl;
+        if (isCounted[PerfCounters::Instructions]) {
+            cout << "\t" << left << setw(36) << "Host instructions per emulated" << right
+                << static_cast<double>(counts[PerfCounters::Instructions]) / a_emulated << endl;
+        }
+        if (isCounted[PerfCounters::Cycles]) {
+            cout << "\t" << left << setw(36) << "Cycles per emulated" << right
+                << static_cast<double>(counts[PerfCounters::Cycles]) / a_emulated << endl;
+        }
+        if (isCounted[PerfCounters::BranchMisses]) {
+            cout << "\t" << left << setw(36) << "Branch misses per emulated" << right
+                << static_cast<double>(counts[PerfCounters::BranchMisses]) / a_emulated << endl;
+        }
+        cout << "\t" << left << setw(36) << "Nanoseconds per emulated" << right
+            << a_reading.m_seconds * 1e9 / a_emulated << endl;
+    }
+    cout.unsetf(ios::fixed);
+    cout << setprecision(6);
+}
+
+/*
+NAME:
+
+    RunProgramOnCores() - Runs the program on several cores sharing one memory
+
+SYNOPSIS:
+
+    Assembler::RunProgramOnCores(const vector<string>& a_labels);
+    a_labels    --> the label each core starts at, one per core
+
+DESCRIPTION:
+
+    Each label is looked up in the symbol table and a core is started there, each on a
+    thread of its own, all sharing the memory of the translation. The cores' output is
+    buffered until one of them reads or they all stop. Nothing is run if there were errors
+    or a label is not defined.
+
+RETURN:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void Assembler::RunProgramOnCores(const vector<string>& a_labels) {
+    std::cout << std::setw(70) << std::setfill('-') << "" << std::endl;
+    for (const string& label : a_labels) {
+        int loc;
+        if (!m_symtab.LookupSymbol(label, loc) || loc == m_symtab.multipleDefinedSymbol) {
+            Errors::RecordError("Error! Core start label " + label + " is not defined once");
+        }
+    }
+    if (!Errors::NoError()) {
+        Errors::DisplayErrors();
+        cout << "Emulator cannot run because of Errors!" << endl;
+        return;
+    }
+
+    MultiCoreEmulator cores(m_emul.takeSnapshot());
+    cores.setDevices(make_shared<ConsoleInput>(), make_shared<BufferedOutput>(cout));
+    for (const string& label : a_labels) {
+        int loc = 0;
+        m_symtab.LookupSymbol(label, loc);
+        cores.addCore(loc);
+    }
+    cout << "Results from Emulating Program on " << a_labels.size() << " cores:" << endl;
+    cores.runProgram();
+    cout << endl;
+    cout << "End of Emulation" << endl;
+    std::cout << std::setw(70) << std::setfill('-') << "" << std::endl;
+}
+
+
+/*
+NAME:
+
+    TranslateToCpp() - Writes the translation as a C++ program
+
+SYNOPSIS:
+
+    Assembler::TranslateToCpp(const string& a_fileName);
+    a_fileName  --> the name of the C++ source file to be written
+
+DESCRIPTION:
+
+    This function writes the machine language translation from Pass II as a standalone C++
+    program, so that it can be compiled once and run at native speed instead of being
+    emulated. The labels of the program come from the symbol table. Programs that write into
+    their own code are translated into an interpreter of their memory image instead.
+    Nothing is written if there were errors.
+
+RETURN:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void Assembler::TranslateToCpp(const string& a_fileName) {
+    std::cout << std::setw(70) << std::setfill('-') << "" << std::endl;
+    if (!Errors::NoError()) {
+        cout << "The program cannot be translated because of Errors!" << endl;
+        return;
+    }
+
+    ofstream out(a_fileName);
+    if (!out) {
+        cerr << "Could not open " << a_fileName << " for the C++ translation." << endl;
+        return;
+    }
+    CppTranslator translator(m_emul, m_symtab);
+    if (translator.TranslateProgram(out)) {
+        cout << "C++ translation written to " << a_fileName << endl;
+    }
+    else {
+        cout << "The program writes into its own code, so the C++ translation written to "
+             << a_fileName << " interprets it." << endl;
+    }
+    std::cout << std::setw(70) << std::setfill('-') << "" << std::endl;
+}
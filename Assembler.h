@@ -8,12 +8,18 @@
 #include "Instruction.h"
 #include "FileAccess.h"
 #include "Emulator.h"
+#include "ExecutionProfile.h"
+#include "PerfCounters.h"
+#include "ExecutionTrace.h"
 
 
 class Assembler {
 
 public:
     Assembler( int argc, char *argv[] );
+
+    // Assembles a named source file, as the batch runner does for each program.
+    explicit Assembler( const string& a_fileName );
    // ~Assembler( );
 
     // Pass I - establish the locations of the symbols
@@ -34,12 +40,60 @@ public:
     // Run emulator on the translation.
     void RunProgramInEmulator(); //{ cout << "Must implementL RunProgramInEmulator( )" << endl; }
 
+    // Verify that the translation never stores into its own code, and display the verdict,
+    // which decides whether the emulator checks its stores.
+    void VerifyProgram();
+
+    // Estimate the fewest and most instructions the translation executes from its entry point
+    // and from each label of its code, without running it, and display them.
+    void EstimateCost();
+
+    // Run emulator on the translation, counting what each instruction does, and display the
+    // counts beside the listing.
+    void ProfileProgramInEmulator();
+
+    // Run emulator on the translation, recording the numbers it reads, and if a_hasInstructions
+    // every instruction, in a trace file.
+    void RecordProgramInEmulator(const string& a_fileName, bool a_hasInstructions);
+
+    // Run emulator on the translation with the numbers recorded in a trace file, checking its
+    // instructions against the trace if it has them.
+    void ReplayProgramInEmulator(const string& a_fileName);
+
+    // Assemble and run the translation, measuring Pass I, Pass II and the run with the host's
+    // performance counters, and display what each of them cost.
+    void MeasurePhases();
+
+    // Limit the instructions, time and memory the emulator's run may take.
+    void SetRunLimits(const Emulator::RunLimits& a_limits) { m_emul.setLimits(a_limits); }
+
+    // Run the translation on several cores sharing its memory, one starting at each label.
+    void RunProgramOnCores(const vector<string>& a_labels);
+
+    // Write the translation as a C++ program to a file.
+    void TranslateToCpp(const string& a_fileName);
+
+    // Returns the translation loaded in the emulator, for the batch runner to run many times.
+    Emulator::Snapshot TakeProgramImage() { return m_emul.takeSnapshot(); }
+
 private:
 
+    // A statement of the listing made in Pass II and the words of memory it occupies.
+    struct ListingLine {
+        int m_start;            // First location it occupies, or -1 if it occupies none.
+        int m_end;              // One past the last location it occupies.
+        bool m_isBranch;        // == true if it is a B, BM, BZ or BP instruction.
+        string m_statement;     // The original statement.
+    };
+
     FileAccess m_facc;	    // File Access object
     SymbolTable m_symtab;   // Symbol table object
     Instruction m_inst;	    // Instruction object
-    Emulator m_emul;        // Emulator object
+    Emulator m_emul;        // Emulator object, its output buffered until it reads or stops
+    bool m_isEntryPointSet = false;     // Set once the first machine instruction is recorded
+    vector<ListingLine> m_listing;      // The statements translated in Pass II, in order
+    PerfCounters* m_counters = nullptr; // Measures the emulator's run, if set
+    PerfCounters::Reading m_runReading; // What m_counters measured of the last run
     
     void CheckOperandsAndLabels();
     void HandleORGOperation(int& a_loc);
@@ -55,6 +109,12 @@ private:
     void HandleNumericOperand1(string& a_content, int& location, string& locate, const string& OpCode);
     void HandleSymbolicOperand1(string& a_content, int& location, string& locate, const string& OpCode);
     void ProcessMachineInstruction(string& a_content, int& a_loc);
+
+    void EmulateProgram();
+    void DisplayProfile(const ExecutionProfile& a_profile);
+    void DisplayHottestLabels(const ExecutionProfile& a_profile);
+    void DisplayHottestLoops(const ExecutionProfile& a_profile);
+    void DisplayPhase(const string& a_phase, const PerfCounters::Reading& a_reading, long long a_emulated);
     
 };
 
@@ -0,0 +1,405 @@
+//
+//		Implementation of the BatchRunner class.
+//
+#include "stdafx.h"
+#include "BatchRunner.h"
+#include "Errors.h"
+
+/*
+NAME:
+
+    addProgram() - adds a program image
+
+SYNOPSIS:
+
+    int BatchRunner::addProgram(const Emulator::Snapshot& a_image);
+    a_image     --> a snapshot of an emulator with the program loaded and not yet run
+
+DESCRIPTION:
+
+    The snapshot shares its pages with the emulator it was taken from, so adding it copies
+    none of the program's memory.
+
+RETURNS:
+
+    int - the number identifying the program in addRun()
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+int BatchRunner::addProgram(const Emulator::Snapshot& a_image)
+{
+    m_programs.push_back(a_image);
+    return static_cast<int>(m_programs.size()) - 1;
+}
+
+/*
+NAME:
+
+    addRun() - adds a run of a program on an input
+
+SYNOPSIS:
+
+    int BatchRunner::addRun(int a_program, const string& a_input);
+    a_program   --> the program, as returned by addProgram()
+    a_input     --> the text the program's READs take their input from
+
+RETURNS:
+
+    int - the number identifying the run in getRun()
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+int BatchRunner::addRun(int a_program, const string& a_input)
+{
+    Run run;
+    run.m_program = a_program;
+    run.m_input = a_input;
+    m_runs.push_back(run);
+    return static_cast<int>(m_runs.size()) - 1;
+}
+
+/*
+NAME:
+
+    setEngine() - selects the engine every run uses
+
+SYNOPSIS:
+
+    bool BatchRunner::setEngine(Emulator::Engine a_engine);
+    a_engine    --> the engine
+
+RETURNS:
+
+    bool - returns true if the engine is available in this build, false otherwise, in which
+    case the current engine is left unchanged
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+bool BatchRunner::setEngine(Emulator::Engine a_engine)
+{
+    if (!Emulator::isEngineAvailable(a_engine)) {
+        return false;
+    }
+    m_engine = a_engine;
+    return true;
+}
+
+/*
+NAME:
+
+    runAll() - executes every run not yet complete
+
+SYNOPSIS:
+
+    void BatchRunner::runAll(int a_threads);
+    a_threads   --> the number of threads, or 0 for one per processor
+
+DESCRIPTION:
+
+    The runs are divided into one block of consecutive runs per thread. Runs added together
+    are usually of the same program, so a thread mostly restores the image it restored last,
+    which only resets the pages the previous run wrote. The calling thread waits until every
+    thread has run out of work.
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void BatchRunner::runAll(int a_threads)
+{
+    int threads = a_threads > 0 ? a_threads : static_cast<int>(thread::hardware_concurrency());
+    if (threads <= 0) {
+        threads = 1;
+    }
+
+    vector<int> waiting;
+    for (int run = 0; run < getRunCount(); run++) {
+        if (!m_runs[run].m_isComplete) {
+            waiting.push_back(run);
+        }
+    }
+    if (waiting.empty()) {
+        return;
+    }
+    if (threads > static_cast<int>(waiting.size())) {
+        threads = static_cast<int>(waiting.size());
+    }
+
+    m_queues.clear();
+    for (int worker = 0; worker < threads; worker++) {
+        m_queues.emplace_back(new WorkQueue);
+        size_t first = waiting.size() * worker / threads;
+        size_t last = waiting.size() * (worker + 1) / threads;
+        m_queues.back()->m_runs.assign(waiting.begin() + first, waiting.begin() + last);
+    }
+
+    // The calling thread is the first worker.
+    vector<thread> workers;
+    for (int worker = 1; worker < threads; worker++) {
+        workers.emplace_back(&BatchRunner::work, this, worker);
+    }
+    work(0);
+    for (thread& worker : workers) {
+        worker.join();
+    }
+    m_queues.clear();
+}
+
+/*
+NAME:
+
+    work() - executes runs until there are none left
+
+SYNOPSIS:
+
+    void BatchRunner::work(int a_worker);
+    a_worker    --> the thread's queue of runs
+
+DESCRIPTION:
+
+    The thread has one emulator for all its runs. It is created from the image of the first
+    run, and every run after restores its own image into it. In lockstep mode the thread
+    instead keeps a lockstep emulator for the program it last ran, and creates a new one
+    when it moves on to another program. With telemetry, the thread's emulator publishes its
+    counters under the thread's number for as long as the thread works.
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void BatchRunner::work(int a_worker)
+{
+    unique_ptr<Emulator> emulator;
+    unique_ptr<LockstepEmulator> lanes;
+    int lanesProgram = -1;
+    vector<int> runs;
+    while (takeRuns(a_worker, m_isLockstep ? LockstepEmulator::LANES : 1, runs)) {
+        int program = m_runs[runs[0]].m_program;
+        if (m_isLockstep) {
+            if (program != lanesProgram) {
+                lanes.reset(new LockstepEmulator(m_programs[program]));
+                lanesProgram = program;
+            }
+            executeLockstep(*lanes, runs);
+            continue;
+        }
+        if (!emulator) {
+            emulator.reset(new Emulator(m_programs[program]));
+            emulator->setEngine(m_engine);
+            if (!m_telemetryName.empty() &&
+                !emulator->publishTelemetry(m_telemetryName + "." + to_string(a_worker))) {
+                cerr << "Telemetry segment " << m_telemetryName << "." << a_worker << " could not be created." << endl;
+            }
+        }
+        execute(*emulator, m_runs[runs[0]]);
+    }
+}
+
+/*
+NAME:
+
+    takeRuns() - takes the next runs for a thread
+
+SYNOPSIS:
+
+    bool BatchRunner::takeRuns(int a_worker, int a_most, vector<int>& a_runs);
+    a_worker    --> the thread's queue of runs
+    a_most      --> the most runs to take
+    a_runs      --> set to the runs taken
+
+DESCRIPTION:
+
+    The thread takes the first runs in its own queue. Once that is empty, it takes the last
+    runs in the queue of each other thread in turn, the runs that thread would reach last.
+    Only runs of the same program as the first one taken are taken with it.
+
+RETURNS:
+
+    bool - returns true if any runs were taken, false if there are none left
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+bool BatchRunner::takeRuns(int a_worker, int a_most, vector<int>& a_runs)
+{
+    a_runs.clear();
+    WorkQueue& own = *m_queues[a_worker];
+    {
+        lock_guard<mutex> lock(own.m_lock);
+        while (!own.m_runs.empty() && static_cast<int>(a_runs.size()) < a_most &&
+               (a_runs.empty() || m_runs[own.m_runs.front()].m_program == m_runs[a_runs[0]].m_program)) {
+            a_runs.push_back(own.m_runs.front());
+            own.m_runs.pop_front();
+        }
+        if (!a_runs.empty()) {
+            return true;
+        }
+    }
+    int queues = static_cast<int>(m_queues.size());
+    for (int offset = 1; offset < queues; offset++) {
+        WorkQueue& other = *m_queues[(a_worker + offset) % queues];
+        lock_guard<mutex> lock(other.m_lock);
+        while (!other.m_runs.empty() && static_cast<int>(a_runs.size()) < a_most &&
+               (a_runs.empty() || m_runs[other.m_runs.back()].m_program == m_runs[a_runs[0]].m_program)) {
+            a_runs.push_back(other.m_runs.back());
+            other.m_runs.pop_back();
+        }
+        if (!a_runs.empty()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+NAME:
+
+    execute() - executes one run
+
+SYNOPSIS:
+
+    void BatchRunner::execute(Emulator& a_emulator, Run& a_run);
+    a_emulator  --> the thread's emulator
+    a_run       --> the run
+
+DESCRIPTION:
+
+    Restores the run's image, then runs the program with its READs taking the run's input
+    and its WRITEs and errors captured in the run's output. The output is buffered, since
+    the emulator flushes it before every prompt and error.
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void BatchRunner::execute(Emulator& a_emulator, Run& a_run)
+{
+    istringstream input(a_run.m_input);
+    ostringstream output;
+
+    a_emulator.restoreSnapshot(m_programs[a_run.m_program]);
+    a_emulator.setDevices(make_shared<ConsoleInput>(input), make_shared<BufferedOutput>(output));
+    Errors::InitErrorReporting();
+    Errors::SetOutput(&output);
+
+    a_emulator.runProgram();
+
+    Errors::SetOutput(&cout);
+    a_emulator.setDevices(make_shared<ConsoleInput>(), make_shared<ConsoleOutput>());
+    a_run.m_output = output.str();
+    a_run.m_isComplete = true;
+}
+
+/*
+NAME:
+
+    executeLockstep() - executes runs of one program together
+
+SYNOPSIS:
+
+    void BatchRunner::executeLockstep(LockstepEmulator& a_emulator, const vector<int>& a_runs);
+    a_emulator  --> the thread's lockstep emulator, holding the runs' program
+    a_runs      --> the runs, at most one per lane
+
+DESCRIPTION:
+
+    Each run is given a lane, with its READs taking the run's input and its output
+    captured in the run's output.
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void BatchRunner::executeLockstep(LockstepEmulator& a_emulator, const vector<int>& a_runs)
+{
+    istringstream inputs[LockstepEmulator::LANES];
+    ostringstream outputs[LockstepEmulator::LANES];
+    int lanes = static_cast<int>(a_runs.size());
+
+    a_emulator.reset();
+    for (int lane = 0; lane < lanes; lane++) {
+        inputs[lane].str(m_runs[a_runs[lane]].m_input);
+        a_emulator.setInput(lane, &inputs[lane]);
+        a_emulator.setOutput(lane, &outputs[lane]);
+    }
+
+    a_emulator.runProgram(lanes);
+
+    for (int lane = 0; lane < lanes; lane++) {
+        a_emulator.setInput(lane, &cin);
+        a_emulator.setOutput(lane, &cout);
+        m_runs[a_runs[lane]].m_output = outputs[lane].str();
+        m_runs[a_runs[lane]].m_isComplete = true;
+    }
+}
@@ -0,0 +1,84 @@
+//
+//		BatchRunner class - runs many programs on many inputs across a pool of threads
+//
+#ifndef _BATCHRUNNER_H
+#define _BATCHRUNNER_H
+
+#include "Emulator.h"
+#include "LockstepEmulator.h"
+
+// Each program is loaded once and kept as a snapshot, its image, which no run changes.  A
+// run restores an image into its thread's emulator, so the run's writes go to pages of its
+// own and the image's pages are shared by every run of the program.  The runs are divided
+// among the threads in blocks, and a thread that finishes its block takes runs from the end
+// of another thread's block.  In lockstep mode a thread runs up to LockstepEmulator::LANES
+// consecutive runs of the same program at once, one per lane.
+class BatchRunner {
+
+public:
+
+    // A run of a program on one input.
+    struct Run {
+        int m_program = 0;          // The image the run starts from, as returned by addProgram().
+        string m_input;             // The text the program's READs take their input from.
+        string m_output;            // The text the run wrote, filled in by runAll().
+        bool m_isComplete = false;  // == true once the run has finished.
+    };
+
+    // Adds a program image.  Returns the number identifying it.
+    int addProgram(const Emulator::Snapshot& a_image);
+
+    // Adds a run of a program on an input.  Returns the number identifying the run.
+    int addRun(int a_program, const string& a_input);
+
+    // Selects the engine every run uses.  Returns false if it is not available in this build.
+    bool setEngine(Emulator::Engine a_engine);
+
+    // Runs the inputs of each program in lockstep, several at a time, rather than one by one.
+    void setLockstep(bool a_isLockstep) { m_isLockstep = a_isLockstep; }
+
+    // Publishes the counters of each thread's emulator in a shared memory segment, named
+    // a_name followed by a dot and the thread's number, or publishes nothing if a_name is
+    // empty.  Runs in lockstep are not published.
+    void setTelemetry(const string& a_name) { m_telemetryName = a_name; }
+
+    // Executes every run not yet complete on a number of threads, or one per processor if it
+    // is zero.  Returns once they have all finished.
+    void runAll(int a_threads);
+
+    // Returns the runs, in the order they were added.
+    int getRunCount() const { return static_cast<int>(m_runs.size()); }
+    const Run& getRun(int a_run) const { return m_runs[a_run]; }
+
+private:
+
+    // The runs still waiting for a thread.  The thread that owns the queue takes runs from
+    // the front, and other threads take them from the back.
+    struct WorkQueue {
+        mutex m_lock;
+        deque<int> m_runs;
+    };
+
+    // Executes runs until there are none left.
+    void work(int a_worker);
+
+    // Takes the next runs for a thread, from its own queue or another's: up to a_most runs
+    // of the same program that are next to each other in the queue.  Returns false if there
+    // are none left.
+    bool takeRuns(int a_worker, int a_most, vector<int>& a_runs);
+
+    // Executes one run in a thread's emulator.
+    void execute(Emulator& a_emulator, Run& a_run);
+
+    // Executes runs of one program together, one per lane of a thread's lockstep emulator.
+    void executeLockstep(LockstepEmulator& a_emulator, const vector<int>& a_runs);
+
+    vector<Emulator::Snapshot> m_programs;          // The image of each program.
+    vector<Run> m_runs;                             // Every run, in the order it was added.
+    vector<unique_ptr<WorkQueue>> m_queues;         // The runs waiting for each thread.
+    Emulator::Engine m_engine = VC8000_THREADED_DISPATCH ? Emulator::Engine::Threaded : Emulator::Engine::Switch;
+    bool m_isLockstep = false;                      // == true to run the inputs of a program in lockstep.
+    string m_telemetryName;                         // The name the threads' telemetry is published under.
+};
+
+#endif
@@ -0,0 +1,617 @@
+//
+//		Benchmarks of the emulator, run by the VC8000Bench program.
+//
+//      VC8000Bench <benchmark> [iterations]
+//
+//      dispatch    the loop of test2.txt, a summing loop and a loop of register instructions with
+//                  branches of every kind, each run for the iterations given (20,000,000 by
+//                  default) on each engine.
+//
+//      scan        a loop that falls through a gap of 900,000 words that were written and
+//                  cleared again, as many times as the iterations given (2,000 by default),
+//                  on each engine with each scanner of zero words the processor supports.
+//
+//      policies    the mixed loop of dispatch on the switch engine, as it runs normally and
+//                  with each of its debugging policies turned on but doing nothing visible.
+//
+//      trace       the mixed loop, reading its iterations (700,000 by default, fewer than
+//                  1,000,000), run without a trace, recorded with only the numbers read and
+//                  with every instruction, and replayed against the instruction trace.
+//
+//      words       loops of ADDs that each read a word of their own, from 1,000 to 300,000
+//                  words, for the instructions given (60,000,000 by default) on each engine.
+//                  Memory is read at the word size of the build, so running this benchmark in
+//                  the Release and the Release Compact builds compares 64-bit and compact words.
+//
+// Each run is timed alone, without making the emulator or loading its memory, and the best of
+// three runs is reported with the instructions executed, so that the figures of different
+// builds can be compared.  Build it with optimization; a debug build measures nothing useful.
+// The switch and threaded engines fast forward counted loops of straight-line code, as the
+// loops of test2 and sum are, so only mixed shows how fast they dispatch instructions.
+//
+#include "stdafx.h"
+#include "Emulator.h"
+#include "ExecutionTrace.h"
+#include "ZeroScanner.h"
+#include <chrono>
+#include <functional>
+
+namespace {
+
+const int RUNS = 3;                             // The runs timed, of which the best is reported.
+
+// A program image and the numbers its READs take.
+struct Program {
+    string m_name;                              // What the benchmark calls the program.
+    vector<pair<int, long long>> m_words;       // The location and contents of each word.
+    int m_entryPoint;                           // The location of the first instruction.
+    vector<int> m_input;                        // The numbers its READs take.
+};
+
+// The engines that are timed, and their names.
+const pair<Emulator::Engine, const char*> ENGINES[] = {
+    { Emulator::Engine::Switch, "switch" },
+    { Emulator::Engine::Threaded, "threaded" },
+    { Emulator::Engine::Jit, "jit" }
+};
+
+/*
+NAME:
+
+    word() - builds an instruction word
+
+SYNOPSIS:
+
+    long long word(int a_opCode, int a_reg1, int a_reg2, int a_address);
+    a_opCode    --> the operation code
+    a_reg1      --> the first register
+    a_reg2      --> the second register
+    a_address   --> the address
+
+RETURNS:
+
+    long long - returns the word the assembler would build for the instruction
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+long long word(int a_opCode, int a_reg1, int a_reg2, int a_address)
+{
+    return a_opCode * 10'000'000LL + a_reg1 * 1'000'000LL + a_reg2 * 100'000LL + a_address;
+}
+
+/*
+NAME:
+
+    timeRun() - runs a program once and times the run
+
+SYNOPSIS:
+
+    double timeRun(const Program& a_program, Emulator::Engine a_engine, long long& a_instructions, string& a_output,
+                   const function<void(Emulator&)>& a_configure = nullptr);
+    a_program       --> the program to run
+    a_engine        --> the engine to run it with
+    a_instructions  --> the instructions the run executed
+    a_output        --> what the program wrote
+    a_configure     --> if set, called with the emulator before the run
+
+RETURNS:
+
+    double - returns the seconds the run took
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+double timeRun(const Program& a_program, Emulator::Engine a_engine, long long& a_instructions, string& a_output,
+               const function<void(Emulator&)>& a_configure = nullptr)
+{
+    ostringstream output;
+    double seconds;
+    {
+        Emulator emulator(make_shared<VectorInput>(a_program.m_input), make_shared<BufferedOutput>(output));
+        emulator.setEngine(a_engine);
+        for (const auto& location : a_program.m_words) {
+            emulator.insertMemory(location.first, location.second);
+        }
+        emulator.setEntryPoint(a_program.m_entryPoint);
+        if (a_configure) {
+            a_configure(emulator);
+        }
+
+        auto start = chrono::steady_clock::now();
+        emulator.runProgram();
+        seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        a_instructions = emulator.getInstructionsExecuted();
+    }
+    a_output = output.str();
+    return seconds;
+}
+
+/*
+NAME:
+
+    timeEngines() - times a program on each engine and reports the best runs
+
+SYNOPSIS:
+
+    void timeEngines(const Program& a_program);
+    a_program   --> the program to time
+
+DESCRIPTION:
+
+    The engines take turns, so that anything else slowing the machine for a while slows
+    them alike. The line ends with "same output" if every run wrote the same words.
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void timeEngines(const Program& a_program)
+{
+    const size_t engines = sizeof(ENGINES) / sizeof(ENGINES[0]);
+    vector<double> best(engines, 0);
+    long long instructions = 0;
+    string expected;
+    bool isSame = true;
+    for (int run = 0; run < RUNS; run++) {
+        for (size_t engine = 0; engine < engines; engine++) {
+            string output;
+            double seconds = timeRun(a_program, ENGINES[engine].first, instructions, output);
+            if (run == 0 || seconds < best[engine]) {
+                best[engine] = seconds;
+            }
+            if (run == 0 && engine == 0) {
+                expected = output;
+            }
+            isSame = isSame && output == expected;
+        }
+    }
+
+    cout << left << setw(12) << a_program.m_name << right << setw(12) << instructions << " instructions";
+    for (size_t engine = 0; engine < engines; engine++) {
+        cout << "  " << ENGINES[engine].second << " " << fixed << setprecision(3) << best[engine] << "s";
+    }
+    cout << (isSame ? "  same output" : "  OUTPUT DIFFERS") << endl;
+    cout.unsetf(ios::fixed);
+}
+
+/*
+NAME:
+
+    mixedLoop() - builds a loop of register instructions and branches
+
+SYNOPSIS:
+
+    Program mixedLoop(long long a_iterations);
+    a_iterations    --> the iterations of the loop
+
+DESCRIPTION:
+
+    Each iteration runs register instructions and takes a branch of every kind, so that the
+    engines neither fuse its instructions nor fast forward it.
+
+RETURNS:
+
+    Program - returns the program
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+Program mixedLoop(long long a_iterations)
+{
+    return Program { "mixed", {
+        { 1, word(5, 1, 0, 50) }, { 2, word(5, 2, 0, 51) }, { 3, word(5, 4, 0, 52) },
+        { 4, word(7, 3, 2, 0) }, { 5, word(9, 3, 2, 0) }, { 6, word(8, 3, 4, 0) },
+        { 7, word(15, 3, 0, 9) }, { 8, word(7, 5, 2, 0) }, { 9, word(8, 1, 2, 0) },
+        { 10, word(14, 5, 0, 12) }, { 11, word(7, 6, 2, 0) }, { 12, word(16, 1, 0, 4) },
+        { 13, word(6, 5, 0, 53) }, { 14, word(12, 9, 0, 53) }, { 15, word(17, 9, 0, 0) },
+        { 50, a_iterations }, { 51, 1 }, { 52, 3 } },
+        1, { } };
+}
+
+/*
+NAME:
+
+    runDispatch() - times the engines on loops of ordinary instructions
+
+SYNOPSIS:
+
+    void runDispatch(long long a_iterations);
+    a_iterations    --> the iterations of each loop
+
+DESCRIPTION:
+
+    test2 is the loop of test2.txt, with n loaded as the iterations rather than read, since
+    READ takes no number that large, and multiplied by one rather than by the product, which
+    would overflow at once. sum adds a register to itself in a loop counted in memory.
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void runDispatch(long long a_iterations)
+{
+    Program test2 { "test2", {
+        { 101, word(5, 1, 0, 110) }, { 102, word(3, 1, 0, 211) },
+        { 103, word(6, 1, 0, 210) }, { 104, word(5, 1, 0, 110) }, { 105, word(2, 1, 0, 211) },
+        { 106, word(6, 1, 0, 110) }, { 107, word(16, 1, 0, 101) }, { 108, word(12, 0, 0, 210) },
+        { 109, word(17, 0, 0, 0) }, { 110, a_iterations }, { 210, 1 }, { 211, 1 }, { 212, 1234 } },
+        101, { } };
+
+    Program sum { "sum", {
+        { 11, word(5, 1, 0, 22) }, { 12, word(1, 2, 0, 22) }, { 13, word(5, 3, 0, 24) },
+        { 14, word(7, 3, 2, 0) }, { 15, word(2, 1, 0, 23) }, { 16, word(6, 1, 0, 22) },
+        { 17, word(16, 1, 0, 11) }, { 18, word(6, 2, 0, 24) }, { 19, word(12, 9, 0, 24) },
+        { 20, word(17, 9, 0, 0) }, { 22, a_iterations }, { 23, 1 } },
+        11, { } };
+
+    timeEngines(test2);
+    timeEngines(sum);
+    timeEngines(mixedLoop(a_iterations));
+}
+
+/*
+NAME:
+
+    runScan() - times the engines passing over zero words with each scanner
+
+SYNOPSIS:
+
+    void runScan(long long a_iterations);
+    a_iterations    --> the times the loop falls through the gap
+
+DESCRIPTION:
+
+    The gap's words are written and then cleared, so that its pages are allocated and the
+    engines must scan them word by word rather than pass over pages that were never written.
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void runScan(long long a_iterations)
+{
+    const int GAP_END = 900'000;
+    Program gap { "", { }, 0, { } };
+    for (int location = 4; location < GAP_END; location++) {
+        gap.m_words.push_back({ location, 1 });
+        gap.m_words.push_back({ location, 0 });
+    }
+    gap.m_words.insert(gap.m_words.end(), {
+        { 0, word(5, 2, 0, 999'990) }, { 1, word(2, 2, 0, 999'991) }, { 2, word(6, 2, 0, 999'990) },
+        { 3, word(15, 2, 0, GAP_END + 1) }, { GAP_END, word(13, 0, 0, 0) },
+        { GAP_END + 1, word(12, 9, 0, 999'990) }, { GAP_END + 2, word(17, 9, 0, 0) },
+        { 999'990, a_iterations }, { 999'991, 1 } });
+
+    string chosen = ZeroScanner::implementation();
+    for (const char* scanner : { "scalar", "SSE2", "AVX2" }) {
+        if (ZeroScanner::useImplementation(scanner)) {
+            gap.m_name = string("gap ") + scanner;
+            timeEngines(gap);
+        }
+    }
+    ZeroScanner::useImplementation(chosen);
+}
+
+/*
+NAME:
+
+    runPolicies() - times the switch engine with each of its debugging policies
+
+SYNOPSIS:
+
+    void runPolicies(long long a_iterations);
+    a_iterations    --> the iterations of the loop
+
+DESCRIPTION:
+
+    A normal run uses the policies that do nothing, so it should take as long as the
+    switch engine did before it was built from policies. Each of the others turns on the
+    debugging build without changing the run: a breakpoint where the program never goes, and
+    address bounds that cover all of memory. The lines give the cost of each, and the normal
+    run's line can be compared between builds. A trace is left out, since writing its lines
+    takes far longer than the run.
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void runPolicies(long long a_iterations)
+{
+    const pair<const char*, function<void(Emulator&)>> policies[] = {
+        { "normal", nullptr },
+        { "breakpoint", [](Emulator& a_emulator) { a_emulator.setBreakpoint(999'999, true); } },
+        { "bounds", [](Emulator& a_emulator) { a_emulator.setAddressBounds(0, 999'999); } }
+    };
+
+    Program mixed = mixedLoop(a_iterations);
+    for (const auto& policy : policies) {
+        double best = 0;
+        long long instructions = 0;
+        for (int run = 0; run < RUNS; run++) {
+            string output;
+            double seconds = timeRun(mixed, Emulator::Engine::Switch, instructions, output, policy.second);
+            if (run == 0 || seconds < best) {
+                best = seconds;
+            }
+        }
+        cout << left << setw(12) << policy.first << right << setw(12) << instructions << " instructions  switch "
+            << fixed << setprecision(3) << best << "s  " << setprecision(2) << best * 1e9 / instructions
+            << " ns per instruction" << endl;
+        cout.unsetf(ios::fixed);
+    }
+}
+
+/*
+NAME:
+
+    runTrace() - times recording a run to a trace and replaying it
+
+SYNOPSIS:
+
+    void runTrace(long long a_iterations);
+    a_iterations    --> the iterations of the loop, which the program reads
+
+DESCRIPTION:
+
+    The mixed loop reads its iterations, so that the trace has a number to record. Each
+    trace is written to VC8000Bench.trace in the working directory, which is removed at the
+    end. The trace lines give its bytes, and the replay line whether it matched the trace.
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void runTrace(long long a_iterations)
+{
+    const string fileName = "VC8000Bench.trace";
+    if (a_iterations >= 1'000'000) {
+        cerr << "The trace benchmark reads its iterations, which must be fewer than 1,000,000" << endl;
+        return;
+    }
+    Program mixed = mixedLoop(0);
+    mixed.m_words.push_back({ 0, word(11, 0, 0, 50) });
+    mixed.m_entryPoint = 0;
+    mixed.m_input = { static_cast<int>(a_iterations) };
+
+    // The runs timed, in order, so that the replays read the trace of the last run recorded
+    // with its instructions.
+    enum class Kind { None, Input, Instructions, Replay };
+    const pair<const char*, Kind> kinds[] = {
+        { "none", Kind::None },
+        { "input", Kind::Input },
+        { "instructions", Kind::Instructions },
+        { "replay", Kind::Replay }
+    };
+    for (const auto& kind : kinds) {
+        double best = 0;
+        long long instructions = 0;
+        long long bytes = 0;
+        bool isMatched = false;
+        for (int run = 0; run < RUNS; run++) {
+            unique_ptr<TraceWriter> writer;
+            unique_ptr<TraceReader> reader;
+            if (kind.second == Kind::Input || kind.second == Kind::Instructions) {
+                writer.reset(new TraceWriter(fileName, kind.second == Kind::Instructions));
+            }
+            else if (kind.second == Kind::Replay) {
+                reader.reset(new TraceReader(fileName));
+            }
+
+            string output;
+            double seconds = timeRun(mixed, Emulator::Engine::Switch, instructions, output, [&](Emulator& a_emulator) {
+                if (writer) {
+                    a_emulator.recordTrace(*writer);
+                }
+                if (reader) {
+                    a_emulator.replayTrace(*reader);
+                }
+            });
+            if (run == 0 || seconds < best) {
+                best = seconds;
+            }
+            if (writer) {
+                writer->flush();
+                bytes = writer->getBytes();
+            }
+            if (reader) {
+                isMatched = reader->isOpen() && !reader->hasDiverged() && reader->getMatched() == instructions;
+            }
+        }
+
+        cout << left << setw(12) << kind.first << right << setw(12) << instructions << " instructions  "
+            << fixed << setprecision(3) << best << "s  " << setprecision(2) << best * 1e9 / instructions
+            << " ns per instruction";
+        if (kind.second == Kind::Input || kind.second == Kind::Instructions) {
+            cout << "  " << bytes << " bytes, " << static_cast<double>(bytes) / instructions << " per instruction";
+        }
+        else if (kind.second == Kind::Replay) {
+            cout << (isMatched ? "  matched the trace" : "  DIFFERED FROM THE TRACE");
+        }
+        cout << endl;
+        cout.unsetf(ios::fixed);
+    }
+    remove(fileName.c_str());
+}
+
+/*
+NAME:
+
+    runWords() - times the engines reading many distinct words of memory
+
+SYNOPSIS:
+
+    void runWords(long long a_instructions);
+    a_instructions  --> the instructions each loop runs for, about
+
+DESCRIPTION:
+
+    Each loop is a straight run of ADDs, each reading a word of its own, closed by a counter
+    kept in memory, so the words read take as much of the host's cache as the build's word
+    size makes them. The first line tells which word size the benchmark was built with.
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void runWords(long long a_instructions)
+{
+    cout << "Built with " << (VC8000_COMPACT_WORDS ? "32-bit compact" : "64-bit") << " words" << endl;
+    for (int words : { 1'000, 10'000, 60'000, 150'000, 300'000 }) {
+        // the ADDs at 0 onward read the words at data onward, and the counter follows the loop
+        const int data = words + 10;
+        const int counter = data + words;
+        Program sweep { to_string(words / 1'000) + "k words", { }, 0, { } };
+        for (int add = 0; add < words; add++) {
+            sweep.m_words.push_back({ add, word(1, 1, 0, data + add) });
+            sweep.m_words.push_back({ data + add, 1 });
+        }
+        sweep.m_words.insert(sweep.m_words.end(), {
+            { words, word(5, 2, 0, counter) }, { words + 1, word(2, 2, 0, counter + 1) },
+            { words + 2, word(6, 2, 0, counter) }, { words + 3, word(16, 2, 0, 0) },
+            { words + 4, word(17, 0, 0, 0) },
+            { counter, a_instructions / (words + 4) + 1 }, { counter + 1, 1 } });
+        timeEngines(sweep);
+    }
+}
+
+// The benchmarks, and the iterations of their loops by default.
+struct Benchmark {
+    const char* m_name;
+    void (*m_run)(long long a_iterations);
+    long long m_iterations;
+};
+const Benchmark BENCHMARKS[] = {
+    { "dispatch", runDispatch, 20'000'000 },
+    { "scan", runScan, 2'000 },
+    { "policies", runPolicies, 20'000'000 },
+    { "trace", runTrace, 700'000 },
+    { "words", runWords, 60'000'000 }
+};
+
+}
+
+/*
+NAME:
+
+    main() - runs the benchmark named on the command line
+
+SYNOPSIS:
+
+    int main(int argc, char* argv[]);
+    argc        --> the number of arguments
+    argv        --> the benchmark, and the iterations of its loops if not the default
+
+RETURNS:
+
+    int - returns 0 if the benchmark ran, 1 if it is not known
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+int main(int argc, char* argv[])
+{
+    string name = argc > 1 ? argv[1] : "";
+    long long iterations = argc > 2 ? atoll(argv[2]) : 0;
+    for (const Benchmark& benchmark : BENCHMARKS) {
+        if (name == benchmark.m_name) {
+            benchmark.m_run(iterations > 0 ? iterations : benchmark.m_iterations);
+            return 0;
+        }
+    }
+
+    cerr << "Usage: VC8000Bench <benchmark> [iterations], where the benchmark is one of:";
+    for (const Benchmark& benchmark : BENCHMARKS) {
+        cerr << " " << benchmark.m_name;
+    }
+    cerr << endl;
+    return 1;
+}
@@ -0,0 +1,669 @@
+//
+//		Implementation of the CostEstimator class.
+//
+#include "stdafx.h"
+#include "CostEstimator.h"
+
+const long long CostEstimator::UNBOUNDED;
+const int CostEstimator::EXIT;
+const long long CostEstimator::NONE;
+
+namespace {
+    const long long UNBOUNDED = CostEstimator::UNBOUNDED;
+
+    // Adds costs, an unbounded one or a sum too large to count making the total unbounded.
+    long long addCosts(long long a_first, long long a_second)
+    {
+        if (a_first == UNBOUNDED || a_second == UNBOUNDED || a_first > UNBOUNDED - a_second) {
+            return UNBOUNDED;
+        }
+        return a_first + a_second;
+    }
+
+    // Multiplies a cost by a count of times it is paid, in the same way.
+    long long multiplyCost(long long a_count, long long a_cost)
+    {
+        if (a_count == 0 || a_cost == 0) {
+            return 0;
+        }
+        if (a_count == UNBOUNDED || a_cost == UNBOUNDED || a_count > UNBOUNDED / a_cost) {
+            return UNBOUNDED;
+        }
+        return a_count * a_cost;
+    }
+
+    // Checks whether a word is an instruction that changes the register r1 names.
+    bool writesRegister(MemoryWord a_word, int a_reg)
+    {
+        long long opCode = a_word / 10'000'000;
+        bool isWriter = (opCode >= 1 && opCode <= 5) || (opCode >= 7 && opCode <= 10);
+        return isWriter && (a_word / 1'000'000) % 10 == a_reg;
+    }
+
+    // Finds the strongly connected components of a graph, each of them before any that leads
+    // to it.  The search keeps its own stack, so a long chain of blocks cannot exhaust the
+    // thread's.
+    vector<vector<int>> findComponents(const vector<vector<int>>& a_edges)
+    {
+        int count = static_cast<int>(a_edges.size());
+        vector<int> order(count, -1), lowest(count, 0);
+        vector<char> isOnStack(count, 0);
+        vector<int> stack;
+        vector<pair<int, size_t>> search;      // A node being searched, and its next edge.
+        vector<vector<int>> components;
+        int visited = 0;
+
+        for (int root = 0; root < count; root++) {
+            if (order[root] >= 0) {
+                continue;
+            }
+            search.push_back({ root, 0 });
+            order[root] = lowest[root] = visited++;
+            stack.push_back(root);
+            isOnStack[root] = 1;
+            while (!search.empty()) {
+                int node = search.back().first;
+                size_t& edge = search.back().second;
+                if (edge < a_edges[node].size()) {
+                    int next = a_edges[node][edge++];
+                    if (order[next] < 0) {
+                        order[next] = lowest[next] = visited++;
+                        stack.push_back(next);
+                        isOnStack[next] = 1;
+                        search.push_back({ next, 0 });
+                    }
+                    else if (isOnStack[next] && order[next] < lowest[node]) {
+                        lowest[node] = order[next];
+                    }
+                    continue;
+                }
+                search.pop_back();
+                if (!search.empty() && lowest[node] < lowest[search.back().first]) {
+                    lowest[search.back().first] = lowest[node];
+                }
+                if (lowest[node] == order[node]) {
+                    components.push_back(vector<int>());
+                    int member;
+                    do {
+                        member = stack.back();
+                        stack.pop_back();
+                        isOnStack[member] = 0;
+                        components.back().push_back(member);
+                    } while (member != node);
+                }
+            }
+        }
+        return components;
+    }
+}
+
+/*
+NAME:
+
+    estimate() - bounds the instructions a run executes
+
+SYNOPSIS:
+
+    CostEstimator::Cost CostEstimator::estimate(int a_start);
+    a_start     --> the location the run starts at
+
+DESCRIPTION:
+
+    The whole graph is one region, entered at the starting block. Once its loops are collapsed
+    it has no cycles, so the fewest and most instructions to the end of the run are the
+    cheapest and dearest paths out of it. If a STORE or READ on those paths may write a word
+    control reaches or passes over, the program may change its own code, as ProgramVerifier
+    reports, so the run may execute anything from no instructions to no bound on them.
+
+RETURNS:
+
+    CostEstimator::Cost - returns the fewest and most instructions the run executes
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+CostEstimator::Cost CostEstimator::estimate(int a_start)
+{
+    Cost cost;
+    if (a_start < 0 || a_start >= m_size) {
+        m_isSeen.clear();
+        return cost;
+    }
+    buildGraph(a_start);
+    for (const auto& write : m_writes) {
+        if (m_isSeen[write.first]) {
+            cost.m_worst = UNBOUNDED;
+            cost.m_isUnknown = true;
+            return cost;
+        }
+    }
+
+    vector<int> members(m_blocks.size());
+    for (size_t block = 0; block < m_blocks.size(); block++) {
+        members[block] = static_cast<int>(block);
+    }
+    Span cycle, leave;
+    vector<int> exits;
+    spanRegion(members, m_blockAt[a_start], false, cycle, leave, exits);
+    cost.m_best = leave.m_best;
+    cost.m_worst = leave.m_worst == NONE ? UNBOUNDED : leave.m_worst;
+    return cost;
+}
+
+/*
+NAME:
+
+    buildGraph() - finds the blocks control may reach from a location
+
+SYNOPSIS:
+
+    void CostEstimator::buildGraph(int a_start);
+    a_start     --> the location control starts at
+
+DESCRIPTION:
+
+    Control is first followed as the ProgramVerifier follows it, noting where blocks start:
+    at the starting location, at the target of each branch and after each BM, BZ and BP.
+    Then each block is walked from its start to the next start, a branch or a HALT. Zero
+    words are passed over and cost nothing; a word that is not an instruction ends the run
+    with an error, as does running off the end of memory.
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void CostEstimator::buildGraph(int a_start)
+{
+    m_blocks.clear();
+    m_blockAt.clear();
+    m_writes.clear();
+    m_isSeen.assign(m_size, 0);
+
+    // Find where the blocks start, and the locations STOREs and READs write.
+    vector<int> pending(1, a_start);
+    m_blockAt[a_start] = 0;
+    while (!pending.empty()) {
+        int loc = pending.back();
+        pending.pop_back();
+        bool isRunning = true;
+        while (isRunning && loc < m_size && !m_isSeen[loc]) {
+            m_isSeen[loc] = 1;
+            MemoryWord word = m_memory.get(loc);
+            if (word == 0) {
+                loc++;
+                continue;
+            }
+            long long opCode = word / 10'000'000;
+            int address = static_cast<int>(word % 1'000'000);
+            if (word < 0 || opCode < 1 || opCode > 17 || address >= m_size) {
+                break;
+            }
+            switch (opCode) {
+            case 6:
+            case 11:
+                m_writes[address]++;
+                break;
+            case 13:
+                isRunning = false;
+                // Fall through.
+            case 14:
+            case 15:
+            case 16:
+                if (m_blockAt.insert({ address, 0 }).second) {
+                    pending.push_back(address);
+                }
+                break;
+            case 17:
+                isRunning = false;
+                break;
+            }
+            if (opCode >= 14 && opCode <= 16 && loc + 1 < m_size) {
+                m_blockAt.insert({ loc + 1, 0 });
+            }
+            loc++;
+        }
+    }
+
+    // Number the blocks in the order of their locations, then walk each of them.
+    for (auto& start : m_blockAt) {
+        start.second = static_cast<int>(m_blocks.size());
+        m_blocks.push_back(Block());
+        m_blocks.back().m_start = start.first;
+    }
+    for (Block& block : m_blocks) {
+        int loc = block.m_start;
+        while (true) {
+            if (loc >= m_size) {
+                block.m_successors.push_back(EXIT);
+                break;
+            }
+            if (loc != block.m_start && m_blockAt.count(loc) != 0) {
+                block.m_successors.push_back(m_blockAt[loc]);
+                break;
+            }
+            MemoryWord word = m_memory.get(loc);
+            if (word == 0) {
+                loc++;
+                continue;
+            }
+            long long opCode = word / 10'000'000;
+            int address = static_cast<int>(word % 1'000'000);
+            if (word < 0 || opCode < 1 || opCode > 17 || address >= m_size) {
+                block.m_successors.push_back(EXIT);
+                break;
+            }
+            block.m_instructions.push_back(loc);
+            if (opCode == 17) {
+                block.m_successors.push_back(EXIT);
+                break;
+            }
+            if (opCode >= 13 && opCode <= 16) {
+                block.m_successors.push_back(m_blockAt[address]);
+                if (opCode != 13) {
+                    block.m_successors.push_back(loc + 1 < m_size ? m_blockAt[loc + 1] : EXIT);
+                }
+                break;
+            }
+            loc++;
+        }
+    }
+}
+
+/*
+NAME:
+
+    spanRegion() - spans the paths through some blocks once their loops are collapsed
+
+SYNOPSIS:
+
+    void CostEstimator::spanRegion(const vector<int>& a_members, int a_entry, bool a_isLoop, Span& a_cycle, Span& a_leave, vector<int>& a_exits);
+    a_members   --> the blocks of the region
+    a_entry     --> the block control enters the region at
+    a_isLoop    --> true if the region is a loop entered at a_entry, false for the whole graph
+    a_cycle     --> set to the span of the paths from a_entry back to it
+    a_leave     --> set to the span of the paths from a_entry out of the region
+    a_exits     --> the blocks outside the region, or EXIT, its paths out lead to
+
+DESCRIPTION:
+
+    With the edges back to the entry of a loop set aside, each strongly connected component
+    of the region is either one block or a loop inside it. A loop with a single entry is
+    spanned on its own, and becomes a node whose successors are its exits; one entered at
+    more than one block is not a loop this estimator can bound, so it may cost anything. The
+    nodes then form a graph without cycles, and the components come out of the search with
+    each one before any that leads to it, so the spans of each node's paths are found from
+    those of its successors in that order.
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void CostEstimator::spanRegion(const vector<int>& a_members, int a_entry, bool a_isLoop, Span& a_cycle, Span& a_leave, vector<int>& a_exits)
+{
+    int count = static_cast<int>(a_members.size());
+    map<int, int> local;
+    for (int member = 0; member < count; member++) {
+        local[a_members[member]] = member;
+    }
+    vector<vector<int>> edges(count);
+    vector<char> hasSelfEdge(count, 0);
+    for (int member = 0; member < count; member++) {
+        for (int successor : m_blocks[a_members[member]].m_successors) {
+            if (successor == EXIT || local.count(successor) == 0 || (a_isLoop && successor == a_entry)) {
+                continue;
+            }
+            edges[member].push_back(local[successor]);
+            if (local[successor] == member) {
+                hasSelfEdge[member] = 1;
+            }
+        }
+    }
+    vector<vector<int>> components = findComponents(edges);
+    vector<int> componentOf(count);
+    for (size_t component = 0; component < components.size(); component++) {
+        for (int member : components[component]) {
+            componentOf[member] = static_cast<int>(component);
+        }
+    }
+
+    // Each component's span, and where its paths go.  Components leading to other ones
+    // come after them, so they are spanned last.
+    vector<Span> cycle(components.size()), leave(components.size());
+    for (size_t component = 0; component < components.size(); component++) {
+        const vector<int>& nodes = components[component];
+        Span span;
+        vector<int> targets;
+        if (nodes.size() == 1 && !hasSelfEdge[nodes[0]]) {
+            const Block& block = m_blocks[a_members[nodes[0]]];
+            span.m_best = span.m_worst = static_cast<long long>(block.m_instructions.size());
+            targets = block.m_successors;
+        }
+        else {
+            vector<int> loop, entries;
+            for (int node : nodes) {
+                loop.push_back(a_members[node]);
+            }
+            for (int node : nodes) {
+                bool isEntered = a_members[node] == a_entry;
+                for (int from = 0; from < count && !isEntered; from++) {
+                    if (componentOf[from] != static_cast<int>(component)) {
+                        isEntered = find(edges[from].begin(), edges[from].end(), node) != edges[from].end();
+                    }
+                }
+                if (isEntered) {
+                    entries.push_back(a_members[node]);
+                }
+            }
+            sort(loop.begin(), loop.end());
+            sort(entries.begin(), entries.end());
+            span = spanLoop(loop, entries.empty() ? loop[0] : entries[0], a_isLoop, targets);
+            if (entries.size() > 1) {
+                span.m_best = 0;
+                span.m_worst = UNBOUNDED;
+            }
+        }
+
+        // The cheapest and dearest ways on from the component.
+        Span cycleOn = { UNBOUNDED, NONE }, leaveOn = { UNBOUNDED, NONE };
+        for (int target : targets) {
+            const Span* cycleNext = nullptr;
+            const Span* leaveNext = nullptr;
+            Span done = { 0, 0 };
+            if (target == EXIT || local.count(target) == 0) {
+                leaveNext = &done;
+                a_exits.push_back(target);
+            }
+            else if (a_isLoop && target == a_entry) {
+                cycleNext = &done;
+            }
+            else {
+                cycleNext = &cycle[componentOf[local[target]]];
+                leaveNext = &leave[componentOf[local[target]]];
+            }
+            if (cycleNext != nullptr && cycleNext->m_best < cycleOn.m_best) {
+                cycleOn.m_best = cycleNext->m_best;
+            }
+            if (cycleNext != nullptr && cycleNext->m_worst > cycleOn.m_worst) {
+                cycleOn.m_worst = cycleNext->m_worst;
+            }
+            if (leaveNext != nullptr && leaveNext->m_best < leaveOn.m_best) {
+                leaveOn.m_best = leaveNext->m_best;
+            }
+            if (leaveNext != nullptr && leaveNext->m_worst > leaveOn.m_worst) {
+                leaveOn.m_worst = leaveNext->m_worst;
+            }
+        }
+        if (span.m_best == UNBOUNDED) {
+            cycleOn = leaveOn = { UNBOUNDED, NONE };
+        }
+        cycle[component] = cycleOn;
+        leave[component] = leaveOn;
+        for (Span* on : { &cycle[component], &leave[component] }) {
+            if (on->m_worst != NONE) {
+                on->m_best = addCosts(on->m_best, span.m_best);
+                on->m_worst = addCosts(on->m_worst, span.m_worst);
+            }
+        }
+    }
+    a_cycle = cycle[componentOf[local[a_entry]]];
+    a_leave = leave[componentOf[local[a_entry]]];
+    sort(a_exits.begin(), a_exits.end());
+    a_exits.erase(unique(a_exits.begin(), a_exits.end()), a_exits.end());
+}
+
+/*
+NAME:
+
+    spanLoop() - spans the paths through a loop
+
+SYNOPSIS:
+
+    CostEstimator::Span CostEstimator::spanLoop(const vector<int>& a_members, int a_header, bool a_isNested, vector<int>& a_exits);
+    a_members   --> the blocks of the loop
+    a_header    --> the block control enters it at
+    a_isNested  --> true if the loop is inside another
+    a_exits     --> the blocks outside the loop, or EXIT, its paths out lead to
+
+DESCRIPTION:
+
+    A run that executes the header n times goes around the loop n-1 times and then out of
+    it, so with the header executed between the fewest and the most times the loop's trip
+    count allows, the loop costs at least the cheapest path around times one less than the
+    fewest, plus the cheapest way out, and at most the same with the dearest paths.
+
+RETURNS:
+
+    CostEstimator::Span - returns the span of the paths from the header out of the loop
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+CostEstimator::Span CostEstimator::spanLoop(const vector<int>& a_members, int a_header, bool a_isNested, vector<int>& a_exits)
+{
+    Span cycle, leave;
+    spanRegion(a_members, a_header, true, cycle, leave, a_exits);
+    if (leave.m_worst == NONE) {
+        return { UNBOUNDED, UNBOUNDED };
+    }
+    long long fewest, most;
+    if (!countTrips(a_members, a_header, a_isNested, fewest, most)) {
+        fewest = 1;
+        most = UNBOUNDED;
+    }
+    Span span;
+    span.m_best = addCosts(multiplyCost(fewest - 1, cycle.m_best), leave.m_best);
+    span.m_worst = most == UNBOUNDED ? UNBOUNDED : addCosts(multiplyCost(most - 1, cycle.m_worst), leave.m_worst);
+    return span;
+}
+
+/*
+NAME:
+
+    countTrips() - bounds the number of times a loop's header is executed
+
+SYNOPSIS:
+
+    bool CostEstimator::countTrips(const vector<int>& a_members, int a_header, bool a_isNested, long long& a_fewest, long long& a_most);
+    a_members   --> the blocks of the loop
+    a_header    --> the block control enters it at
+    a_isNested  --> true if the loop is inside another
+    a_fewest    --> set to the fewest times each time the loop is entered
+    a_most      --> set to the most times
+
+DESCRIPTION:
+
+    The loop must go back to its header from a single block, by a BM, BZ or BP whose other
+    way leads out of the loop, testing a register whose value changes by the constant d
+    each time around. With v the counter's value before the loop, the test sees v + n*d the
+    n-th time, and the loop goes around again while the test is passed, so the header is
+    executed until the first n at which it is not.
+
+    A memory counter is kept from one entry of the loop to the next, so in a loop inside
+    another the count is the most for the whole run, and each entry may take as few as one.
+    A loop with other ways out may also leave before its count is reached.
+
+RETURNS:
+
+    bool - returns true if the loop is bounded, false otherwise
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+bool CostEstimator::countTrips(const vector<int>& a_members, int a_header, bool a_isNested, long long& a_fewest, long long& a_most)
+{
+    // Find the block that goes back to the header, and check that the loop's only other way
+    // out is from there.
+    int latch = -1;
+    bool isOnlyExit = true;
+    for (int member : a_members) {
+        for (int successor : m_blocks[member].m_successors) {
+            if (successor == a_header) {
+                if (latch >= 0 && latch != member) {
+                    return false;
+                }
+                latch = member;
+            }
+        }
+    }
+    if (latch < 0) {
+        return false;
+    }
+    const Block& block = m_blocks[latch];
+    if (block.m_successors.size() != 2 || block.m_successors[0] != a_header ||
+        binary_search(a_members.begin(), a_members.end(), block.m_successors[1])) {
+        return false;
+    }
+    for (int member : a_members) {
+        for (int successor : m_blocks[member].m_successors) {
+            if (member != latch && !binary_search(a_members.begin(), a_members.end(), successor)) {
+                isOnlyExit = false;
+            }
+        }
+    }
+
+    // The register tested, and the instruction that last changes it before the test.
+    const vector<int>& code = block.m_instructions;
+    int test = static_cast<int>(code.size()) - 1;
+    MemoryWord branch = m_memory.get(code[test]);
+    long long opCode = branch / 10'000'000;
+    int reg = static_cast<int>(branch / 1'000'000 % 10);
+    int step = test - 1;
+    while (step >= 0 && !writesRegister(m_memory.get(code[step]), reg)) {
+        step--;
+    }
+    if (step < 0) {
+        return false;
+    }
+    MemoryWord change = m_memory.get(code[step]);
+    int constant = static_cast<int>(change % 1'000'000);
+    if ((change / 10'000'000 != 1 && change / 10'000'000 != 2) || getWrites(constant) != 0) {
+        return false;
+    }
+    long long delta = change / 10'000'000 == 1 ? m_memory.get(constant) : -static_cast<long long>(m_memory.get(constant));
+
+    // A memory counter is loaded before the change and stored after it.
+    long long value;
+    int load = step - 1;
+    while (load >= 0 && !writesRegister(m_memory.get(code[load]), reg)) {
+        load--;
+    }
+    MemoryWord loadWord = load >= 0 ? m_memory.get(code[load]) : 0;
+    int counter = static_cast<int>(loadWord % 1'000'000);
+    bool isStored = false;
+    for (int store = step + 1; store < test && load >= 0; store++) {
+        MemoryWord word = m_memory.get(code[store]);
+        isStored = isStored || (word / 10'000'000 == 6 && word / 1'000'000 % 10 == reg && word % 1'000'000 == counter);
+    }
+    if (load >= 0 && loadWord / 10'000'000 == 5 && isStored && getWrites(counter) == 1) {
+        value = m_memory.get(counter);
+        isOnlyExit = isOnlyExit && !a_isNested;
+    }
+    else {
+        // A register counter is changed nowhere else in the loop, and loaded with a constant
+        // by the only block that enters the loop.
+        for (int member : a_members) {
+            for (int loc : m_blocks[member].m_instructions) {
+                if (loc != code[step] && writesRegister(m_memory.get(loc), reg)) {
+                    return false;
+                }
+            }
+        }
+        int entering = -1;
+        for (size_t from = 0; from < m_blocks.size(); from++) {
+            const vector<int>& successors = m_blocks[from].m_successors;
+            if (find(successors.begin(), successors.end(), a_header) != successors.end() &&
+                !binary_search(a_members.begin(), a_members.end(), static_cast<int>(from))) {
+                if (entering >= 0) {
+                    return false;
+                }
+                entering = static_cast<int>(from);
+            }
+        }
+        if (entering < 0) {
+            return false;
+        }
+        const vector<int>& before = m_blocks[entering].m_instructions;
+        load = static_cast<int>(before.size()) - 1;
+        while (load >= 0 && !writesRegister(m_memory.get(before[load]), reg)) {
+            load--;
+        }
+        if (load < 0) {
+            return false;
+        }
+        loadWord = m_memory.get(before[load]);
+        int initial = static_cast<int>(loadWord % 1'000'000);
+        if (loadWord / 10'000'000 != 5 || getWrites(initial) != 0) {
+            return false;
+        }
+        value = m_memory.get(initial);
+    }
+
+    // The first n at which the test is not passed: BM passes negative values, BZ zero and BP
+    // positive ones.
+    long long first = value + delta;
+    long long trips;
+    if (opCode == 15) {
+        if (first == 0 && delta == 0) {
+            return false;
+        }
+        trips = first == 0 ? 2 : 1;
+    }
+    else {
+        long long sign = opCode == 14 ? -1 : 1;
+        if (first * sign <= 0) {
+            trips = 1;
+        }
+        else if (delta * sign >= 0) {
+            return false;
+        }
+        else {
+            long long distance = value * sign;
+            long long pace = -delta * sign;
+            trips = (distance + pace - 1) / pace;
+        }
+    }
+    a_fewest = isOnlyExit ? trips : 1;
+    a_most = trips;
+    return true;
+}
@@ -0,0 +1,100 @@
+//
+//		CostEstimator class - bounds the instructions a VC8000 program executes, without running it
+//
+#ifndef _COSTESTIMATOR_H
+#define _COSTESTIMATOR_H
+
+#include "MemoryWord.h"
+#include "PagedMemory.h"
+
+// Builds the control flow graph of a program image from a starting location: its blocks are
+// straight runs of words that control enters only at the top and leaves only at the bottom.
+// Each loop is found as a strongly connected component with a single entry, the loops inside
+// it are found the same way once the edges back to its entry are set aside, and each loop is
+// then counted as one block whose cost is its iterations times the cost of its body.  A loop
+// is bounded when its branch back tests a counter that every iteration changes by a constant:
+//
+//     memory counter:     load r,x ... add or sub r,c ... store r,x ... bm, bz or bp r,top
+//     register counter:   load r,k before the loop, then add or sub r,c ... bm, bz or bp r,top
+//
+// where c and k are never written, so they keep their DC values, and x is written only by the
+// store shown, so it starts at its DC value and the counter counts every iteration of the run.
+// Any other loop, including one whose counter comes from a READ, is unbounded.  A program that
+// may STORE or READ into a word control reaches can change its own code, so nothing is known
+// of its cost.
+class CostEstimator {
+
+public:
+
+    const static long long UNBOUNDED = LLONG_MAX;   // A cost with no bound.
+
+    // The instructions a run executes from a location until it halts or stops with an error.
+    struct Cost {
+        long long m_best = 0;       // The fewest, or UNBOUNDED if it can never halt.
+        long long m_worst = 0;      // The most, or UNBOUNDED if there is no bound on them.
+        bool m_isUnknown = false;   // True if the program may write its code, leaving 0 and UNBOUNDED.
+        bool isUnbounded() const { return m_worst == UNBOUNDED; }
+    };
+
+    // Estimates the costs of the program in the first a_size words of a_memory, which must
+    // outlive the estimator.
+    CostEstimator(const PagedMemory<MemoryWord>& a_memory, int a_size) : m_memory(a_memory), m_size(a_size) { }
+
+    // Bounds the instructions a run starting at a location executes, with memory as loaded.
+    Cost estimate(int a_start);
+
+    // Checks whether control may reach or pass over a location in the last estimate.
+    bool isCode(int a_location) const {
+        return a_location >= 0 && a_location < static_cast<int>(m_isSeen.size()) && m_isSeen[a_location] != 0;
+    }
+
+private:
+
+    const static int EXIT = -1;     // The successor of a block that halts or stops the run.
+
+    // A straight run of words.  Its cost is the number of instructions in it.
+    struct Block {
+        int m_start = 0;            // The location control enters it at.
+        vector<int> m_instructions; // The location of each word that is not zero.
+        vector<int> m_successors;   // The blocks control may go to next, or EXIT.
+    };
+
+    // The fewest and most instructions along some set of paths.  When there is no path, the
+    // fewest is UNBOUNDED and the most is NONE.
+    struct Span {
+        long long m_best;
+        long long m_worst;
+    };
+    const static long long NONE = -1;
+
+    // Finds the blocks control may reach from a location, and the words the program writes.
+    void buildGraph(int a_start);
+
+    // Collapses the loops among some blocks, leaving aside the edges into a_entry if a_isLoop,
+    // and spans the paths from a_entry back to it and out of the blocks, whose targets are
+    // added to a_exits.
+    void spanRegion(const vector<int>& a_members, int a_entry, bool a_isLoop, Span& a_cycle, Span& a_leave, vector<int>& a_exits);
+
+    // Spans the paths through a loop from its header to its exits, adding their targets to
+    // a_exits.  a_isNested is true if the loop is inside another.
+    Span spanLoop(const vector<int>& a_members, int a_header, bool a_isNested, vector<int>& a_exits);
+
+    // Bounds the number of times a loop's header is executed each time the loop is entered.
+    // Returns false if no bound is found.
+    bool countTrips(const vector<int>& a_members, int a_header, bool a_isNested, long long& a_fewest, long long& a_most);
+
+    // Returns the number of words of the program that may write a location.
+    int getWrites(int a_location) const {
+        auto it = m_writes.find(a_location);
+        return it == m_writes.end() ? 0 : it->second;
+    }
+
+    const PagedMemory<MemoryWord>& m_memory;    // The program image.
+    int m_size;                                 // The words of memory.
+    vector<Block> m_blocks;                     // The blocks of the last estimate.
+    map<int, int> m_blockAt;                    // The block starting at each location.
+    map<int, int> m_writes;                     // The STOREs and READs of each location written.
+    vector<char> m_isSeen;                      // == 1 for each word control reaches or passes over.
+};
+
+#endif
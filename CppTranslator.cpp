@@ -0,0 +1,561 @@
+//
+//		Implementation of the CppTranslator class.
+//
+#include "stdafx.h"
+#include "CppTranslator.h"
+
+/*
+NAME:
+
+    CppTranslator - constructor, records the program to be translated
+
+SYNOPSIS:
+
+    CppTranslator::CppTranslator(const Emulator& a_emul, const SymbolTable& a_symtab);
+    a_emul      --> the emulator whose memory holds the output of Pass II
+    a_symtab    --> the symbol table, used to name the labels of the translation
+
+DESCRIPTION:
+
+    Copies the memory image and entry point, and records the symbol defined at each location.
+    Symbols that were defined more than once are left out.
+
+RETURNS:
+
+    constructor class so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+CppTranslator::CppTranslator(const Emulator& a_emul, const SymbolTable& a_symtab)
+{
+    m_image.resize(Emulator::MEMSZ);
+    for (int loc = 0; loc < Emulator::MEMSZ; loc++) {
+        m_image[loc] = a_emul.getMemory(loc);
+    }
+    m_entryPoint = a_emul.getEntryPoint();
+    for (const auto& symbol : a_symtab.GetSymbols()) {
+        if (symbol.second != a_symtab.multipleDefinedSymbol && m_symbols.find(symbol.second) == m_symbols.end()) {
+            m_symbols[symbol.second] = symbol.first;
+        }
+    }
+}
+
+/*
+NAME:
+
+    TranslateProgram() - writes the C++ translation of the program
+
+SYNOPSIS:
+
+    bool CppTranslator::TranslateProgram(ostream& a_out);
+    a_out       --> the stream that receives the translation
+
+DESCRIPTION:
+
+    The translation holds the memory image, and a main() in which each reachable VC8000
+    instruction becomes a C++ statement and each branch a goto. The VC8000 registers are
+    local variables, so the C++ compiler can keep them in host registers. READ and WRITE
+    behave as they do in Emulator::runProgram. If the program can write into a location
+    that may be executed, a fixed translation cannot be made; the translation then holds
+    an interpreter that runs the memory image instead.
+
+RETURNS:
+
+    bool - returns true if the program was translated into C++ statements, false if the
+    translation uses the embedded interpreter
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+bool CppTranslator::TranslateProgram(ostream& a_out)
+{
+    FindReachable();
+    bool isTranslated = !IsSelfModifying();
+
+    WritePreamble(a_out);
+    if (isTranslated) {
+        WriteTranslatedCode(a_out);
+    }
+    else {
+        WriteInterpreter(a_out);
+    }
+    return isTranslated;
+}
+
+/*
+NAME:
+
+    FindReachable() - finds every location that execution can reach
+
+SYNOPSIS:
+
+    void CppTranslator::FindReachable();
+
+DESCRIPTION:
+
+    Follows the program from the entry point the way the emulator executes it: zero words
+    are stepped over, branches may go to their target, and HALT and words that are not
+    instructions end the path. The targets of the branches are recorded as labels, and so
+    is the entry point if reachable code comes before it.
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void CppTranslator::FindReachable()
+{
+    m_isReachable.assign(Emulator::MEMSZ + 1, 0);
+    m_isBranchTarget.assign(Emulator::MEMSZ + 1, 0);
+
+    vector<int> pending = { m_entryPoint };
+    while (!pending.empty()) {
+        int loc = pending.back();
+        pending.pop_back();
+
+        // Follow the fall through path until it ends or joins a path already followed.
+        while (loc < Emulator::MEMSZ && !m_isReachable[loc]) {
+            m_isReachable[loc] = 1;
+
+            int opCode = 0, reg1 = 0, reg2 = 0, address = 0;
+            if (m_image[loc] == 0) {
+                loc++;
+                continue;
+            }
+            if (!DecodeWord(m_image[loc], opCode, reg1, reg2, address) || opCode == 17) {
+                break;
+            }
+            if (opCode >= 13) {
+                m_isBranchTarget[address] = 1;
+                pending.push_back(address);
+            }
+            if (opCode == 13) {
+                break;
+            }
+            loc++;
+        }
+    }
+    for (int loc = 0; loc < m_entryPoint; loc++) {
+        if (m_isReachable[loc]) {
+            m_isBranchTarget[m_entryPoint] = 1;
+            break;
+        }
+    }
+}
+
+/*
+NAME:
+
+    IsSelfModifying() - checks whether the program can write into its own code
+
+SYNOPSIS:
+
+    bool CppTranslator::IsSelfModifying() const;
+
+DESCRIPTION:
+
+    A reachable STORE or READ whose address is a reachable location, including the zero
+    words that execution steps over, could change the instructions being executed.
+
+RETURNS:
+
+    bool - returns true if the program can write into a reachable location
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+bool CppTranslator::IsSelfModifying() const
+{
+    for (int loc = 0; loc < Emulator::MEMSZ; loc++) {
+        int opCode = 0, reg1 = 0, reg2 = 0, address = 0;
+        if (!m_isReachable[loc] || !DecodeWord(m_image[loc], opCode, reg1, reg2, address)) {
+            continue;
+        }
+        if ((opCode == 6 || opCode == 11) && m_isReachable[address]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+NAME:
+
+    LabelName() - returns the name of the C++ label for a location
+
+SYNOPSIS:
+
+    string CppTranslator::LabelName(int a_location) const;
+    a_location  --> a branch target
+
+DESCRIPTION:
+
+    The label is named after the symbol defined at the location when there is one, and
+    after the location otherwise. The location past the end of memory ends the program.
+
+RETURNS:
+
+    string - the label name
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+string CppTranslator::LabelName(int a_location) const
+{
+    if (a_location >= Emulator::MEMSZ) {
+        return "end_of_memory";
+    }
+    auto symbol = m_symbols.find(a_location);
+    if (symbol != m_symbols.end()) {
+        return "L_" + symbol->second;
+    }
+    return "L" + to_string(a_location);
+}
+
+/*
+NAME:
+
+    WritePreamble() - writes the memory image and the helpers shared by both translations
+
+SYNOPSIS:
+
+    void CppTranslator::WritePreamble(ostream& a_out) const;
+    a_out       --> the stream that receives the translation
+
+DESCRIPTION:
+
+    Writes the non-zero words of memory, the READ helper, and arithmetic helpers that wrap
+    around on overflow, as the emulator does, instead of leaving overflow undefined.
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void CppTranslator::WritePreamble(ostream& a_out) const
+{
+    a_out << "// Translation of a VC8000 program into C++, written by the VC8000 assembler.\n"
+          << "#include <iostream>\n"
+          << "using namespace std;\n"
+          << "\n"
+          << "const int MEMSZ = " << Emulator::MEMSZ << ";\n"
+          << "static long long m[MEMSZ];\n"
+          << "\n"
+          << "// The non-zero words of memory after Pass II.\n"
+          << "static const struct { int loc; long long contents; } image[] = {\n";
+    int count = 0;
+    for (int loc = 0; loc < Emulator::MEMSZ; loc++) {
+        if (m_image[loc] != 0) {
+            a_out << "    { " << loc << ", " << m_image[loc] << "LL },\n";
+            count++;
+        }
+    }
+    if (count == 0) {
+        a_out << "    { 0, 0LL },\n";
+    }
+    a_out << "};\n"
+          << R"CODE(
+static long long add(long long a, long long b) { return (long long)((unsigned long long)a + (unsigned long long)b); }
+static long long sub(long long a, long long b) { return (long long)((unsigned long long)a - (unsigned long long)b); }
+static long long mul(long long a, long long b) { return (long long)((unsigned long long)a * (unsigned long long)b); }
+
+// READ: a number is read in and recorded in memory, as in Emulator::runProgram.
+static void readInput(int address) {
+    cout << "Enter: " << endl;
+    int userInput = 0;
+    cout << "? ";
+    cin >> userInput;
+    if (userInput < MEMSZ) {
+        m[address] = userInput;
+    }
+    else {
+        cout << "Too large value" << endl;
+    }
+}
+
+static void loadImage() {
+    for (const auto& word : image) {
+        m[word.loc] = word.contents;
+    }
+}
+)CODE";
+}
+
+/*
+NAME:
+
+    WriteTranslatedCode() - writes main() with one C++ statement per instruction
+
+SYNOPSIS:
+
+    void CppTranslator::WriteTranslatedCode(ostream& a_out) const;
+    a_out       --> the stream that receives the translation
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void CppTranslator::WriteTranslatedCode(ostream& a_out) const
+{
+    a_out << "\nint main() {\n"
+          << "    long long r0 = 0, r1 = 0, r2 = 0, r3 = 0, r4 = 0, r5 = 0, r6 = 0, r7 = 0, r8 = 0, r9 = 0;\n"
+          << "    loadImage();\n\n";
+
+    // The statements are in the order of memory, so start at the entry point if any
+    // reachable code comes before it.
+    for (int loc = 0; loc < m_entryPoint; loc++) {
+        if (m_isReachable[loc]) {
+            a_out << "    goto " << LabelName(m_entryPoint) << ";\n\n";
+            break;
+        }
+    }
+    for (int loc = 0; loc < Emulator::MEMSZ; loc++) {
+        if (!m_isReachable[loc]) {
+            continue;
+        }
+        if (m_isBranchTarget[loc]) {
+            a_out << LabelName(loc) << ":\n";
+        }
+        if (m_image[loc] != 0) {
+            WriteInstruction(a_out, loc);
+        }
+    }
+    if (m_isBranchTarget[Emulator::MEMSZ]) {
+        a_out << LabelName(Emulator::MEMSZ) << ":\n";
+    }
+    a_out << "    return 0;\n"
+          << "}\n";
+}
+
+/*
+NAME:
+
+    WriteInstruction() - writes the C++ statement for one instruction
+
+SYNOPSIS:
+
+    void CppTranslator::WriteInstruction(ostream& a_out, int a_location) const;
+    a_out       --> the stream that receives the translation
+    a_location  --> the location of the instruction
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void CppTranslator::WriteInstruction(ostream& a_out, int a_location) const
+{
+    int opCode = 0, reg1 = 0, reg2 = 0, address = 0;
+    if (!DecodeWord(m_image[a_location], opCode, reg1, reg2, address)) {
+        a_out << "    cout << \"Error! Error in OpCode!!\" << endl;  // " << a_location << "\n"
+              << "    return 1;\n";
+        return;
+    }
+    string r = "r" + to_string(reg1);
+    string r2 = "r" + to_string(reg2);
+    string mem = "m[" + to_string(address) + "]";
+
+    a_out << "    ";
+    switch (opCode) {
+    case 1:  a_out << r << " = add(" << r << ", " << mem << ");"; break;
+    case 2:  a_out << r << " = sub(" << r << ", " << mem << ");"; break;
+    case 3:  a_out << r << " = mul(" << r << ", " << mem << ");"; break;
+    case 4:  a_out << r << " /= " << mem << ";"; break;
+    case 5:  a_out << r << " = " << mem << ";"; break;
+    case 6:  a_out << mem << " = " << r << ";"; break;
+    case 7:  a_out << r << " = add(" << r << ", " << r2 << ");"; break;
+    case 8:  a_out << r << " = sub(" << r << ", " << r2 << ");"; break;
+    case 9:  a_out << r << " = mul(" << r << ", " << r2 << ");"; break;
+    case 10: a_out << r << " /= " << r2 << ";"; break;
+    case 11: a_out << "readInput(" << address << ");"; break;
+    case 12: a_out << "cout << " << mem << " << endl;"; break;
+    case 13: a_out << "goto " << LabelName(address) << ";"; break;
+    case 14: a_out << "if (" << r << " < 0) goto " << LabelName(address) << ";"; break;
+    case 15: a_out << "if (" << r << " == 0) goto " << LabelName(address) << ";"; break;
+    case 16: a_out << "if (" << r << " > 0) goto " << LabelName(address) << ";"; break;
+    case 17: a_out << "return 0;"; break;
+    }
+    a_out << "  // " << a_location << "\n";
+}
+
+/*
+NAME:
+
+    WriteInterpreter() - writes main() as an interpreter of the memory image
+
+SYNOPSIS:
+
+    void CppTranslator::WriteInterpreter(ostream& a_out) const;
+    a_out       --> the stream that receives the translation
+
+DESCRIPTION:
+
+    Used for programs that write into their own code. The interpreter executes the memory
+    image the same way Emulator::runProgram does, so the changes take effect.
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void CppTranslator::WriteInterpreter(ostream& a_out) const
+{
+    a_out << R"CODE(
+// The program writes into its own code, so it is interpreted.
+int main() {
+    long long r[10] = { 0 };
+    loadImage();
+
+)CODE"
+          << "    int pc = " << m_entryPoint << ";\n"
+          << R"CODE(    while (pc < MEMSZ) {
+        long long contents = m[pc];
+        if (contents == 0) {
+            pc++;
+            continue;
+        }
+        int OpCode = static_cast<int>(contents / 10'000'000);
+        int reg1 = (contents / 1'000'000) % 10;
+        int reg2 = (contents / 100'000) % 10;
+        int address = contents % 1'000'000;
+
+        switch (OpCode) {
+        case 1: r[reg1] = add(r[reg1], m[address]); break;
+        case 2: r[reg1] = sub(r[reg1], m[address]); break;
+        case 3: r[reg1] = mul(r[reg1], m[address]); break;
+        case 4: r[reg1] /= m[address]; break;
+        case 5: r[reg1] = m[address]; break;
+        case 6: m[address] = r[reg1]; break;
+        case 7: r[reg1] = add(r[reg1], r[reg2]); break;
+        case 8: r[reg1] = sub(r[reg1], r[reg2]); break;
+        case 9: r[reg1] = mul(r[reg1], r[reg2]); break;
+        case 10: r[reg1] /= r[reg2]; break;
+        case 11: readInput(address); break;
+        case 12: cout << m[address] << endl; break;
+        case 13: pc = address; continue;
+        case 14: if (r[reg1] < 0) { pc = address; continue; } break;
+        case 15: if (r[reg1] == 0) { pc = address; continue; } break;
+        case 16: if (r[reg1] > 0) { pc = address; continue; } break;
+        case 17: return 0;
+        default:
+            cout << "Error! Error in OpCode!!" << endl;
+            return 1;
+        }
+        pc++;
+    }
+    return 0;
+}
+)CODE";
+}
+
+/*
+NAME:
+
+    DecodeWord() - splits a memory word into its fields
+
+SYNOPSIS:
+
+    bool CppTranslator::DecodeWord(long long a_word, int& a_opCode, int& a_reg1, int& a_reg2, int& a_address);
+    a_word      --> the memory word
+    a_opCode, a_reg1, a_reg2, a_address  --> receive the fields of the instruction
+
+RETURNS:
+
+    bool - returns false if the word is not a valid instruction
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+bool CppTranslator::DecodeWord(long long a_word, int& a_opCode, int& a_reg1, int& a_reg2, int& a_address)
+{
+    if (a_word < 10'000'000 || a_word >= 180'000'000) {
+        return false;
+    }
+    a_opCode = static_cast<int>(a_word / 10'000'000);
+    a_reg1 = static_cast<int>((a_word / 1'000'000) % 10);
+    a_reg2 = static_cast<int>((a_word / 100'000) % 10);
+    a_address = static_cast<int>(a_word % 1'000'000);
+    return true;
+}
@@ -0,0 +1,44 @@
+//
+//		CppTranslator class - translates an assembled VC8000 program into a C++ program
+//
+#pragma once
+
+#include "SymTab.h"
+#include "Emulator.h"
+
+class CppTranslator {
+
+public:
+
+    CppTranslator(const Emulator& a_emul, const SymbolTable& a_symtab);
+
+    // Writes the translation as a standalone C++ translation unit.  Returns false if the
+    // program writes into its own code and had to be given the embedded interpreter.
+    bool TranslateProgram(ostream& a_out);
+
+private:
+
+    // Finds every location that execution can reach from the entry point.
+    void FindReachable();
+
+    // Checks whether a reachable STORE or READ writes into a reachable location.
+    bool IsSelfModifying() const;
+
+    // Returns the name of the C++ label for a location.
+    string LabelName(int a_location) const;
+
+    // Writes the parts of the translation.
+    void WritePreamble(ostream& a_out) const;
+    void WriteTranslatedCode(ostream& a_out) const;
+    void WriteInterpreter(ostream& a_out) const;
+    void WriteInstruction(ostream& a_out, int a_location) const;
+
+    // Splits a memory word into its fields.  Returns false if it is not an instruction.
+    static bool DecodeWord(long long a_word, int& a_opCode, int& a_reg1, int& a_reg2, int& a_address);
+
+    vector<long long> m_image;          // Copy of the emulator's memory.
+    int m_entryPoint = 0;               // Location of the first instruction.
+    vector<char> m_isReachable;         // == 1 if execution can reach a location.
+    vector<char> m_isBranchTarget;      // == 1 if a location needs a C++ label.
+    map<int, string> m_symbols;         // The symbol defined at each location.
+};
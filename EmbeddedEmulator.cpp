@@ -0,0 +1,466 @@
+//
+//		Implementation of the EmbeddedEmulator class.
+//
+#include "stdafx.h"
+#include "EmbeddedEmulator.h"
+#include "Emulator.h"
+
+// The emulator's input and output devices, which hand every number, word and message to the
+// callbacks of the EmbeddedEmulator that owns them.
+class EmbeddedEmulator::Devices : public InputDevice, public OutputDevice {
+
+public:
+
+    explicit Devices(const EmbeddedEmulator& a_owner) : m_owner(a_owner) { }
+
+    bool read(int& a_value) override { return m_owner.m_input && m_owner.m_input(a_value); }
+    bool isInteractive() const override { return false; }
+
+    void writeWord(MemoryWord a_word) override {
+        if (m_owner.m_output) {
+            m_owner.m_output(a_word);
+        }
+    }
+    void writeText(const string& a_text) override {
+        if (m_owner.m_messages) {
+            m_owner.m_messages(a_text);
+        }
+    }
+    void writeError(const string& a_message) override { writeText(a_message); }
+    void flush() override { }
+
+private:
+
+    const EmbeddedEmulator& m_owner;
+};
+
+/*
+NAME:
+
+    EmbeddedEmulator() - creates an emulator with empty memory
+
+SYNOPSIS:
+
+    EmbeddedEmulator::EmbeddedEmulator();
+
+RETURNS:
+
+    constructor, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+EmbeddedEmulator::EmbeddedEmulator()
+: m_devices(make_shared<Devices>(*this))
+{
+    m_emulator.reset(new Emulator(m_devices, m_devices));
+}
+
+/*
+NAME:
+
+    ~EmbeddedEmulator() - destroys the emulator
+
+SYNOPSIS:
+
+    EmbeddedEmulator::~EmbeddedEmulator();
+
+DESCRIPTION:
+
+    Defined here, where Emulator is complete, so that the unique_ptr can destroy it.
+
+RETURNS:
+
+    destructor, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+EmbeddedEmulator::~EmbeddedEmulator() = default;
+
+/*
+NAME:
+
+    loadImage() - replaces memory with a program image
+
+SYNOPSIS:
+
+    bool EmbeddedEmulator::loadImage(const long long* a_words, int a_count, int a_origin, int a_entryPoint);
+    a_words     --> the words of the image
+    a_count     --> the number of words
+    a_origin    --> the location of the first word
+    a_entryPoint --> the location of the first instruction executed
+
+DESCRIPTION:
+
+    The image is checked before anything is changed, so a bad image leaves the emulator as it
+    was and reports nothing. A new emulator is made for it, so nothing of the last program,
+    its memory, registers or pause, is left over; only the limits are kept.
+
+RETURNS:
+
+    bool - returns true if the image was loaded, false otherwise
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+bool EmbeddedEmulator::loadImage(const long long* a_words, int a_count, int a_origin, int a_entryPoint)
+{
+    if (a_count < 0 || a_origin < 0 || a_origin > MEMORY_SIZE - a_count || (a_count > 0 && a_words == nullptr) ||
+        a_entryPoint < 0 || a_entryPoint >= MEMORY_SIZE) {
+        return false;
+    }
+    for (int word = 0; word < a_count; word++) {
+        if (a_words[word] != static_cast<MemoryWord>(a_words[word])) {
+            return false;
+        }
+    }
+
+    unique_ptr<Emulator> emulator(new Emulator(m_devices, m_devices));
+    for (int word = 0; word < a_count; word++) {
+        if (a_words[word] != 0) {
+            emulator->insertMemory(a_origin + word, a_words[word]);
+        }
+    }
+    emulator->setEntryPoint(a_entryPoint);
+    emulator->setLimits(m_emulator->getLimits());
+    m_emulator = move(emulator);
+    m_status = Status::NotStarted;
+    return true;
+}
+
+/*
+NAME:
+
+    setRegister() - sets a register
+
+SYNOPSIS:
+
+    bool EmbeddedEmulator::setRegister(int a_reg, long long a_value);
+    a_reg       --> the register, 0 to 9
+    a_value     --> its new value
+
+RETURNS:
+
+    bool - returns true if the register was set, false otherwise
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+bool EmbeddedEmulator::setRegister(int a_reg, long long a_value)
+{
+    if (a_reg < 0 || a_reg >= REGISTERS || a_value != static_cast<MemoryWord>(a_value)) {
+        return false;
+    }
+    m_emulator->setRegister(a_reg, static_cast<MemoryWord>(a_value));
+    return true;
+}
+
+/*
+NAME:
+
+    getRegister() - returns a register
+
+SYNOPSIS:
+
+    long long EmbeddedEmulator::getRegister(int a_reg) const;
+    a_reg       --> the register, 0 to 9
+
+RETURNS:
+
+    long long - returns the register, or 0 if there is no such register
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+long long EmbeddedEmulator::getRegister(int a_reg) const
+{
+    return a_reg >= 0 && a_reg < REGISTERS ? m_emulator->getRegister(a_reg) : 0;
+}
+
+/*
+NAME:
+
+    getMemory() - returns a word of memory
+
+SYNOPSIS:
+
+    long long EmbeddedEmulator::getMemory(int a_location) const;
+    a_location  --> the location of the word
+
+RETURNS:
+
+    long long - returns the word, or 0 if the location is outside memory
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+long long EmbeddedEmulator::getMemory(int a_location) const
+{
+    return a_location >= 0 && a_location < MEMORY_SIZE ? m_emulator->getMemory(a_location) : 0;
+}
+
+/*
+NAME:
+
+    getLocation() - returns where a paused program continues from
+
+SYNOPSIS:
+
+    int EmbeddedEmulator::getLocation() const;
+
+RETURNS:
+
+    int - returns the location of the next instruction, or -1 if the program is not paused
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+int EmbeddedEmulator::getLocation() const
+{
+    return m_emulator->getResumeLocation();
+}
+
+/*
+NAME:
+
+    getInstructionsExecuted() - returns the instructions the last run executed
+
+SYNOPSIS:
+
+    long long EmbeddedEmulator::getInstructionsExecuted() const;
+
+RETURNS:
+
+    long long - returns the instructions, counted a block at a time as the emulator counts them
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+long long EmbeddedEmulator::getInstructionsExecuted() const
+{
+    return m_status == Status::NotStarted ? 0 : m_emulator->getInstructionsExecuted();
+}
+
+/*
+NAME:
+
+    setLimits() - limits each run
+
+SYNOPSIS:
+
+    void EmbeddedEmulator::setLimits(long long a_maxInstructions, long long a_maxMilliseconds);
+    a_maxInstructions --> the instructions a run may execute, or 0 for no limit
+    a_maxMilliseconds --> the wall-clock time a run may take, or 0 for no limit
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void EmbeddedEmulator::setLimits(long long a_maxInstructions, long long a_maxMilliseconds)
+{
+    Emulator::RunLimits limits;
+    limits.m_maxInstructions = a_maxInstructions;
+    limits.m_maxMilliseconds = a_maxMilliseconds;
+    m_emulator->setLimits(limits);
+}
+
+/*
+NAME:
+
+    step() - executes the next instruction
+
+SYNOPSIS:
+
+    EmbeddedEmulator::Status EmbeddedEmulator::step();
+
+DESCRIPTION:
+
+    The run is given a time slice of one step. The engine takes a run of zero words in one
+    step, so when the program is about to pass over zero words, the slice is two steps long:
+    one past the zeros and one for the instruction after them.
+
+RETURNS:
+
+    EmbeddedEmulator::Status - returns Paused, or why the program stopped at the instruction
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+EmbeddedEmulator::Status EmbeddedEmulator::step()
+{
+    int location = m_emulator->isPaused() ? m_emulator->getResumeLocation() : m_emulator->getEntryPoint();
+    m_emulator->setQuantum(m_emulator->getMemory(location) == 0 ? 2 : 1);
+    Status status = run();
+    m_emulator->setQuantum(0);
+    return status;
+}
+
+/*
+NAME:
+
+    runUntil() - runs the program up to a location
+
+SYNOPSIS:
+
+    EmbeddedEmulator::Status EmbeddedEmulator::runUntil(int a_location);
+    a_location  --> the location of the instruction to pause before
+
+DESCRIPTION:
+
+    A breakpoint is set at the location for the run, and cleared once it ends. A program
+    paused at the location executes the instruction there before it can pause again.
+
+RETURNS:
+
+    EmbeddedEmulator::Status - returns Paused if the program reached the location, or why
+    it stopped before it did
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+EmbeddedEmulator::Status EmbeddedEmulator::runUntil(int a_location)
+{
+    m_emulator->setBreakpoint(a_location, true);
+    Status status = run();
+    m_emulator->setBreakpoint(a_location, false);
+    return status;
+}
+
+/*
+NAME:
+
+    run() - runs the program, or continues it
+
+SYNOPSIS:
+
+    EmbeddedEmulator::Status EmbeddedEmulator::run();
+
+RETURNS:
+
+    EmbeddedEmulator::Status - returns why the run ended
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+EmbeddedEmulator::Status EmbeddedEmulator::run()
+{
+    if (m_emulator->isPaused()) {
+        m_emulator->resumeProgram();
+    }
+    else {
+        m_emulator->startProgram();
+    }
+    switch (m_emulator->getTermination()) {
+    case Emulator::Termination::Halted:
+        m_status = Status::Halted;
+        break;
+    case Emulator::Termination::InstructionLimit:
+        m_status = Status::InstructionLimit;
+        break;
+    case Emulator::Termination::TimeLimit:
+        m_status = Status::TimeLimit;
+        break;
+    case Emulator::Termination::InvalidOpCode:
+        m_status = Status::InvalidOpCode;
+        break;
+    case Emulator::Termination::Overflow:
+        m_status = Status::Overflow;
+        break;
+    case Emulator::Termination::AddressOutOfBounds:
+        m_status = Status::AddressOutOfBounds;
+        break;
+    default:
+        // The library sets no memory limit, so a pause is the only other way a run ends.
+        m_status = Status::Paused;
+        break;
+    }
+    return m_status;
+}
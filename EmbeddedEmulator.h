@@ -0,0 +1,120 @@
+//
+//		EmbeddedEmulator class - the VC8000 emulator as a library, for programs that embed it
+//
+#ifndef _EMBEDDEDEMULATOR_H
+#define _EMBEDDEDEMULATOR_H
+
+// This is the one header of the VC8000Core library, so it includes what it uses and names
+// everything with std::, rather than relying on stdafx.h as the rest of the sources do.
+#include <functional>
+#include <memory>
+#include <string>
+
+// VC8000Core builds as a static library, or as a shared one with VC8000_SHARED defined.  A
+// program using the shared library defines VC8000_SHARED too; the library itself also defines
+// VC8000_BUILDING_LIBRARY, so that it exports what the program imports.
+#if defined(VC8000_SHARED) && defined(_WIN32)
+#if defined(VC8000_BUILDING_LIBRARY)
+#define VC8000_API __declspec(dllexport)
+#else
+#define VC8000_API __declspec(dllimport)
+#endif
+#elif defined(VC8000_SHARED) && defined(__GNUC__)
+#define VC8000_API __attribute__((visibility("default")))
+#else
+#define VC8000_API
+#endif
+
+class Emulator;
+
+// Loads a program image, runs it and reports how the run ended, without the console.  READ
+// takes its numbers from an input callback and WRITE passes its words to an output callback,
+// so a run touches no stream; the emulator's messages and errors go to a message callback.
+// A callback that is not set reads no numbers, or drops what it is given.  The emulator is
+// not shared between threads, so each thread that runs programs needs its own.
+class VC8000_API EmbeddedEmulator {
+
+public:
+
+    const static int MEMORY_SIZE = 1'000'000;   // The words of VC8000 memory.
+    const static int REGISTERS = 10;            // The number of VC8000 registers.
+
+    // Takes the next number for a READ.  Returns false if there is none, and the READ then
+    // stores 0, as at the end of a file.
+    typedef std::function<bool(int& a_value)> InputCallback;
+
+    // Receives the word a WRITE writes.
+    typedef std::function<void(long long a_word)> OutputCallback;
+
+    // Receives a message or an error from the emulator.
+    typedef std::function<void(const std::string& a_message)> MessageCallback;
+
+    // Why the last run ended.  A run that is Paused or stopped at a limit can be continued.
+    enum class Status {
+        NotStarted,         // No run since the image was loaded.
+        Halted,             // The program executed HALT or ran off the end of memory.
+        Paused,             // After step(), or at the location given to runUntil().
+        InstructionLimit,   // The run executed the instructions setLimits() allows.
+        TimeLimit,          // The run took the time setLimits() allows.
+        InvalidOpCode,      // The program reached a word that is not an instruction.
+        Overflow,           // A result did not fit in a word.
+        AddressOutOfBounds  // An instruction used memory outside the bounds it may use.
+    };
+
+    EmbeddedEmulator();
+    ~EmbeddedEmulator();
+
+    EmbeddedEmulator(const EmbeddedEmulator&) = delete;
+    EmbeddedEmulator& operator=(const EmbeddedEmulator&) = delete;
+
+    // Replaces memory with a_count words copied to locations a_origin onward, the rest of
+    // memory zero, and the registers zero; the limits are kept.  The program starts at
+    // a_entryPoint.  Returns false, leaving the emulator as it was, if the words do not fit in
+    // memory, a word is too large for one, or the entry point is outside memory.
+    bool loadImage(const long long* a_words, int a_count, int a_origin, int a_entryPoint);
+
+    // Set where READ takes its numbers and where WRITE's words and the emulator's messages go.
+    void setInput(InputCallback a_input) { m_input = a_input; }
+    void setOutput(OutputCallback a_output) { m_output = a_output; }
+    void setMessages(MessageCallback a_messages) { m_messages = a_messages; }
+
+    // Sets a register.  Returns false if there is no such register or the value is too large
+    // for one.
+    bool setRegister(int a_reg, long long a_value);
+
+    // Returns a register, or a word of memory, or 0 if there is none.
+    long long getRegister(int a_reg) const;
+    long long getMemory(int a_location) const;
+
+    // Limits each run to a number of instructions and of milliseconds; zero is no limit.
+    void setLimits(long long a_maxInstructions, long long a_maxMilliseconds);
+
+    // Runs the program from its entry point, or continues it if it is paused or stopped at a
+    // limit, until it halts, stops or reaches a limit.
+    Status run();
+
+    // Executes the next instruction, and pauses.
+    Status step();
+
+    // Runs the program as run() does, pausing before it executes the instruction at a location.
+    Status runUntil(int a_location);
+
+    // Returns why the last run ended, where a paused program continues from, or -1, and the
+    // instructions the last run executed.
+    Status getStatus() const { return m_status; }
+    int getLocation() const;
+    long long getInstructionsExecuted() const;
+
+private:
+
+    class Devices;
+
+    std::unique_ptr<Emulator> m_emulator;   // The emulator holding the image.
+    std::shared_ptr<Devices> m_devices;     // Its READs and WRITEs, through the callbacks.
+    InputCallback m_input;                  // Where READ takes its numbers.
+    OutputCallback m_output;                // Where WRITE's words go.
+    MessageCallback m_messages;             // Where messages and errors go.
+    Status m_status = Status::NotStarted;   // Why the last run ended.
+};
+
+#endif
@@ -4,6 +4,7 @@
 #include "stdafx.h"
 #include "Emulator.h"
 #include "Errors.h"
+#include "ZeroScanner.h"
 #include <string>
 
  
@@ -24,7 +25,13 @@ SYNOPSIS:
 DESCRIPTION:
 
 	The function checks if the a_location is within the valid range of memory. MEMSZ
-    defines the size of the memory. If the location is valid, it stores the a_contents in a_location.
+    defines the size of the memory. If the location is valid, it stores the a_contents in a_location
+    and records its decoded fields in the predecoded table. Loads that start one of the idioms
+    recognized by fuseInstructions() are recorded as fused instructions as the words arrive.
+    Non-zero words are also recorded in the index that lets execution skip over empty memory.
+    A value that does not fit in a word of a compact build is reported and not stored.
+    The program is verified again before it next runs, and translations of the word made
+    by the JIT engine are discarded.
 
 RETURN:
 
@@ -44,7 +51,20 @@ bool Emulator::insertMemory(int a_location, long long a_contents) {
 		
 	//a_location = a_location + 1;
 	if ( a_location >= 0 && a_location < MEMSZ) {
-		m_memory[a_location] = a_contents;
+		if (a_contents != static_cast<MemoryWord>(a_contents)) {
+			Errors::RecordError("Error! Value too large for a memory word at location " + to_string(a_location));
+			Errors::DisplayErrors();
+			return false;
+		}
+		setMemory(a_location, static_cast<MemoryWord>(a_contents));
+		decodeMemory(a_location);
+		if (m_jit) {
+			m_jit->notifyWrite(a_location);
+		}
+		m_isVerifyPending = true;
+		if (a_contents != 0) {
+			markOccupied(a_location);
+		}
         return true;
 	}
 	else {
@@ -53,33 +73,1660 @@ bool Emulator::insertMemory(int a_location, long long a_contents) {
 	}
 }
 
+/*
+
+NAME:
+
+	decodeMemory - decodes the word at a location and updates the fused instructions around it
+
+SYNOPSIS:
+
+	Emulator::decodeMemory(int a_location);
+	a_location		--> the index in the memory of the word to be decoded
+
+DESCRIPTION:
+
+	Used when a word is loaded and when the run loop fetches a word marked stale. The word
+	is decoded by decodeWord(). A fused instruction starting up to three words earlier may
+	include this word, so it is formed again along with one that may start at the word.
+
+RETURN:
+
+	void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void Emulator::decodeMemory(int a_location) {
+	decodeWord(a_location);
+	for (int head = (a_location > 3 ? a_location - 3 : 0); head <= a_location; head++) {
+		fuseInstructions(head);
+	}
+}
+
+/*
+
+NAME:
+
+	decodeWord - splits the word at a location into its op code, registers and address
+
+SYNOPSIS:
+
+	Emulator::decodeWord(int a_location);
+	a_location		--> the index in the memory of the word to be decoded
+
+DESCRIPTION:
+
+	The word is split with the same divisions that the VC8000 instruction format defines, and the
+	result is stored in m_decoded so that the run loop never has to divide. Zero words are recorded
+	as OP_EMPTY, and words whose op code is not 1 - 17 are recorded as OP_ILLEGAL. A BM, BZ
+	or BP back to a location close before it closes a loop, and is recorded as OP_LOOP_BM,
+	OP_LOOP_BZ or OP_LOOP_BP so that the engines try to fast forward the loop.
+
+RETURN:
+
+	void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void Emulator::decodeWord(int a_location) {
+	MemoryWord contents = m_memory.get(a_location);
+	DecodedInstruction& decoded = m_decoded.getWritable(a_location);
+
+	long long OpCode = contents / 10'000'000;
+	if (contents == 0) {
+		decoded.m_opCode = OP_EMPTY;
+	}
+	else if (OpCode < 1 || OpCode > 17) {
+		decoded.m_opCode = OP_ILLEGAL;
+	}
+	else if (OpCode >= 14 && OpCode <= 16 && contents % 1'000'000 <= a_location &&
+			 a_location - contents % 1'000'000 < MAX_LOOP_WORDS) {
+		decoded.m_opCode = static_cast<unsigned char>(OpCode - 14 + OP_LOOP_BM);
+	}
+	else {
+		decoded.m_opCode = static_cast<unsigned char>(OpCode);
+	}
+	decoded.m_reg1 = static_cast<unsigned char>((contents / 1'000'000) % 10);
+	decoded.m_reg2 = static_cast<unsigned char>((contents / 100'000) % 10);
+	decoded.m_address = static_cast<int>(contents % 1'000'000);
+}
+
+/*
+
+NAME:
+
+	fuseInstructions - records a fused instruction at a location if the words there form one
+
+SYNOPSIS:
+
+	Emulator::fuseInstructions(int a_location);
+	a_location		--> the index in the memory of a LOAD that may start a fused instruction
+
+DESCRIPTION:
+
+	The counting loops that VC8000 programs are made of update a variable in memory with
+	load r,x / add r,y / store r,x or load r,x / sub r,y / store r,x, often followed by
+	bp r,L. When the words starting at a_location form one of these idioms with the same
+	register and the same x, the LOAD is recorded as a fused instruction so that the run
+	loop executes the whole idiom with one dispatch. An idiom whose x or y lies inside the
+	idiom itself is not fused, since storing into it would change the words being fused.
+	Idioms that cross the end of a page of memory are not fused either, since the engines
+	step from the head to the other words within its page.
+	A LOAD that no longer starts an idiom is turned back into a plain LOAD. Each word
+	belongs to at most one idiom, and decodeMemory() forms it again whenever one of its
+	words is decoded, so a fused instruction whose words are not stale is always current.
+
+RETURN:
+
+	void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void Emulator::fuseInstructions(int a_location) {
+	if (m_decoded.get(a_location).m_opCode != 5 && !isFused(m_decoded.get(a_location).m_opCode)) {
+		return;
+	}
+	DecodedInstruction& head = m_decoded.getWritable(a_location);
+	head.m_opCode = 5;
+
+	// The engines read the words of a fused instruction through the page of its head, so
+	// an idiom must not cross into the next page.
+	int pageEnd = (a_location / DECODED_PAGE + 1) * DECODED_PAGE;
+	if (a_location + 2 >= MEMSZ || a_location + 2 >= pageEnd) {
+		return;
+	}
+
+	// The words of the idiom must be decoded to be compared.
+	int last = (a_location + 3 < MEMSZ && a_location + 3 < pageEnd ? a_location + 3 : a_location + 2);
+	for (int loc = a_location + 1; loc <= last; loc++) {
+		if (m_decoded.get(loc).m_opCode == OP_STALE) {
+			decodeWord(loc);
+		}
+	}
+	const DecodedInstruction& alu = m_decoded.get(a_location + 1);
+	const DecodedInstruction& store = m_decoded.get(a_location + 2);
+
+	if ((alu.m_opCode != 1 && alu.m_opCode != 2) || alu.m_reg1 != head.m_reg1) {
+		return;
+	}
+	if (store.m_opCode != 6 || store.m_reg1 != head.m_reg1 || store.m_address != head.m_address) {
+		return;
+	}
+	if ((head.m_address >= a_location && head.m_address <= last) ||
+		(alu.m_address >= a_location && alu.m_address <= last)) {
+		return;
+	}
+	if (alu.m_opCode == 1) {
+		head.m_opCode = OP_LOAD_ADD_STORE;
+		return;
+	}
+	head.m_opCode = OP_LOAD_SUB_STORE;
+
+	if (last == a_location + 3) {
+		const DecodedInstruction& branch = m_decoded.get(a_location + 3);
+		if ((branch.m_opCode == 16 || branch.m_opCode == OP_LOOP_BP) && branch.m_reg1 == head.m_reg1) {
+			head.m_opCode = OP_LOAD_SUB_STORE_BP;
+		}
+	}
+}
+
+/*
+
+NAME:
+
+	findNextInstruction - finds the next non-zero word in memory
+
+SYNOPSIS:
+
+	Emulator::findNextInstruction(int a_location) const;
+	a_location		--> the location where the search starts
+
+DESCRIPTION:
+
+	Execution falls through zero words until it reaches the next non-zero one. Rather than
+	walking through every empty word, only the rest of the current group of GROUP_WORDS words
+	is searched, and then the index is used to jump straight to the next group that has ever
+	held a non-zero word. A group whose words were all overwritten with zero stays in the index,
+	so its words are searched and it is passed over. The words are searched by ZeroScanner,
+	which checks several words at a time with the vector instructions of the processor.
+
+RETURN:
+
+	int - the location of the first non-zero word at or after a_location, or MEMSZ if there is none
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+int Emulator::findNextInstruction(int a_location) const {
+	int loc = a_location;
+	int group = a_location / GROUP_WORDS;
+	while (group < NUM_GROUPS) {
+		int end = (group + 1) * GROUP_WORDS;
+		if (end > MEMSZ) {
+			end = MEMSZ;
+		}
+		// groups never cross pages, so the words can be scanned within the group's page
+		int page = loc / MEMORY_PAGE;
+		if (m_memory.isAllocated(page)) {
+			int base = page * MEMORY_PAGE;
+			loc = base + ZeroScanner::findNonZero(m_memory.getPage(page), loc - base, end - base);
+			if (loc < end) {
+				return loc;
+			}
+		}
+		group = nextOccupiedGroup(group + 1);
+		loc = group * GROUP_WORDS;
+	}
+	return MEMSZ;
+}
+
+/*
+
+NAME:
+
+	nextOccupiedGroup - finds the next group of words in the index that may be non-zero
+
+SYNOPSIS:
+
+	Emulator::nextOccupiedGroup(int a_group) const;
+	a_group		--> the group where the search starts
+
+DESCRIPTION:
+
+	Each bit of m_groupIndex stands for a group of words, and each bit of m_summaryIndex for
+	64 bits of m_groupIndex. The rest of the word of m_groupIndex holding a_group is checked
+	first, and if it is empty the summary gives the next word of m_groupIndex with a bit set,
+	so the search takes the same few steps however much empty memory it passes over.
+
+RETURN:
+
+	int - the first group at or after a_group with its bit set, or NUM_GROUPS if there is none
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+int Emulator::nextOccupiedGroup(int a_group) const {
+	if (a_group >= NUM_GROUPS) {
+		return NUM_GROUPS;
+	}
+	int word = a_group / 64;
+	unsigned long long bits = m_groupIndex[word] & (~0ULL << (a_group % 64));
+	if (bits == 0) {
+		// look up the next word of the group index with a bit set in the summary
+		word++;
+		if (word >= static_cast<int>(m_groupIndex.size())) {
+			return NUM_GROUPS;
+		}
+		int summary = word / 64;
+		unsigned long long summaryBits = m_summaryIndex[summary] & (~0ULL << (word % 64));
+		while (summaryBits == 0) {
+			if (++summary >= static_cast<int>(m_summaryIndex.size())) {
+				return NUM_GROUPS;
+			}
+			summaryBits = m_summaryIndex[summary];
+		}
+		word = summary * 64 + lowestSetBit(summaryBits);
+		bits = m_groupIndex[word];
+	}
+	return word * 64 + lowestSetBit(bits);
+}
+
+/*
+
+NAME:
+
+	lowestSetBit - finds the lowest bit that is set in a value
+
+SYNOPSIS:
+
+	Emulator::lowestSetBit(unsigned long long a_bits);
+	a_bits		--> a non-zero value
+
+DESCRIPTION:
+
+	Uses the bit scan instruction of the processor through the compiler's intrinsic.
+
+RETURN:
+
+	int - the index of the lowest set bit, from 0 to 63
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+int Emulator::lowestSetBit(unsigned long long a_bits) {
+#if defined(__GNUC__)
+	return __builtin_ctzll(a_bits);
+#else
+	// _BitScanForward64 is not available on 32 bit builds, so scan each half
+	unsigned long index = 0;
+	if (_BitScanForward(&index, static_cast<unsigned long>(a_bits))) {
+		return static_cast<int>(index);
+	}
+	_BitScanForward(&index, static_cast<unsigned long>(a_bits >> 32));
+	return static_cast<int>(index) + 32;
+#endif
+}
+
+/*
+NAME:
+
+	runProgram() - reads and executes machine language instruction encoded in a specfic format
+					within an Emulator's memory. 
+
+SYNOPSIS:
+
+	Emulator::runProgram();
+
+DESCRIPTION:
+
+    The runProgram() function executes machine language instructions
+    stored in memory, starting at the entry point recorded by the assembler and following
+    the program counter through each instruction, performing arithmetic,
+    load/store, branch, input/output, and control flow operations based on OpCode values.
+    The fields of each word come from the table predecoded by insertMemory; words that the
+    program overwrites with STORE or READ are marked stale and decoded again when fetched.
+    The instructions are executed by the engine chosen with setEngine(). Both engines
+    behave identically; they only differ in how they dispatch to the next instruction.
+    It manages program execution, updates the Emulator's state, and handles errors,
+    returning true only if the program paused. If pauseAfterReads() was called,
+    the program stops after that many READs and can be continued with resumeProgram().
+
+
+OPERATIONS:
+
+	Arithmetic Operations, Load/Store Operations, Brach Operations, Input/Output Operations,
+	Control Flow
+
+RETURN:
+
+	bool - returns true if the program paused, false when it halts or stops with an error;
+	       getTermination() tells why it stopped
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+bool Emulator::runProgram() {
+
+    m_output->writeText("\nRunning the Emulator, Ritika's version\n");
+
+    return startProgram();
+}
+
+/*
+NAME:
+
+	resumeProgram() - continues running a paused program
+
+SYNOPSIS:
+
+	Emulator::resumeProgram();
+
+DESCRIPTION:
+
+    Runs the program from the instruction after the READ it paused at, or from the
+    breakpoint it paused at, with the registers and memory it had then, or those of the
+    snapshot most recently restored. The program pauses again if pauseAfterReads() has been
+    called since, or at the next breakpoint it reaches.
+
+RETURN:
+
+	bool - returns false if the program was not paused, otherwise as runProgram()
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+bool Emulator::resumeProgram() {
+    if (!isPaused()) {
+        return false;
+    }
+    return runFrom(m_resumeLocation, true);
+}
+
+/*
+NAME:
+
+	runFrom() - runs the program from a location with the selected engine
+
+SYNOPSIS:
+
+	Emulator::runFrom(int a_location, bool a_isResuming);
+	a_location		--> the location of the first instruction to execute
+	a_isResuming	--> true if the program paused at a_location, or just before it
+
+DESCRIPTION:
+
+    Clears any earlier pause and hands the program to the engine chosen with setEngine(),
+    or, if a debugging feature is in use, to the switch engine built with the debugging
+    policies, or, if it has a time slice, to the switch engine built to count instructions.
+    A program verifyProgram() has verified runs on the switch and threaded engines built
+    without the checks for stores into code, and the words it may have stored into are
+    marked for decoding again once it stops; any other program runs on the checked ones. The
+    program is verified here if it has changed since it last was.
+    A program resuming from a breakpoint executes the instruction there rather than
+    stopping at it again. The run's limits start afresh, and why the run ended is recorded
+    for getTermination().
+
+RETURN:
+
+	bool - returns true if the program paused, false when it halts or hits an error
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+bool Emulator::runFrom(int a_location, bool a_isResuming) {
+    int resumedBreakpoint = (a_isResuming && m_isAtBreakpoint) ? a_location : -1;
+    m_resumeLocation = -1;
+    m_isAtBreakpoint = false;
+    m_isWaitingForInput = false;
+    m_termination = Termination::Halted;
+    if (m_isVerifyPending) {
+        verifyProgram();
+    }
+    bool isUnchecked = m_isVerified && !isDebugging() && (m_quantum > 0 || m_engine != Engine::Jit);
+    startBudget();
+    if (m_telemetry) {
+        m_telemetry->getStats().m_isRunning.store(1, memory_order_relaxed);
+    }
+    bool isPaused = false;
+    try {
+        if (isDebugging()) {
+            isPaused = runSwitch<TraceAndProfile, BoundsCheck, Breakpoints, CheckedCode>(a_location, resumedBreakpoint);
+        }
+        else if (m_quantum > 0) {
+            isPaused = isUnchecked ? runSwitch<NoTrace, NoCheck, Timeslice, VerifiedCode>(a_location, -1)
+                                   : runSwitch<NoTrace, NoCheck, Timeslice, CheckedCode>(a_location, -1);
+        }
+        else if (m_engine == Engine::Threaded) {
+            isPaused = isUnchecked ? runThreaded<VerifiedCode>(a_location) : runThreaded<CheckedCode>(a_location);
+        }
+        else if (m_engine == Engine::Jit) {
+            isPaused = runJit(a_location);
+        }
+        else {
+            isPaused = isUnchecked ? runSwitch<NoTrace, NoCheck, NoBreak, VerifiedCode>(a_location, -1)
+                                   : runSwitch<NoTrace, NoCheck, NoBreak, CheckedCode>(a_location, -1);
+        }
+    }
+    catch (...) {
+        m_output->writeText("Error! Invalid OpCode!");
+        m_termination = Termination::InvalidOpCode;
+    }
+    if (isUnchecked) {
+        for (int loc : m_storeTargets) {
+            invalidateDecoded(loc);
+        }
+    }
+    if (isPaused && m_termination == Termination::Halted) {
+        m_termination = Termination::Paused;
+    }
+    if (m_telemetry) {
+        publishCounters(m_resumeLocation);
+        m_telemetry->getStats().m_isRunning.store(0, memory_order_relaxed);
+    }
+    // Buffered output reaches its destination by the time the program halts or pauses.
+    m_output->flush();
+    return isPaused;
+}
+
+/*
+NAME:
+
+	startBudget(), grantBudget(), renewBudget() - count a run's instructions towards its limits
+
+SYNOPSIS:
+
+	Emulator::startBudget();
+	Emulator::grantBudget();
+	Emulator::renewBudget(int a_location);
+	a_location	--> the location the run continues from
+
+DESCRIPTION:
+
+    The engines take the instructions they execute from m_budget a block at a time and call
+    renewBudget() once it is below zero, so the limits cost one subtraction and test per
+    block. The budget granted is what is left of the instruction limit, but no more than
+    CHECK_INTERVAL if there is a time limit, so that the clock is looked at every
+    CHECK_INTERVAL instructions, and no more than the pages left under the memory limit,
+    since no instruction writes more than one page. An emulator that publishes telemetry is
+    also granted no more than CHECK_INTERVAL, and publishes its counters each time the budget
+    is renewed. Without limits or telemetry the budget is never used up.
+
+RETURN:
+
+	renewBudget(): bool - returns true if the run may continue, false if it reached a limit,
+	which is recorded for getTermination()
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void Emulator::startBudget() {
+    m_executed = 0;
+    m_published = 0;
+    if (m_limits.m_maxMilliseconds > 0) {
+        m_deadline = chrono::steady_clock::now() + chrono::milliseconds(m_limits.m_maxMilliseconds);
+    }
+    grantBudget();
+}
+
+void Emulator::grantBudget() {
+    // half the range leaves room for the blocks counted past the end of a budget
+    long long budget = LLONG_MAX / 2;
+    if (m_limits.m_maxMilliseconds > 0 || m_telemetry) {
+        budget = CHECK_INTERVAL;
+    }
+    if (m_limits.m_maxInstructions > 0 && m_limits.m_maxInstructions - m_executed < budget) {
+        budget = m_limits.m_maxInstructions - m_executed;
+    }
+    // an instruction writes at most one new page, so the pages left bound the instructions
+    if (m_limits.m_maxPages > 0 && m_limits.m_maxPages - m_memory.getDirtyPages() < budget) {
+        budget = m_limits.m_maxPages - m_memory.getDirtyPages();
+    }
+    m_budget = m_granted = budget;
+}
+
+bool Emulator::renewBudget(int a_location) {
+    m_executed += m_granted - m_budget;
+    m_granted = m_budget;
+    publishCounters(a_location);
+    if (m_limits.m_maxInstructions > 0 && m_executed >= m_limits.m_maxInstructions) {
+        m_termination = Termination::InstructionLimit;
+        return false;
+    }
+    if (m_limits.m_maxMilliseconds > 0 && chrono::steady_clock::now() >= m_deadline) {
+        m_termination = Termination::TimeLimit;
+        return false;
+    }
+    if (m_limits.m_maxPages > 0 && m_memory.getDirtyPages() > m_limits.m_maxPages) {
+        m_termination = Termination::MemoryLimit;
+        return false;
+    }
+    grantBudget();
+    return true;
+}
+
+namespace {
+    const int MAX_LOOP_VARIABLES = 16;  // The most registers and words a loop may change and be fast forwarded.
+
+    // A value an iteration of a loop computes, as a constant plus a multiple of each of the
+    // loop's variables as the iteration starts.  The arithmetic is modulo 2^64, which is how
+    // full words wrap.
+    struct LoopForm {
+        unsigned long long m_constant = 0;
+        unsigned long long m_coefficients[MAX_LOOP_VARIABLES] = { 0 };
+    };
+
+    // A word of the body of a loop, split into its fields.
+    struct LoopStep {
+        int m_opCode;
+        int m_reg1;
+        int m_reg2;
+        int m_address;
+    };
+
+    // A register or word of memory that a loop changes.
+    struct LoopVariable {
+        bool m_isRegister;
+        int m_index;        // The register, or the location of the word.
+    };
+
+    LoopForm constantForm(MemoryWord a_value)
+    {
+        LoopForm form;
+        form.m_constant = static_cast<unsigned long long>(a_value);
+        return form;
+    }
+
+    LoopForm variableForm(int a_variable)
+    {
+        LoopForm form;
+        form.m_coefficients[a_variable] = 1;
+        return form;
+    }
+
+    // Returns a_left + a_sign * a_right, with a_sign 1 or -1.
+    LoopForm addForms(const LoopForm& a_left, const LoopForm& a_right, unsigned long long a_sign, int a_variables)
+    {
+        LoopForm sum;
+        sum.m_constant = a_left.m_constant + a_sign * a_right.m_constant;
+        for (int var = 0; var < a_variables; var++) {
+            sum.m_coefficients[var] = a_left.m_coefficients[var] + a_sign * a_right.m_coefficients[var];
+        }
+        return sum;
+    }
+
+    bool isConstant(const LoopForm& a_form, int a_variables)
+    {
+        for (int var = 0; var < a_variables; var++) {
+            if (a_form.m_coefficients[var] != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Multiplies two forms, one of which must be a constant for the product to be a form.
+    bool multiplyForms(const LoopForm& a_left, const LoopForm& a_right, int a_variables, LoopForm& a_product)
+    {
+        if (!isConstant(a_left, a_variables) && !isConstant(a_right, a_variables)) {
+            return false;
+        }
+        const LoopForm& factor = isConstant(a_right, a_variables) ? a_right : a_left;
+        const LoopForm& form = isConstant(a_right, a_variables) ? a_left : a_right;
+        a_product.m_constant = form.m_constant * factor.m_constant;
+        for (int var = 0; var < a_variables; var++) {
+            a_product.m_coefficients[var] = form.m_coefficients[var] * factor.m_constant;
+        }
+        return true;
+    }
+
+    unsigned long long evaluateForm(const LoopForm& a_form, const unsigned long long* a_values, int a_variables)
+    {
+        unsigned long long value = a_form.m_constant;
+        for (int var = 0; var < a_variables; var++) {
+            value += a_form.m_coefficients[var] * a_values[var];
+        }
+        return value;
+    }
+
+    // Checks whether a form grows by the same step every iteration, given the forms a_next of
+    // each variable at the end of an iteration.  It does if the iteration leaves the sum of
+    // its variables' multiples unchanged; the step is then what the iteration adds to it.
+    bool isArithmetic(const LoopForm& a_form, const LoopForm* a_next, int a_variables, unsigned long long& a_step)
+    {
+        a_step = 0;
+        for (int var = 0; var < a_variables; var++) {
+            unsigned long long coefficient = 0;
+            for (int from = 0; from < a_variables; from++) {
+                coefficient += a_form.m_coefficients[from] * a_next[from].m_coefficients[var];
+            }
+            if (coefficient != a_form.m_coefficients[var]) {
+                return false;
+            }
+            a_step += a_form.m_coefficients[var] * a_next[var].m_constant;
+        }
+        return true;
+    }
+
+    // Returns how many times in a row a BM, BZ or BP is taken when the value it tests goes
+    // a_first, a_first + a_step ... wrapping as full words do, or ULLONG_MAX if for ever.
+    unsigned long long countTaken(int a_opCode, long long a_first, unsigned long long a_step)
+    {
+        long long step = static_cast<long long>(a_step);
+        unsigned long long magnitude = (step < 0 ? 0 - a_step : a_step);
+        if (a_opCode == 14) {
+            if (a_first >= 0) {
+                return 0;
+            }
+            if (step == 0) {
+                return ULLONG_MAX;
+            }
+            // up to -1, or down past the most negative word
+            unsigned long long room = (step > 0 ? static_cast<unsigned long long>(-1 - a_first)
+                                                : static_cast<unsigned long long>(a_first) - static_cast<unsigned long long>(LLONG_MIN));
+            return room / magnitude + 1;
+        }
+        if (a_opCode == 15) {
+            if (a_first != 0) {
+                return 0;
+            }
+            return (step == 0 ? ULLONG_MAX : 1);
+        }
+        if (a_first <= 0) {
+            return 0;
+        }
+        if (step == 0) {
+            return ULLONG_MAX;
+        }
+        // down to 1, or up past the most positive word
+        unsigned long long room = (step < 0 ? static_cast<unsigned long long>(a_first - 1)
+                                            : static_cast<unsigned long long>(LLONG_MAX - a_first));
+        return room / magnitude + 1;
+    }
+
+#if VC8000_COMPACT_WORDS
+    // Returns how many iterations in a row a value going a_first, a_first + a_step ... fits
+    // in a compact word.
+    long long countInRange(long long a_first, unsigned long long a_step)
+    {
+        if (a_first < INT_MIN || a_first > INT_MAX) {
+            return 0;
+        }
+        long long step = static_cast<long long>(a_step);
+        if (step == 0) {
+            return LLONG_MAX;
+        }
+        if (step > UINT_MAX || step < -static_cast<long long>(UINT_MAX)) {
+            return 1;
+        }
+        return (step > 0 ? (INT_MAX - a_first) / step : (a_first - INT_MIN) / -step) + 1;
+    }
+#endif
+
+    // Takes the values of the variables through a_iterations iterations, each of which sets
+    // variable i to a_next[i].  The iteration is a matrix, with a row for the constant, that
+    // is squared once for each bit of a_iterations.
+    void iterateForms(const LoopForm* a_next, int a_variables, long long a_iterations, unsigned long long* a_values)
+    {
+        const int SIZE = MAX_LOOP_VARIABLES + 1;
+        int size = a_variables + 1;
+        unsigned long long power[SIZE][SIZE] = { { 0 } };
+        for (int row = 0; row < a_variables; row++) {
+            for (int col = 0; col < a_variables; col++) {
+                power[row][col] = a_next[row].m_coefficients[col];
+            }
+            power[row][a_variables] = a_next[row].m_constant;
+        }
+        power[a_variables][a_variables] = 1;
+
+        unsigned long long values[SIZE];
+        copy(a_values, a_values + a_variables, values);
+        values[a_variables] = 1;
+        while (a_iterations > 0) {
+            if ((a_iterations & 1) != 0) {
+                unsigned long long product[SIZE] = { 0 };
+                for (int row = 0; row < size; row++) {
+                    for (int col = 0; col < size; col++) {
+                        product[row] += power[row][col] * values[col];
+                    }
+                }
+                copy(product, product + size, values);
+            }
+            a_iterations >>= 1;
+            if (a_iterations > 0) {
+                unsigned long long square[SIZE][SIZE] = { { 0 } };
+                for (int row = 0; row < size; row++) {
+                    for (int mid = 0; mid < size; mid++) {
+                        if (power[row][mid] == 0) {
+                            continue;
+                        }
+                        for (int col = 0; col < size; col++) {
+                            square[row][col] += power[row][mid] * power[mid][col];
+                        }
+                    }
+                }
+                copy(&square[0][0], &square[0][0] + SIZE * SIZE, &power[0][0]);
+            }
+        }
+        copy(values, values + a_variables, a_values);
+    }
+}
+
+/*
+NAME:
+
+	fastForwardLoop() - runs many iterations of a counted loop at once
+
+SYNOPSIS:
+
+	void Emulator::fastForwardLoop(int a_branch, int a_blockStart);
+	a_branch		--> the location of the BM, BZ or BP closing the loop, whose branch was just taken
+	a_blockStart	--> where the block ending at the branch began
+
+DESCRIPTION:
+
+    A loop is fast forwarded when its body, from the target of the branch up to the branch,
+    is straight line code of ADD, SUB, MULT, LOAD, STORE, ADDR, SUBR and MULTR, does not store
+    into itself, and multiplies only by values it does not change. An iteration then sets
+    each register and word the loop changes to a constant plus multiples of their values as
+    it started, which is worked out once by running the body on such forms. If the register
+    the branch tests goes up or down by the same step every iteration, the number of
+    iterations before the branch falls through follows from its next value, and all but the
+    ones the budget cannot cover are run at once by raising the iteration to that power.
+    Since the forms are taken modulo 2^64, full words wrap just as they do when the loop is
+    stepped. Compact words stop the program on overflow instead, so there every result the
+    body computes must also go up or down by the same step, and the iterations are cut short
+    before any of them leaves the range of a word.
+    A loop that can never be fast forwarded has its branch made a plain one, until the word
+    is decoded again. One that is too close to its end is tried less and less often.
+
+RETURN:
+
+	void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void Emulator::fastForwardLoop(int a_branch, int a_blockStart) {
+    m_loopCountdown = m_loopRetry;
+    const DecodedInstruction& branch = m_decoded.get(a_branch);
+    int opCode = plainBranch(branch.m_opCode);
+    int head = branch.m_address;
+    int branchReg = branch.m_reg1;
+
+    // the body is split into its fields, and the registers and words it changes are found
+    LoopStep steps[MAX_LOOP_WORDS];
+    int stepCount = 0;
+    LoopVariable variables[MAX_LOOP_VARIABLES];
+    int variableCount = 0;
+    bool isCounted = true;
+    for (int loc = head; loc < a_branch && isCounted; loc++) {
+        MemoryWord word = m_memory.get(loc);
+        if (word == 0) {
+            continue;
+        }
+        LoopStep step = { static_cast<int>(word / 10'000'000), static_cast<int>(word / 1'000'000 % 10),
+                          static_cast<int>(word / 100'000 % 10), static_cast<int>(word % 1'000'000) };
+        LoopVariable changed = { true, step.m_reg1 };
+        switch (word < 0 ? 0 : step.m_opCode) {
+        case 1: case 2: case 3: case 5: case 7: case 8: case 9:
+            break;
+        case 6:
+            changed = { false, step.m_address };
+            isCounted = step.m_address < head || step.m_address > a_branch;
+            break;
+        default:
+            isCounted = false;
+            break;
+        }
+        steps[stepCount++] = step;
+        int var = 0;
+        while (var < variableCount && (variables[var].m_isRegister != changed.m_isRegister || variables[var].m_index != changed.m_index)) {
+            var++;
+        }
+        if (var == variableCount) {
+            isCounted = isCounted && variableCount < MAX_LOOP_VARIABLES;
+            if (isCounted) {
+                variables[variableCount++] = changed;
+            }
+        }
+    }
+
+    // the body is run once on forms: the variables start as themselves, and the registers
+    // and words the loop leaves alone as their values
+    LoopForm regs[10];
+    LoopForm next[MAX_LOOP_VARIABLES];
+    int regVariable[10];
+    fill(regVariable, regVariable + 10, -1);
+    for (int var = 0; var < variableCount; var++) {
+        next[var] = variableForm(var);
+        if (variables[var].m_isRegister) {
+            regVariable[variables[var].m_index] = var;
+        }
+    }
+    for (int reg = 0; reg < 10; reg++) {
+        regs[reg] = (regVariable[reg] >= 0 ? variableForm(regVariable[reg]) : constantForm(m_reg[reg]));
+    }
+#if VC8000_COMPACT_WORDS
+    LoopForm results[MAX_LOOP_WORDS];
+    int resultCount = 0;
+#endif
+    for (int index = 0; index < stepCount && isCounted; index++) {
+        const LoopStep& step = steps[index];
+        LoopForm& reg = regs[step.m_reg1];
+        LoopForm operand = regs[step.m_reg2];
+        if (step.m_opCode <= 6) {
+            int var = 0;
+            while (var < variableCount && (variables[var].m_isRegister || variables[var].m_index != step.m_address)) {
+                var++;
+            }
+            operand = (var < variableCount ? next[var] : constantForm(m_memory.get(step.m_address)));
+            if (step.m_opCode == 6) {
+                next[var] = reg;
+                continue;
+            }
+        }
+        switch (step.m_opCode) {
+        case 1: case 7:
+            reg = addForms(reg, operand, 1, variableCount);
+            break;
+        case 2: case 8:
+            reg = addForms(reg, operand, 0 - 1ULL, variableCount);
+            break;
+        case 3: case 9:
+            isCounted = multiplyForms(reg, operand, variableCount, reg);
+            break;
+        case 5:
+            reg = operand;
+            continue;
+        }
+#if VC8000_COMPACT_WORDS
+        results[resultCount++] = reg;
+#endif
+    }
+    for (int var = 0; var < variableCount; var++) {
+        if (variables[var].m_isRegister) {
+            next[var] = regs[variables[var].m_index];
+        }
+    }
+
+    // the register the branch tests must go up or down by the same step every iteration
+    unsigned long long step = 0;
+    isCounted = isCounted && isArithmetic(regs[branchReg], next, variableCount, step);
+#if VC8000_COMPACT_WORDS
+    unsigned long long resultSteps[MAX_LOOP_WORDS];
+    for (int index = 0; index < resultCount && isCounted; index++) {
+        isCounted = isArithmetic(results[index], next, variableCount, resultSteps[index]);
+    }
+#endif
+    if (!isCounted) {
+        m_decoded.getWritable(a_branch).m_opCode = static_cast<unsigned char>(opCode);
+        return;
+    }
+
+    unsigned long long values[MAX_LOOP_VARIABLES];
+    for (int var = 0; var < variableCount; var++) {
+        values[var] = static_cast<unsigned long long>(variables[var].m_isRegister ? m_reg[variables[var].m_index]
+                                                                                  : m_memory.get(variables[var].m_index));
+    }
+
+    // the iterations skipped are all taken, and leave the budget room for the block the
+    // branch ends
+    long long length = 1 + stepCount;
+    long long iterations = (m_budget - (a_branch - a_blockStart + 1)) / length;
+    unsigned long long taken = countTaken(opCode, static_cast<long long>(evaluateForm(regs[branchReg], values, variableCount)), step);
+    if (iterations > 0 && taken < static_cast<unsigned long long>(iterations)) {
+        iterations = static_cast<long long>(taken);
+    }
+#if VC8000_COMPACT_WORDS
+    for (int index = 0; index < resultCount; index++) {
+        long long inRange = countInRange(static_cast<long long>(evaluateForm(results[index], values, variableCount)), resultSteps[index]);
+        if (inRange < iterations) {
+            iterations = inRange;
+        }
+    }
+#endif
+    if (iterations < MIN_LOOP_SKIP) {
+        if (m_loopRetry < MAX_LOOP_RETRY) {
+            m_loopRetry *= 2;
+        }
+        m_loopCountdown = m_loopRetry;
+        return;
+    }
+
+    iterateForms(next, variableCount, iterations, values);
+    for (int var = 0; var < variableCount; var++) {
+        MemoryWord value = static_cast<MemoryWord>(static_cast<long long>(values[var]));
+        if (variables[var].m_isRegister) {
+            m_reg[variables[var].m_index] = value;
+        }
+        else {
+            setMemory(variables[var].m_index, value);
+            invalidateDecoded(variables[var].m_index);
+        }
+    }
+    m_budget -= iterations * length;
+    m_loopRetry = m_loopCountdown = LOOP_RETRY;
+}
+
+/*
+NAME:
+
+	publishTelemetry() - publishes counters of the runs in a shared memory segment
+
+SYNOPSIS:
+
+	bool Emulator::publishTelemetry(const string& a_name);
+	a_name		--> the name of the segment, which a reader attaches to
+
+DESCRIPTION:
+
+    The segment is created at once, so a reader can attach before the first run. It is
+    removed when the emulator is destroyed or publishes to another segment.
+
+RETURN:
+
+	bool - returns true if the segment was created, false otherwise, in which case
+	nothing is published
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+bool Emulator::publishTelemetry(const string& a_name) {
+    m_telemetry.reset(new TelemetrySegment(a_name, true));
+    if (!m_telemetry->isOpen()) {
+        m_telemetry.reset();
+        return false;
+    }
+    return true;
+}
+
+/*
+NAME:
+
+	publishCounters() - publishes the counters of the run so far
+
+SYNOPSIS:
+
+	void Emulator::publishCounters(int a_location);
+	a_location	--> where the run is, or -1 if it has halted
+
+DESCRIPTION:
+
+    The engines count the instructions a block at a time, so only the instructions executed
+    since the counters were last published are known, not which ones they were. The op code
+    histogram is therefore sampled, as a sampling profiler charges an interval to where it
+    finds the program: they are shared among the op codes of the block of instructions that
+    starts at a_location, up to its branch, as though that block had been executed throughout
+    the interval. Each counter is stored with a relaxed atomic store; the emulator is the segment's only
+    writer, so it need not add atomically.
+
+RETURN:
+
+	void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void Emulator::publishCounters(int a_location) {
+    if (!m_telemetry) {
+        return;
+    }
+    TelemetryStats& stats = m_telemetry->getStats();
+    long long executed = getInstructionsExecuted() - m_published;
+    m_published += executed;
+
+    // the op codes of the block at a_location, or 0 for a word that is not an instruction
+    const int MAX_BLOCK = 64;
+    int block[MAX_BLOCK];
+    int length = 0;
+    for (int loc = a_location; loc >= 0 && loc < MEMSZ && length < MAX_BLOCK; loc++) {
+        MemoryWord word = m_memory.get(loc);
+        if (word == 0) {
+            continue;
+        }
+        int opCode = (word > 0 && word / 10'000'000 < TelemetryStats::OP_CODES) ? static_cast<int>(word / 10'000'000) : 0;
+        block[length++] = opCode;
+        if (opCode == 0 || opCode >= 13) {
+            break;
+        }
+    }
+    if (length == 0) {
+        block[length++] = 0;
+    }
+    for (int i = 0; i < length; i++) {
+        long long share = executed / length + (i < executed % length ? 1 : 0);
+        atomic<long long>& sample = stats.m_opCodes[block[i]];
+        sample.store(sample.load(memory_order_relaxed) + share, memory_order_relaxed);
+    }
+    stats.m_instructions.store(stats.m_instructions.load(memory_order_relaxed) + executed, memory_order_relaxed);
+    stats.m_writes.store(m_writeCount, memory_order_relaxed);
+    stats.m_readWaits.store(m_readWaitCount, memory_order_relaxed);
+    stats.m_location.store(a_location, memory_order_relaxed);
+    stats.m_updates.store(stats.m_updates.load(memory_order_relaxed) + 1, memory_order_relaxed);
+}
+
+/*
+NAME:
+
+	setEngine() - selects the engine that runProgram uses to execute instructions
+
+SYNOPSIS:
+
+	Emulator::setEngine(Engine a_engine);
+	a_engine		--> Engine::Switch, Engine::Threaded or Engine::Jit
+
+DESCRIPTION:
+
+    Engine::Switch dispatches every instruction through one switch statement. Engine::Threaded
+    jumps from the end of each instruction handler directly to the handler of the next one, which
+    gives the branch predictor one indirect jump per handler instead of one for the whole loop.
+    The threaded engine needs the labels-as-values extension of g++ and clang, so it is not
+    available when built with Visual C++. Engine::Jit translates basic blocks into x86-64
+    machine code and is only available on x86-64 hosts.
+
+RETURN:
+
+	bool - returns true if the engine is available in this build, false otherwise, in which
+	case the current engine is left unchanged
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+bool Emulator::setEngine(Engine a_engine) {
+    if (!isEngineAvailable(a_engine)) {
+        return false;
+    }
+    m_engine = a_engine;
+    return true;
+}
+
+/*
+NAME:
+
+	takeSnapshot() - captures the state of the emulator
+
+SYNOPSIS:
+
+	Emulator::takeSnapshot();
+
+DESCRIPTION:
+
+    Records memory, its predecoded copy, the index of empty memory, the registers, the
+    entry point and the location a paused program resumes from. The pages of memory are
+    not copied; they are shared with the snapshot and copied by whichever side next writes
+    them, so a snapshot costs the pages written since the last one plus the page tables.
+    The JIT's translations point into the pages they use and are discarded, so that they
+    cannot write into a page the snapshot shares.
+
+RETURN:
+
+	Snapshot - the state, which can be restored any number of times
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+Emulator::Snapshot Emulator::takeSnapshot() {
+    if (m_jit) {
+        m_jit->flush();
+    }
+    if (m_isVerifyPending) {
+        verifyProgram();
+    }
+    Snapshot snapshot;
+    snapshot.m_memory = m_memory.takeSnapshot();
+    snapshot.m_decoded = m_decoded.takeSnapshot();
+    std::copy(m_reg, m_reg + 10, snapshot.m_reg);
+    snapshot.m_entryPoint = m_entryPoint;
+    snapshot.m_resumeLocation = m_resumeLocation;
+    snapshot.m_isAtBreakpoint = m_isAtBreakpoint;
+    snapshot.m_isWaitingForInput = m_isWaitingForInput;
+    snapshot.m_groupIndex = m_groupIndex;
+    snapshot.m_summaryIndex = m_summaryIndex;
+    snapshot.m_isVerified = m_isVerified;
+    snapshot.m_storeTargets = m_storeTargets;
+    return snapshot;
+}
+
+/*
+NAME:
+
+	restoreSnapshot() - returns the emulator to the state in a snapshot
+
+SYNOPSIS:
+
+	Emulator::restoreSnapshot(const Snapshot& a_snapshot);
+	a_snapshot		--> a snapshot taken from this emulator or any other
+
+DESCRIPTION:
+
+    When the snapshot is the one this emulator last took or restored, only the pages
+    written since are put back; any other snapshot replaces the whole page table. The
+    selected engine, the number of READs before a pause, the time slice, the limits, the
+    debugging settings and the input and output devices are kept.
+
+RETURN:
+
+	void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void Emulator::restoreSnapshot(const Snapshot& a_snapshot) {
+    if (m_jit) {
+        // the snapshot's predecoded table matches its memory, so nothing is decoded again
+        m_jit->flush();
+        m_jit->takeFlushedStoreTargets();
+    }
+    m_memory.restore(a_snapshot.m_memory);
+    m_decoded.restore(a_snapshot.m_decoded);
+    std::copy(a_snapshot.m_reg, a_snapshot.m_reg + 10, m_reg);
+    m_entryPoint = a_snapshot.m_entryPoint;
+    m_resumeLocation = a_snapshot.m_resumeLocation;
+    m_isAtBreakpoint = a_snapshot.m_isAtBreakpoint;
+    m_isWaitingForInput = a_snapshot.m_isWaitingForInput;
+    m_groupIndex = a_snapshot.m_groupIndex;
+    m_summaryIndex = a_snapshot.m_summaryIndex;
+    m_isVerifyPending = false;
+    m_isVerified = a_snapshot.m_isVerified;
+    m_storeTargets = a_snapshot.m_storeTargets;
+}
+
+/*
+NAME:
+
+	fork() - creates an emulator in the current state of this one
+
+SYNOPSIS:
+
+	Emulator::fork();
+
+DESCRIPTION:
+
+    The new emulator starts from a snapshot of this one, so the two share every page of
+    memory until one of them writes it. A paused program can be forked, and each copy
+    resumed with different input. The selected engine, READ limit, time slice, run limits,
+    debugging settings and input and output streams are copied.
+
+RETURN:
+
+	unique_ptr<Emulator> - the new emulator
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+unique_ptr<Emulator> Emulator::fork() {
+    unique_ptr<Emulator> child(new Emulator(takeSnapshot()));
+    child->m_engine = m_engine;
+    child->m_readsUntilPause = m_readsUntilPause;
+    child->m_debug = m_debug;
+    child->m_quantum = m_quantum;
+    child->m_limits = m_limits;
+    child->m_input = m_input;
+    child->m_output = m_output;
+    child->m_breakpointCount = m_breakpointCount;
+    return child;
+}
+
+/*
+NAME:
+
+	recordTrace(), replayTrace() - record a trace of the following runs, or replay one
+
+SYNOPSIS:
+
+	Emulator::recordTrace(TraceWriter& a_trace);
+	Emulator::replayTrace(TraceReader& a_trace);
+	a_trace			--> the trace, which must outlive the runs
+
+DESCRIPTION:
+
+    Recording wraps the input device in one that records each number read, so a trace of
+    only the numbers read costs nothing per instruction and the program runs on the selected
+    engine. A trace with instructions needs every instruction, so the runs go through the
+    debugging engine, which records them through the trace policy. Replaying replaces the
+    input device with the numbers of the trace, so the replay needs no console, and checks
+    the instructions through the same policy if the trace has them.
+
+RETURN:
+
+	void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void Emulator::recordTrace(TraceWriter& a_trace) {
+    m_input = make_shared<RecordingInput>(m_input, a_trace);
+    if (a_trace.hasInstructions()) {
+        m_debug.m_recorder = &a_trace;
+    }
+}
+
+void Emulator::replayTrace(TraceReader& a_trace) {
+    m_input = make_shared<ReplayInput>(a_trace);
+    if (a_trace.hasInstructions()) {
+        m_debug.m_replay = &a_trace;
+    }
+}
+
+/*
+NAME:
+
+	setBreakpoint() - sets or clears a breakpoint
+
+SYNOPSIS:
+
+	Emulator::setBreakpoint(int a_location, bool a_isSet);
+	a_location		--> the location of the instruction
+	a_isSet			--> true to set the breakpoint, false to clear it
+
+DESCRIPTION:
+
+    The program pauses before executing an instruction with a breakpoint, and
+    resumeProgram() continues from it. The table of breakpoints is only allocated once the
+    first one is set. Locations outside memory are ignored.
+
+RETURN:
+
+	void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void Emulator::setBreakpoint(int a_location, bool a_isSet) {
+    if (a_location < 0 || a_location >= MEMSZ) {
+        return;
+    }
+    if (m_debug.m_breakpoints.empty()) {
+        if (!a_isSet) {
+            return;
+        }
+        m_debug.m_breakpoints.assign(MEMSZ + 1, 0);
+    }
+    char& breakpoint = m_debug.m_breakpoints[a_location];
+    if (breakpoint != static_cast<char>(a_isSet)) {
+        m_breakpointCount += a_isSet ? 1 : -1;
+        breakpoint = a_isSet;
+    }
+}
+
+/*
+NAME:
+
+	getResidentBytes() - returns the bytes of host memory this emulator has allocated
+
+SYNOPSIS:
+
+	Emulator::getResidentBytes() const;
+
+DESCRIPTION:
+
+    Counts the pages of VC8000 memory and of the predecoded table that have been written,
+    their page tables, the index of empty memory and the JIT compiler's buffers if the JIT
+    engine has been used. Pages that were never written share one zero page, so they are
+    not counted.
+
+RETURN:
+
+	size_t - the number of bytes
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+size_t Emulator::getResidentBytes() const {
+    size_t bytes = sizeof(*this) + m_memory.getResidentBytes() + m_decoded.getResidentBytes();
+    bytes += (m_groupIndex.capacity() + m_summaryIndex.capacity()) * sizeof(unsigned long long);
+    if (m_jit) {
+        bytes += m_jit->getResidentBytes();
+    }
+    return bytes;
+}
+
+/*
+NAME:
+
+	displayMemoryUsage() - displays how much host memory this emulator has allocated
+
+SYNOPSIS:
+
+	Emulator::displayMemoryUsage() const;
+
+DESCRIPTION:
+
+    Shows the pages of VC8000 memory and of the predecoded table in use, the JIT
+    compiler's buffers and the total from getResidentBytes().
+
+RETURN:
+
+	void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void Emulator::displayMemoryUsage() const {
+    int totalPages = (MEMSZ + MEMORY_PAGE - 1) / MEMORY_PAGE;
+    cout << "Memory pages in use: " << m_memory.getAllocatedPages() << " of " << totalPages
+        << " (" << m_memory.getResidentBytes() << " bytes)" << endl;
+    cout << "Predecoded pages in use: " << m_decoded.getAllocatedPages()
+        << " (" << m_decoded.getResidentBytes() << " bytes)" << endl;
+    if (m_jit) {
+        cout << "JIT compiler: " << m_jit->getResidentBytes() << " bytes" << endl;
+    }
+    cout << "Total resident memory: " << getResidentBytes() << " bytes" << endl;
+}
+
+/*
+NAME:
+
+	reportError() - displays an error that stops the program
+
+SYNOPSIS:
+
+	Emulator::reportError(Termination a_reason, const string& a_message);
+	a_reason		--> why the program stopped, for getTermination()
+	a_message		--> the error
+
+DESCRIPTION:
+
+    The output device is flushed first, so that the error follows everything the program
+    wrote before it, and then given the error, which the stream devices write themselves and
+    the others leave to Errors.
+
+RETURN:
+
+	void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void Emulator::reportError(Termination a_reason, const string& a_message) {
+    m_termination = a_reason;
+    m_output->flush();
+    m_output->writeError(a_message);
+}
+
+/*
+NAME:
+
+	trapOverflow() - stops the program at an instruction whose result does not fit in a word
+
+SYNOPSIS:
+
+	Emulator::trapOverflow(int a_location);
+	a_location		--> the location of the ADD, SUB, MULT, ADDR, SUBR or MULTR that overflowed
+
+DESCRIPTION:
+
+    Only happens in a compact build, where words are 32 bits. The register the instruction
+    would have set keeps its old value.
+
+RETURN:
+
+	bool - returns false, so that the engines can return it as their result
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+bool Emulator::trapOverflow(int a_location) {
+    reportError(Termination::Overflow, "Error! Arithmetic overflow at location " + to_string(a_location));
+    return false;
+}
+
+/*
+NAME:
+
+	verifyProgram() - proves that the program in memory never stores into its code
+
+SYNOPSIS:
+
+	ProgramVerifier Emulator::verifyProgram();
+
+DESCRIPTION:
+
+    The program from the entry point is verified by a ProgramVerifier. Until memory is
+    loaded or the entry point moved again, runProgram() runs it on the checked or the
+    unchecked engines according to the verdict, which snapshots carry with them.
+
+RETURN:
+
+	ProgramVerifier - the verdict, with why the program was not verified
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+ProgramVerifier Emulator::verifyProgram() {
+    ProgramVerifier verifier(m_memory, MEMSZ, m_entryPoint);
+    m_isVerifyPending = false;
+    m_isVerified = verifier.isVerified();
+    m_storeTargets = verifier.getStoreTargets();
+    return verifier;
+}
+
 /*
 NAME:
 
-	runProgram() - reads and executes machine language instruction encoded in a specfic format
-					within an Emulator's memory. 
+	trapAddress() - stops the program at an instruction that uses memory out of bounds
 
 SYNOPSIS:
 
-	Emulator::runProgram();
+	Emulator::trapAddress(int a_location, int a_address);
+	a_location		--> the location of the instruction
+	a_address		--> the address it uses
 
 DESCRIPTION:
 
-    The runProgram() function executes machine language instructions
-    stored in memory. It iterates through each instruction, performing arithmetic,
-    load/store, branch, input/output, and control flow operations based on OpCode values.
-    It manages program execution, updates the Emulator's state, and handles errors, 
-    returning true if the program completes successfully.
+    Called by the BoundsCheck policy when an instruction uses memory outside the bounds
+    set with setAddressBounds(). The instruction is not executed.
+
+RETURN:
 
+	bool - returns false, so that the engines can return it as their result
 
-OPERATIONS:
+AUTHOR:
 
-	Arithmetic Operations, Load/Store Operations, Brach Operations, Input/Output Operations,
-	Control Flow
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+bool Emulator::trapAddress(int a_location, int a_address) {
+    reportError(Termination::AddressOutOfBounds, "Error! Address " + to_string(a_address) + " out of bounds at location " +
+        to_string(a_location));
+    return false;
+}
+
+/*
+NAME:
+
+	readInput() - executes READ, reading a number from the user into memory
+
+SYNOPSIS:
+
+	Emulator::readInput(int a_address);
+	a_address		--> the memory location that receives the number
+
+DESCRIPTION:
+
+    A line is read in and the number found there is recorded in the specified memory address.
+    Values that are too large for the VC8000 are reported and not recorded. Every READ
+    counts towards the limit set by pauseAfterReads().
 
 RETURN:
 
-	bool = returns true if successful completion 
+	bool - returns true if the program is to pause after this READ
 
 AUTHOR:
 
@@ -91,127 +1738,858 @@ DATE:
 
 */
 
-bool Emulator::runProgram() {
+bool Emulator::readInput(int a_address) {
+    int userInput = 0;
+    if (m_input->isInteractive()) {
+        m_output->writeText("Enter: \n? ");
+        m_output->flush();
+    }
+    m_input->read(userInput);
+    if (userInput < MEMSZ) {
+        setMemory(a_address, userInput);
+        invalidateDecoded(a_address);
+    }
+    else {
+        m_output->writeText("Too large value\n");
+    }
+    return m_readsUntilPause > 0 && --m_readsUntilPause == 0;
+}
+
+/*
+NAME:
+
+	runSwitch() - executes the program in memory, dispatching with a switch statement
+
+SYNOPSIS:
+
+	template <class Trace, class Check, class Break, class Code>
+	Emulator::runSwitch(int a_start, int a_resumed);
+	a_start		--> the location of the first instruction to execute
+	a_resumed	--> the location of the breakpoint the program is resuming from, or -1
+
+DESCRIPTION:
+
+    Starting at a_start, executes the predecoded instruction at the program counter
+    through one switch statement on its op code. Each instruction sets the location of the
+    next one: a taken branch its address, and every other instruction the word after the
+    ones it used. Empty memory is skipped over with findNextInstruction().
+
+    The policies are told of each instruction before it is executed. With the no-op
+    policies they compile away, leaving the production engine. With any other policy,
+    fused instructions are executed one word at a time so that each word is traced,
+    checked and can be stopped at.
+
+    With the checked code policy, every store marks the word it changes for decoding again
+    and a fused instruction checks that its words are current, so a program may store into
+    its own code. The verified code policy leaves both out, for a program that
+    verifyProgram() proved never does.
+
+    The break policy also counts down the time slice set with setQuantum(), pausing before
+    the first instruction past it. A READ whose input device has no number ready pauses
+    before the READ, so that resuming executes it again.
+
+    The limits set with setLimits() are checked a block at a time: each taken branch takes
+    the instructions since the last one from the budget, and the program pauses at the
+    branch's target if the budget ran out and a limit was reached. Wherever else the run
+    stops, the instructions of the block so far are taken too, with the HALT or the
+    instruction in error, so that every instruction executed is counted.
+
+RETURN:
+
+	bool - returns false when the program halts, runs off the end of memory or hits an illegal op code
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+template <class Trace, class Check, class Break, class Code>
+bool Emulator::runSwitch(int a_start, int a_resumed) {
     // initializing variables that stores opcode, reg1, reg2, and address
     int OpCode = 0;
     int reg1 = 0;
     int reg2 = 0;
     int address = 0;
 
-    cout << endl;
-    cout << "Running the Emulator, Ritika's version" << endl;
+    // instructions left in the time slice, if the run has one
+    long long stepsLeft = m_quantum > 0 ? m_quantum : -1;
 
-    try {
-        // run until the memory ends
-        for (int i = 0; i < MEMSZ; i++) {
-            long long contents = (m_memory[i]);
-            if (contents == 0) {
-                continue;
-            }
+    // run until the memory ends
+    int pc = a_start;
+    int blockStart = a_start;
+    while (pc < MEMSZ) {
+        // the fields were decoded when the word was stored, so no division is needed here
+        const DecodedInstruction& decoded = m_decoded.get(pc);
+        OpCode = decoded.m_opCode;
+        reg1 = decoded.m_reg1;
+        reg2 = decoded.m_reg2;
+        address = decoded.m_address;
+        int next = pc + 1;
 
-            // calculating different values from the content
-            OpCode = static_cast<int>(contents / 10'000'000);
-            reg1 = (contents / 1'000'000) % 10;
-            reg2 = (contents / 100'000) % 10;
-            address = contents % 1'000'000;
+        if (Break::atBreakpoint(m_debug, pc, a_resumed)) {
+            m_isAtBreakpoint = true;
+            settleBudget(blockStart, pc);
+            return pauseAt(pc);
+        }
+        if (Break::isSliceOver(stepsLeft)) {
+            settleBudget(blockStart, pc);
+            return pauseAt(pc);
+        }
+        if (OpCode != OP_EMPTY && OpCode != OP_STALE) {
+            // a fused instruction begins with its load, which the policies see on its own
+            if ((Trace::ENABLED || Check::ENABLED || Break::ENABLED) && isFused(OpCode)) {
+                OpCode = 5;
+            }
+            // and they see every iteration of a loop, so none is fast forwarded
+            else if ((Trace::ENABLED || Check::ENABLED || Break::ENABLED) && isLoopBranch(OpCode)) {
+                OpCode = plainBranch(OpCode);
+            }
+            Trace::instruction(m_debug, pc, OpCode, reg1, reg2, address, m_reg);
+            if (!Check::address(m_debug, OpCode, address)) {
+                settleBudget(blockStart, pc + 1);
+                return trapAddress(pc, address);
+            }
+        }
 
-            switch (OpCode) {
-            case 1:
-                // Reg <-- c(Reg) + c(ADDR) 
-                m_reg[reg1] += m_memory[address];
-                break;
-            case 2:
-                // Reg <-- c(Reg) - c(ADDR)
-                m_reg[reg1] -= m_memory[address];
-                break;
-            case 3:
-                // Reg <-- c(Reg) * c(ADDR)
-                m_reg[reg1] *= m_memory[address];
-                break;
-            case 4:
-                // Reg <-- c(Reg) / c(ADDR)
-                m_reg[reg1] /= m_memory[address];
-                break;
-            case 5:
-                // Reg <-- c(ADDR)
-                m_reg[reg1] = m_memory[address];
-                break;
-            case 6:
-                // ADDR <-- c(Reg)
-                m_memory[address] = m_reg[reg1];
-                break;
-            case 7:
-                // REG1 <--c(REG1) + c(REG2)
-                m_reg[reg1] += m_reg[reg2];
-                break;
-            case 8:
-                // REG1 <--c(REG1) - c(REG2)  
-                m_reg[reg1] -= m_reg[reg2];
+        switch (OpCode) {
+        case OP_EMPTY:
+            // zero words are skipped over, and not counted towards the budget
+            next = findNextInstruction(pc);
+            blockStart += next - pc;
+            break;
+        case OP_STALE:
+            // the word was overwritten by the program, decode it again and retry
+            decodeMemory(pc);
+            next = pc;
+            break;
+        case 1:
+            // Reg <-- c(Reg) + c(ADDR) 
+            if (!addWords(m_reg[reg1], m_memory.get(address), m_reg[reg1])) {
+                settleBudget(blockStart, pc + 1);
+                return trapOverflow(pc);
+            }
+            break;
+        case 2:
+            // Reg <-- c(Reg) - c(ADDR)
+            if (!subtractWords(m_reg[reg1], m_memory.get(address), m_reg[reg1])) {
+                settleBudget(blockStart, pc + 1);
+                return trapOverflow(pc);
+            }
+            break;
+        case 3:
+            // Reg <-- c(Reg) * c(ADDR)
+            if (!multiplyWords(m_reg[reg1], m_memory.get(address), m_reg[reg1])) {
+                settleBudget(blockStart, pc + 1);
+                return trapOverflow(pc);
+            }
+            break;
+        case 4:
+            // Reg <-- c(Reg) / c(ADDR)
+            m_reg[reg1] /= m_memory.get(address);
+            break;
+        case 5:
+            // Reg <-- c(ADDR)
+            m_reg[reg1] = m_memory.get(address);
+            break;
+        case 6:
+            // ADDR <-- c(Reg)
+            setMemory(address, m_reg[reg1]);
+            if (Code::ENABLED) {
+                invalidateDecoded(address);
+            }
+            break;
+        case OP_LOAD_ADD_STORE:
+            // load r,x / add r,y / store r,x
+            if (Code::ENABLED && (m_decoded.get(pc + 1).m_opCode == OP_STALE || m_decoded.get(pc + 2).m_opCode == OP_STALE)) {
+                // one of the words was overwritten, form the instruction again and retry
+                decodeMemory(pc);
+                next = pc;
                 break;
-            case 9:
-                // REG1 <--c(REG1) * c(REG2) 
-                m_reg[reg1] *= m_reg[reg2];
+            }
+            if (!addWords(m_memory.get(address), m_memory.get(m_decoded.get(pc + 1).m_address), m_reg[reg1])) {
+                // the LOAD completed before the instruction that overflowed
+                m_reg[reg1] = m_memory.get(address);
+                settleBudget(blockStart, pc + 2);
+                return trapOverflow(pc + 1);
+            }
+            setMemory(address, m_reg[reg1]);
+            if (Code::ENABLED) {
+                invalidateDecoded(address);
+            }
+            next = pc + 3;
+            break;
+        case OP_LOAD_SUB_STORE:
+            // load r,x / sub r,y / store r,x
+            if (Code::ENABLED && (m_decoded.get(pc + 1).m_opCode == OP_STALE || m_decoded.get(pc + 2).m_opCode == OP_STALE)) {
+                decodeMemory(pc);
+                next = pc;
                 break;
-            case 10:
-                // REG1 <--c(REG1) / c(REG2)  
-                m_reg[reg1] /= m_reg[reg2];
+            }
+            if (!subtractWords(m_memory.get(address), m_memory.get(m_decoded.get(pc + 1).m_address), m_reg[reg1])) {
+                // the LOAD completed before the instruction that overflowed
+                m_reg[reg1] = m_memory.get(address);
+                settleBudget(blockStart, pc + 2);
+                return trapOverflow(pc + 1);
+            }
+            setMemory(address, m_reg[reg1]);
+            if (Code::ENABLED) {
+                invalidateDecoded(address);
+            }
+            next = pc + 3;
+            break;
+        case OP_LOAD_SUB_STORE_BP:
+            // load r,x / sub r,y / store r,x / bp r,L
+            if (Code::ENABLED && (m_decoded.get(pc + 1).m_opCode == OP_STALE || m_decoded.get(pc + 2).m_opCode == OP_STALE ||
+                                  m_decoded.get(pc + 3).m_opCode == OP_STALE)) {
+                decodeMemory(pc);
+                next = pc;
                 break;
-            case 11:
-                // A line is read in and the number found there is recorded
-                // in the specified memory address.
-                cout << "Enter: " << endl;
-                int userInput;
-                cout << "? ";
-                cin >> userInput;
-                if (userInput < MEMSZ) {
-                    m_memory[address] = userInput;
+            }
+            if (!subtractWords(m_memory.get(address), m_memory.get(m_decoded.get(pc + 1).m_address), m_reg[reg1])) {
+                // the LOAD completed before the instruction that overflowed
+                m_reg[reg1] = m_memory.get(address);
+                settleBudget(blockStart, pc + 2);
+                return trapOverflow(pc + 1);
+            }
+            setMemory(address, m_reg[reg1]);
+            if (Code::ENABLED) {
+                invalidateDecoded(address);
+            }
+            next = pc + 4;
+            if (m_reg[reg1] > 0) {
+                next = m_decoded.get(pc + 3).m_address;
+                if (m_decoded.get(pc + 3).m_opCode == OP_LOOP_BP) {
+                    closeLoop(pc + 3, blockStart);
                 }
-                else {
-                    cout << "Too large value" << endl;
+                if (spendBudget(blockStart, pc + 3, next)) {
+                    return pauseAt(next);
                 }
-                break;
-            case 12:
-                // c(ADDR) is displayed  The register value is ignored.
-                cout << m_memory[address] << endl;
-                break;
-            case 13:
-                // go to ADDR for the next instruction.  The register value is ignored.
-                i = address;
-                break;
-            case 14:
-                // go to ADDR if c(Reg) < 0
-                if (m_reg[reg1] < 0) {
-                    i = address - 1;
+            }
+            break;
+        case 7:
+            // REG1 <--c(REG1) + c(REG2)
+            if (!addWords(m_reg[reg1], m_reg[reg2], m_reg[reg1])) {
+                settleBudget(blockStart, pc + 1);
+                return trapOverflow(pc);
+            }
+            break;
+        case 8:
+            // REG1 <--c(REG1) - c(REG2)  
+            if (!subtractWords(m_reg[reg1], m_reg[reg2], m_reg[reg1])) {
+                settleBudget(blockStart, pc + 1);
+                return trapOverflow(pc);
+            }
+            break;
+        case 9:
+            // REG1 <--c(REG1) * c(REG2) 
+            if (!multiplyWords(m_reg[reg1], m_reg[reg2], m_reg[reg1])) {
+                settleBudget(blockStart, pc + 1);
+                return trapOverflow(pc);
+            }
+            break;
+        case 10:
+            // REG1 <--c(REG1) / c(REG2)  
+            m_reg[reg1] /= m_reg[reg2];
+            break;
+        case 11:
+            // A line is read in and the number found there is recorded
+            // in the specified memory address.
+            if (!m_input->hasInput()) {
+                settleBudget(blockStart, pc);
+                return awaitInput(pc);
+            }
+            if (readInput(address)) {
+                settleBudget(blockStart, next);
+                return pauseAt(next);
+            }
+            break;
+        case 12:
+            // c(ADDR) is displayed  The register value is ignored.
+            m_writeCount++;
+            m_output->writeWord(m_memory.get(address));
+            break;
+        case 13:
+            // go to ADDR for the next instruction.  The register value is ignored.
+            next = address;
+            if (spendBudget(blockStart, pc, next)) {
+                return pauseAt(next);
+            }
+            break;
+        case 14:
+            // go to ADDR if c(Reg) < 0
+            if (m_reg[reg1] < 0) {
+                next = address;
+                if (spendBudget(blockStart, pc, next)) {
+                    return pauseAt(next);
                 }
-                break;
-            case 15:
-                // go to ADDR if c(Reg) = 0
-                if (m_reg[reg1] == 0) {
-                    i = address - 1;
+            }
+            break;
+        case 15:
+            // go to ADDR if c(Reg) = 0
+            if (m_reg[reg1] == 0) {
+                next = address;
+                if (spendBudget(blockStart, pc, next)) {
+                    return pauseAt(next);
                 }
-                break;
-            case 16:
-                // go to ADDR if c(Reg) > 0
-                if (m_reg[reg1] > 0) {
-                    i = address - 1;
+            }
+            break;
+        case 16:
+            // go to ADDR if c(Reg) > 0
+            if (m_reg[reg1] > 0) {
+                next = address;
+                if (spendBudget(blockStart, pc, next)) {
+                    return pauseAt(next);
                 }
-                break;
-            case 17:
-                // terminate execution.  The register value and address are ignored.
-                i = MEMSZ;
-                break;
-            default:
-                Errors::RecordError("Error! Error in OpCode!!");
-                Errors::DisplayErrors();
-                return false;
             }
+            break;
+        case OP_LOOP_BM:
+        case OP_LOOP_BZ:
+        case OP_LOOP_BP:
+            // BM, BZ or BP back to the start of a loop
+            if (OpCode == OP_LOOP_BM ? m_reg[reg1] < 0 : OpCode == OP_LOOP_BZ ? m_reg[reg1] == 0 : m_reg[reg1] > 0) {
+                closeLoop(pc, blockStart);
+                next = address;
+                if (spendBudget(blockStart, pc, next)) {
+                    return pauseAt(next);
+                }
+            }
+            break;
+        case 17:
+            // terminate execution.  The register value and address are ignored.
+            settleBudget(blockStart, pc + 1);
+            return false;
+        default:
+            settleBudget(blockStart, pc + 1);
+            reportError(Termination::InvalidOpCode, "Error! Error in OpCode!!");
+            return false;
+        }
+        pc = next;
+    }
+
+    // the program ran off the end of memory
+    settleBudget(blockStart, pc);
+    return false;
+}
+
+/*
+NAME:
+
+	runThreaded() - executes the program in memory with direct-threaded dispatch
+
+SYNOPSIS:
+
+	template <class Code>
+	Emulator::runThreaded(int a_start);
+	a_start		--> the location of the first instruction to execute
+
+DESCRIPTION:
 
+    Every instruction handler ends by fetching the next predecoded word and jumping straight
+    to its handler through a table of label addresses, so each handler has its own indirect
+    jump that the branch predictor can learn. A sentinel entry past the end of memory stops
+    the program when it falls off the end, so no bounds check is needed on each fetch.
+    The behavior is the same as runSwitch(), including counting each block towards the
+    budget at the taken branch that ends it, and the code policy.
+
+RETURN:
+
+	bool - returns false when the program halts, runs off the end of memory or hits an illegal op code
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+// g++ merges the identical dispatch sequences that end the handlers into one, which would
+// leave a single indirect jump for all of them.
+template <class Code>
+#if VC8000_THREADED_DISPATCH && !defined(__clang__)
+__attribute__((optimize("no-crossjumping")))
+#endif
+bool Emulator::runThreaded(int a_start) {
+#if VC8000_THREADED_DISPATCH
+    // The handler for each value of DecodedInstruction::m_opCode.
+    static void* const handlers[] = {
+        &&op_empty, &&op_add, &&op_sub, &&op_mult, &&op_div, &&op_load, &&op_store,
+        &&op_addr, &&op_subr, &&op_multr, &&op_divr, &&op_read, &&op_write,
+        &&op_b, &&op_bm, &&op_bz, &&op_bp, &&op_halt, &&op_illegal, &&op_stale, &&op_halt,
+        &&op_load_add_store, &&op_load_sub_store, &&op_load_sub_store_bp,
+        &&op_loop_bm, &&op_loop_bz, &&op_loop_bp
+    };
+    static_assert(sizeof(handlers) / sizeof(handlers[0]) == OP_LOOP_BP + 1, "missing handler");
+
+    int pc = a_start;
+    int blockStart = a_start;
+    const DecodedInstruction* decoded = nullptr;
+
+    // The page tables never move, so they are kept in locals rather than read through the
+    // members after every store.
+    const DecodedInstruction* const* pages = m_decoded.getPageTable();
+    const MemoryWord* const* memoryPages = m_memory.getPageTable();
+
+#define JUMP_TO(location) do { \
+        pc = (location); \
+        decoded = &pages[static_cast<unsigned>(pc) / DECODED_PAGE][static_cast<unsigned>(pc) % DECODED_PAGE]; \
+        goto *handlers[decoded->m_opCode]; \
+    } while (0)
+#define NEXT_INSTRUCTION() JUMP_TO(pc + 1)
+#define BRANCH_TO(branch, location) do { \
+        int target = (location); \
+        if (spendBudget(blockStart, (branch), target)) { \
+            return pauseAt(target); \
+        } \
+        JUMP_TO(target); \
+    } while (0)
+#define CLOSE_LOOP(branch, location) do { \
+        int loopStart = (location); \
+        closeLoop((branch), blockStart); \
+        BRANCH_TO((branch), loopStart); \
+    } while (0)
+#define WORD(location) memoryPages[static_cast<unsigned>(location) / MEMORY_PAGE][static_cast<unsigned>(location) % MEMORY_PAGE]
+
+    JUMP_TO(pc);
+
+op_empty:
+    // zero words are not counted towards the budget
+    blockStart -= pc;
+    pc = findNextInstruction(pc);
+    blockStart += pc;
+    JUMP_TO(pc);
+op_stale:
+    // the word, or a word of the fused instruction it starts, was overwritten by the
+    // program, decode it again and retry
+    decodeMemory(pc);
+    goto *handlers[decoded->m_opCode];
+op_add:
+    if (!addWords(m_reg[decoded->m_reg1], WORD(decoded->m_address), m_reg[decoded->m_reg1])) {
+        settleBudget(blockStart, pc + 1);
+        return trapOverflow(pc);
+    }
+    NEXT_INSTRUCTION();
+op_sub:
+    if (!subtractWords(m_reg[decoded->m_reg1], WORD(decoded->m_address), m_reg[decoded->m_reg1])) {
+        settleBudget(blockStart, pc + 1);
+        return trapOverflow(pc);
+    }
+    NEXT_INSTRUCTION();
+op_mult:
+    if (!multiplyWords(m_reg[decoded->m_reg1], WORD(decoded->m_address), m_reg[decoded->m_reg1])) {
+        settleBudget(blockStart, pc + 1);
+        return trapOverflow(pc);
+    }
+    NEXT_INSTRUCTION();
+op_div:
+    m_reg[decoded->m_reg1] /= WORD(decoded->m_address);
+    NEXT_INSTRUCTION();
+op_load:
+    m_reg[decoded->m_reg1] = WORD(decoded->m_address);
+    NEXT_INSTRUCTION();
+op_store:
+    setMemory(decoded->m_address, m_reg[decoded->m_reg1]);
+    if (Code::ENABLED) {
+        invalidateDecoded(decoded->m_address);
+    }
+    NEXT_INSTRUCTION();
+op_load_add_store:
+    if (Code::ENABLED && (decoded[1].m_opCode == OP_STALE || decoded[2].m_opCode == OP_STALE)) {
+        goto op_stale;
+    }
+    if (!addWords(WORD(decoded->m_address), WORD(decoded[1].m_address), m_reg[decoded->m_reg1])) {
+        m_reg[decoded->m_reg1] = WORD(decoded->m_address);
+        settleBudget(blockStart, pc + 2);
+        return trapOverflow(pc + 1);
+    }
+    setMemory(decoded->m_address, m_reg[decoded->m_reg1]);
+    if (Code::ENABLED) {
+        invalidateDecoded(decoded->m_address);
+    }
+    pc += 2;
+    NEXT_INSTRUCTION();
+op_load_sub_store:
+    if (Code::ENABLED && (decoded[1].m_opCode == OP_STALE || decoded[2].m_opCode == OP_STALE)) {
+        goto op_stale;
+    }
+    if (!subtractWords(WORD(decoded->m_address), WORD(decoded[1].m_address), m_reg[decoded->m_reg1])) {
+        m_reg[decoded->m_reg1] = WORD(decoded->m_address);
+        settleBudget(blockStart, pc + 2);
+        return trapOverflow(pc + 1);
+    }
+    setMemory(decoded->m_address, m_reg[decoded->m_reg1]);
+    if (Code::ENABLED) {
+        invalidateDecoded(decoded->m_address);
+    }
+    pc += 2;
+    NEXT_INSTRUCTION();
+op_load_sub_store_bp:
+    if (Code::ENABLED && (decoded[1].m_opCode == OP_STALE || decoded[2].m_opCode == OP_STALE || decoded[3].m_opCode == OP_STALE)) {
+        goto op_stale;
+    }
+    if (!subtractWords(WORD(decoded->m_address), WORD(decoded[1].m_address), m_reg[decoded->m_reg1])) {
+        m_reg[decoded->m_reg1] = WORD(decoded->m_address);
+        settleBudget(blockStart, pc + 2);
+        return trapOverflow(pc + 1);
+    }
+    setMemory(decoded->m_address, m_reg[decoded->m_reg1]);
+    if (Code::ENABLED) {
+        invalidateDecoded(decoded->m_address);
+    }
+    if (m_reg[decoded->m_reg1] > 0) {
+        if (decoded[3].m_opCode == OP_LOOP_BP) {
+            CLOSE_LOOP(pc + 3, decoded[3].m_address);
         }
+        BRANCH_TO(pc + 3, decoded[3].m_address);
     }
-    catch (...) {
-        cout << "Error! Invalid OpCode!";
-        return false;
+    JUMP_TO(pc + 4);
+op_addr:
+    if (!addWords(m_reg[decoded->m_reg1], m_reg[decoded->m_reg2], m_reg[decoded->m_reg1])) {
+        settleBudget(blockStart, pc + 1);
+        return trapOverflow(pc);
     }
-
+    NEXT_INSTRUCTION();
+op_subr:
+    if (!subtractWords(m_reg[decoded->m_reg1], m_reg[decoded->m_reg2], m_reg[decoded->m_reg1])) {
+        settleBudget(blockStart, pc + 1);
+        return trapOverflow(pc);
+    }
+    NEXT_INSTRUCTION();
+op_multr:
+    if (!multiplyWords(m_reg[decoded->m_reg1], m_reg[decoded->m_reg2], m_reg[decoded->m_reg1])) {
+        settleBudget(blockStart, pc + 1);
+        return trapOverflow(pc);
+    }
+    NEXT_INSTRUCTION();
+op_divr:
+    m_reg[decoded->m_reg1] /= m_reg[decoded->m_reg2];
+    NEXT_INSTRUCTION();
+op_read:
+    if (!m_input->hasInput()) {
+        settleBudget(blockStart, pc);
+        return awaitInput(pc);
+    }
+    if (readInput(decoded->m_address)) {
+        settleBudget(blockStart, pc + 1);
+        return pauseAt(pc + 1);
+    }
+    NEXT_INSTRUCTION();
+op_write:
+    m_writeCount++;
+    m_output->writeWord(WORD(decoded->m_address));
+    NEXT_INSTRUCTION();
+op_b:
+    BRANCH_TO(pc, decoded->m_address);
+op_bm:
+    if (m_reg[decoded->m_reg1] < 0) {
+        BRANCH_TO(pc, decoded->m_address);
+    }
+    NEXT_INSTRUCTION();
+op_bz:
+    if (m_reg[decoded->m_reg1] == 0) {
+        BRANCH_TO(pc, decoded->m_address);
+    }
+    NEXT_INSTRUCTION();
+op_bp:
+    if (m_reg[decoded->m_reg1] > 0) {
+        BRANCH_TO(pc, decoded->m_address);
+    }
+    NEXT_INSTRUCTION();
+op_loop_bm:
+    if (m_reg[decoded->m_reg1] < 0) {
+        CLOSE_LOOP(pc, decoded->m_address);
+    }
+    NEXT_INSTRUCTION();
+op_loop_bz:
+    if (m_reg[decoded->m_reg1] == 0) {
+        CLOSE_LOOP(pc, decoded->m_address);
+    }
+    NEXT_INSTRUCTION();
+op_loop_bp:
+    if (m_reg[decoded->m_reg1] > 0) {
+        CLOSE_LOOP(pc, decoded->m_address);
+    }
+    NEXT_INSTRUCTION();
+op_halt:
+    // HALT, which is counted, or the sentinel past the end of memory
+    settleBudget(blockStart, pc < MEMSZ ? pc + 1 : pc);
+    return false;
+op_illegal:
+    settleBudget(blockStart, pc + 1);
+    reportError(Termination::InvalidOpCode, "Error! Error in OpCode!!");
     return false;
+
+#undef CLOSE_LOOP
+#undef BRANCH_TO
+#undef NEXT_INSTRUCTION
+#undef JUMP_TO
+#undef WORD
+#else
+    return runSwitch<NoTrace, NoCheck, NoBreak, Code>(a_start, -1);
+#endif
+}
+
+/*
+NAME:
+
+	stepInstruction() - executes a single instruction
+
+SYNOPSIS:
+
+	Emulator::stepInstruction(int a_location);
+	a_location		--> the location of the instruction to execute
+
+DESCRIPTION:
+
+    Executes the instruction at a_location the same way runSwitch() does. It is used by the
+    JIT engine for the instructions that are not translated into machine code.
+
+RETURN:
+
+	int - the location of the next instruction to execute, or -1 if the program halted,
+	paused or hit an illegal op code
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+int Emulator::stepInstruction(int a_location) {
+    if (m_decoded.get(a_location).m_opCode == OP_STALE) {
+        decodeMemory(a_location);
+    }
+    const DecodedInstruction& decoded = m_decoded.get(a_location);
+    int reg1 = decoded.m_reg1;
+    int reg2 = decoded.m_reg2;
+    int address = decoded.m_address;
+
+    switch (decoded.m_opCode) {
+    case OP_EMPTY:
+        return findNextInstruction(a_location);
+    case 1:
+        if (!addWords(m_reg[reg1], m_memory.get(address), m_reg[reg1])) {
+            trapOverflow(a_location);
+            return -1;
+        }
+        break;
+    case 2:
+        if (!subtractWords(m_reg[reg1], m_memory.get(address), m_reg[reg1])) {
+            trapOverflow(a_location);
+            return -1;
+        }
+        break;
+    case 3:
+        if (!multiplyWords(m_reg[reg1], m_memory.get(address), m_reg[reg1])) {
+            trapOverflow(a_location);
+            return -1;
+        }
+        break;
+    case 4:
+        m_reg[reg1] /= m_memory.get(address);
+        break;
+    case 5:
+    case OP_LOAD_ADD_STORE:
+    case OP_LOAD_SUB_STORE:
+    case OP_LOAD_SUB_STORE_BP:
+        // a fused instruction is stepped through one word at a time, starting with its LOAD
+        m_reg[reg1] = m_memory.get(address);
+        break;
+    case 6:
+        setMemory(address, m_reg[reg1]);
+        invalidateDecoded(address);
+        break;
+    case 7:
+        if (!addWords(m_reg[reg1], m_reg[reg2], m_reg[reg1])) {
+            trapOverflow(a_location);
+            return -1;
+        }
+        break;
+    case 8:
+        if (!subtractWords(m_reg[reg1], m_reg[reg2], m_reg[reg1])) {
+            trapOverflow(a_location);
+            return -1;
+        }
+        break;
+    case 9:
+        if (!multiplyWords(m_reg[reg1], m_reg[reg2], m_reg[reg1])) {
+            trapOverflow(a_location);
+            return -1;
+        }
+        break;
+    case 10:
+        m_reg[reg1] /= m_reg[reg2];
+        break;
+    case 11:
+        if (!m_input->hasInput()) {
+            awaitInput(a_location);
+            return -1;
+        }
+        if (readInput(address)) {
+            pauseAt(a_location + 1);
+            return -1;
+        }
+        break;
+    case 12:
+        m_writeCount++;
+        m_output->writeWord(m_memory.get(address));
+        break;
+    case 13:
+        return address;
+    case 14:
+    case OP_LOOP_BM:
+        if (m_reg[reg1] < 0) {
+            return address;
+        }
+        break;
+    case 15:
+    case OP_LOOP_BZ:
+        if (m_reg[reg1] == 0) {
+            return address;
+        }
+        break;
+    case 16:
+    case OP_LOOP_BP:
+        if (m_reg[reg1] > 0) {
+            return address;
+        }
+        break;
+    case 17:
+        return -1;
+    default:
+        reportError(Termination::InvalidOpCode, "Error! Error in OpCode!!");
+        return -1;
+    }
+    return a_location + 1;
+}
+
+/*
+NAME:
+
+	runJit() - executes the program in memory with translated machine code
+
+SYNOPSIS:
+
+	Emulator::runJit(int a_start);
+	a_start		--> the location of the first instruction to execute
+
+DESCRIPTION:
+
+    Runs the translation of the block at the current location, translating it first if
+    necessary. Whatever the JIT compiler cannot translate (READ, WRITE, illegal words and
+    stores into code) is executed by stepInstruction(). Every word written outside
+    translated code, by insertMemory() or by any engine, is reported to the JIT compiler
+    through invalidateDecoded(), which discards its translations if the word was code or
+    its page was read by them from where it no longer is.
+    The words that translations store into are added to the index of empty memory.
+    If no executable memory is available, the program is run by runSwitch() instead.
+    Translated blocks take their lengths from the budget as they are entered, and the
+    interpreted instructions are taken one at a time, except for runs of zero words and a
+    READ that waits for input. A block stopped by an overflow gives back the instructions
+    after the one that overflowed. A block the budget could not cover has not run, so its
+    instructions are given back; if no limit has been reached, it runs past its count as a
+    block of the switch engine does, even if that takes the run beyond the limit, so that
+    every run gets through at least one block. If a limit was reached, the program pauses
+    before the block. When the program halts or pauses, the words that translations stored
+    into are decoded again, since translated code does not update the predecoded table.
+
+RETURN:
+
+	bool - returns false when the program halts, runs off the end of memory or hits an illegal op code
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+bool Emulator::runJit(int a_start) {
+#if VC8000_JIT
+    if (!m_jit) {
+        m_jit.reset(new JitCompiler(m_memory));
+    }
+    if (!m_jit->isReady()) {
+        return runSwitch<NoTrace, NoCheck, NoBreak, CheckedCode>(a_start, -1);
+    }
+    // memory written since the last run may have moved pages the translations read
+    m_jit->checkPages();
+
+    int pc = a_start;
+    bool isCounted = false;     // == true if the block at pc was counted but not executed
+    while (pc >= 0 && pc < MEMSZ) {
+        const unsigned char* block = m_jit->getBlock(pc);
+        if (block != nullptr) {
+            if (m_jit->hasNewStoreTargets()) {
+                // translated code writes memory behind the index of empty memory
+                for (int loc : m_jit->takeNewStoreTargets()) {
+                    markOccupied(loc);
+                }
+            }
+            pc = m_jit->execute(isCounted ? JitCompiler::skipBudgetCheck(block) : block, m_reg, m_budget);
+            isCounted = false;
+            if (pc >= JitCompiler::OVERFLOWED) {
+                // the block was counted as it was entered, but nothing after the instruction
+                // that overflowed was executed
+                int location = pc - JitCompiler::OVERFLOWED;
+                m_budget += m_jit->getBlockLast(location) - location;
+                trapOverflow(location);
+                break;
+            }
+            if (pc >= JitCompiler::OUT_OF_BUDGET) {
+                // the block has not run, so its instructions are given back before the limits
+                // are checked, and taken again as it runs past its check
+                pc -= JitCompiler::OUT_OF_BUDGET;
+                long long length = m_jit->getBlockLength(pc);
+                m_budget += length;
+                if (!renewBudget(pc)) {
+                    pauseAt(pc);
+                    break;
+                }
+                m_budget -= length;
+                isCounted = true;
+            }
+            continue;
+        }
+
+        // translated code writes memory without updating the predecoded table, so the
+        // word is always decoded again
+        decodeMemory(pc);
+        int OpCode = m_decoded.get(pc).m_opCode;
+
+        // zero words are passed over uncounted, as is a READ that waits for input, since it
+        // executes when the run is resumed
+        int location = pc;
+        pc = stepInstruction(pc);
+        if (OpCode != OP_EMPTY && !(pc < 0 && m_resumeLocation == location)) {
+            m_budget--;
+        }
+    }
+
+    // leave the predecoded table matching memory for the other engines and for snapshots,
+    // including the words stored by translations discarded during the run
+    for (int loc : m_jit->getStoreTargets()) {
+        decodeMemory(loc);
+    }
+    for (int loc : m_jit->takeFlushedStoreTargets()) {
+        decodeMemory(loc);
+    }
+    return isPaused();
+#else
+    return runSwitch<NoTrace, NoCheck, NoBreak, CheckedCode>(a_start, -1);
+#endif
 }
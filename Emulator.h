@@ -4,28 +4,484 @@
 #ifndef _EMULATOR_H      // UNIX way of preventing multiple inclusions.
 #define _EMULATOR_H
 
+#include "MemoryWord.h"
+#include "EmulatorPolicies.h"
+#include "IoDevices.h"
+#include "PagedMemory.h"
+#include "JitCompiler.h"
+#include "Telemetry.h"
+#include "ProgramVerifier.h"
+#include "CostEstimator.h"
+
+// The threaded engine relies on the labels-as-values extension of g++ and clang.
+#if defined(__GNUC__)
+#define VC8000_THREADED_DISPATCH 1
+#else
+#define VC8000_THREADED_DISPATCH 0
+#endif
+
 class Emulator {
 
 public:
 
     const static int MEMSZ = 1'000'000;	// The size of the memory of the VC8000.
 
-    Emulator() {
-        m_memory.resize(MEMSZ, 0);
+    // The engines that can execute the program in memory.
+    enum class Engine {
+        Switch,     // One switch statement dispatches every instruction.
+        Threaded,   // Each instruction jumps directly to the next one's handler.
+        Jit         // Basic blocks are translated into x86-64 machine code.
+    };
+
+    // Limits on each run, from runProgram() or resumeProgram() until the program halts or
+    // pauses.  A limit of zero is no limit.
+    struct RunLimits {
+        long long m_maxInstructions = 0;    // Instructions the run may execute.
+        long long m_maxMilliseconds = 0;    // Wall-clock time the run may take.
+        int m_maxPages = 0;                 // Pages of memory written since the last snapshot.
+    };
+
+    // Why the last run ended.
+    enum class Termination {
+        Halted,             // The program executed HALT or ran off the end of memory.
+        Paused,             // At a READ, a breakpoint or the end of a time slice.
+        InstructionLimit,   // The run executed RunLimits::m_maxInstructions.
+        TimeLimit,          // The run took RunLimits::m_maxMilliseconds.
+        MemoryLimit,        // The program wrote more than RunLimits::m_maxPages pages.
+        InvalidOpCode,      // The program reached a word that is not an instruction.
+        Overflow,           // A result did not fit in a word.
+        AddressOutOfBounds  // An instruction used memory outside the address bounds.
+    };
+
+    // Creates an emulator whose READs take their input from a_input and whose WRITEs and
+    // messages go to a_output.  Without them it reads from cin and writes to cout.
+    Emulator()
+    : Emulator(make_shared<ConsoleInput>(), make_shared<ConsoleOutput>())
+    {
+    }
+    Emulator(shared_ptr<InputDevice> a_input, shared_ptr<OutputDevice> a_output)
+    : m_memory(MEMSZ),
+      m_decoded(MEMSZ + 1),
+      m_input(a_input),
+      m_output(a_output)
+    {
+        // The extra entry is a sentinel that stops a program running off the end of memory.
+        m_decoded.getWritable(MEMSZ).m_opCode = OP_END;
+        m_groupIndex.resize((NUM_GROUPS + 63) / 64, 0);
+        m_summaryIndex.resize((NUM_GROUPS + 64 * 64 - 1) / (64 * 64), 0);
     }
 
+    // The state of an emulator at one moment, taken by takeSnapshot().
+    class Snapshot;
+
+    // Creates an emulator in the state of a snapshot, sharing its pages of memory.  It reads
+    // from cin and writes to cout until setDevices() is called.
+    explicit Emulator(const Snapshot& a_snapshot);
+
     // Records instructions and data into simulated memory.
     bool insertMemory(int a_location, long long a_contents);
 
-    // Runs the program recorded in memory.
+    // Returns the contents of a location in memory.
+    MemoryWord getMemory(int a_location) const { return m_memory.get(a_location); }
+
+    // Returns the location of the first non-zero word at or after a location, or MEMSZ.
+    int findNonZeroWord(int a_location) const { return findNextInstruction(a_location); }
+
+    // Sets and returns the location of the first instruction to be executed.
+    void setEntryPoint(int a_location) {
+        m_isVerifyPending = m_isVerifyPending || a_location != m_entryPoint;
+        m_entryPoint = a_location;
+    }
+    int getEntryPoint() const { return m_entryPoint; }
+
+    // Sets and returns a register, 0 to 9.
+    void setRegister(int a_reg, MemoryWord a_value) { m_reg[a_reg] = a_value; }
+    MemoryWord getRegister(int a_reg) const { return m_reg[a_reg]; }
+
+    // Runs the program recorded in memory.  Returns true if it paused; getTermination()
+    // tells why the run ended.
     bool runProgram();
 
+    // Runs the program as runProgram() does, without first writing the emulator's banner.
+    bool startProgram() { return runFrom(m_entryPoint, false); }
+
+    // Verifies that the program in memory never stores into its code, so that it can run
+    // without the engines checking its stores.  runProgram() and takeSnapshot() verify a
+    // program that has changed since it was last verified.
+    ProgramVerifier verifyProgram();
+
+    // Checks whether the program was verified.
+    bool isVerified() const { return m_isVerified; }
+
+    // Returns an estimator of the instructions the program in memory executes.  It reads the
+    // emulator's memory, so it must not outlive the emulator or be used while a run changes it.
+    CostEstimator estimateCost() const { return CostEstimator(m_memory, MEMSZ); }
+
+    // Replaces the devices READ takes its input from and WRITE and the emulator's messages go
+    // to, between runs.  The output device is flushed at the end of every run.
+    void setDevices(shared_ptr<InputDevice> a_input, shared_ptr<OutputDevice> a_output) {
+        m_input = a_input;
+        m_output = a_output;
+    }
+
+    // Pauses the program once it has executed a number of READs, or never if it is zero.
+    void pauseAfterReads(int a_reads) { m_readsUntilPause = a_reads; }
+
+    // Pauses the program each time it has executed a number of instructions since it was run
+    // or resumed, or never if it is zero.  A program with a time slice runs on the switch
+    // engine, which is the only one that counts every instruction.
+    void setQuantum(long long a_instructions) { m_quantum = a_instructions; }
+
+    // Limits each run.  A run that reaches a limit pauses where it stopped, so it can be
+    // resumed with a fresh allowance of instructions and time.  The limits are checked once
+    // per basic block, so a run may go past its instruction or memory limit by part of a
+    // block, and the clock is read every CHECK_INTERVAL instructions.
+    void setLimits(const RunLimits& a_limits) { m_limits = a_limits; }
+    const RunLimits& getLimits() const { return m_limits; }
+
+    // Returns why the last run ended.
+    Termination getTermination() const { return m_termination; }
+
+    // Returns the instructions executed by the last run or resume.  They are counted a block
+    // at a time, as the limits are, so the block a run stops in may be counted in part or whole.
+    long long getInstructionsExecuted() const { return m_executed + m_granted - m_budget; }
+
+    // Checks whether the program is paused, and where it continues from, and continues
+    // running it if it is.
+    bool isPaused() const { return m_resumeLocation >= 0; }
+    int getResumeLocation() const { return m_resumeLocation; }
+    bool resumeProgram();
+
+    // Checks whether the program paused at a READ because its input device had no number
+    // ready.  Resuming it executes the READ again.
+    bool isWaitingForInput() const { return m_isWaitingForInput; }
+
+    // Captures memory, registers and the location a paused program resumes from.  Memory is
+    // shared copy-on-write, so only the pages written since the last snapshot are recorded.
+    Snapshot takeSnapshot();
+
+    // Returns to a snapshot.  Returning to the last snapshot taken or restored only resets
+    // the pages written since.
+    void restoreSnapshot(const Snapshot& a_snapshot);
+
+    // Creates an emulator in the current state, sharing the pages of memory with this one.
+    unique_ptr<Emulator> fork();
+
+    // Returns the number of pages of memory written since the last snapshot.
+    int getDirtyPages() const { return m_memory.getDirtyPages(); }
+
+    // Publishes counters of the runs in a shared memory segment of a name, for a reader in
+    // another process to watch.  The counters are published every CHECK_INTERVAL instructions
+    // and at the end of each run.  Returns false if the segment could not be created.
+    bool publishTelemetry(const string& a_name);
+
+    // Debugging.  While any of these is in use, runProgram runs the switch engine built with
+    // the debugging policies; otherwise the engines are built with policies that do nothing.
+    // Traces every instruction executed to a stream, or stops tracing if it is nullptr.
+    void setTrace(ostream* a_trace) { m_debug.m_trace = a_trace; }
+
+    // Counts every instruction executed in a profile, or stops profiling if it is nullptr.
+    void setProfile(ExecutionProfile* a_profile) { m_debug.m_profile = a_profile; }
+
+    // Records the numbers the following runs read, and their instructions if the trace has
+    // them, in a trace that must outlive the runs.
+    void recordTrace(TraceWriter& a_trace);
+
+    // Replays a trace: the following runs read the numbers recorded in it, and if it has
+    // instructions, each instruction executed is checked against it.
+    void replayTrace(TraceReader& a_trace);
+
+    // Stops the program if an instruction uses memory outside [a_low, a_high].  A negative
+    // a_high removes the bounds.
+    void setAddressBounds(int a_low, int a_high) {
+        m_debug.m_lowAddress = a_low;
+        m_debug.m_highAddress = a_high;
+    }
+
+    // Sets or clears a breakpoint, where the program pauses before executing the instruction.
+    void setBreakpoint(int a_location, bool a_isSet);
+
+    // Checks whether any debugging feature is in use.
+    bool isDebugging() const {
+        return m_debug.m_trace != nullptr || m_debug.m_profile != nullptr || m_debug.m_recorder != nullptr ||
+            m_debug.m_replay != nullptr || m_debug.m_highAddress >= 0 || m_breakpointCount > 0;
+    }
+
+    // Selects the engine used by runProgram.  Returns false if it is not available in this build.
+    bool setEngine(Engine a_engine);
+
+    // Returns the bytes of host memory this emulator has allocated.
+    size_t getResidentBytes() const;
+
+    // Displays how much host memory this emulator has allocated, and for what.
+    void displayMemoryUsage() const;
+
+    // Checks whether an engine was compiled into this build.
+    static bool isEngineAvailable(Engine a_engine) {
+        switch (a_engine) {
+        case Engine::Threaded:
+            return VC8000_THREADED_DISPATCH;
+        case Engine::Jit:
+            return VC8000_JIT;
+        default:
+            return true;
+        }
+    }
+
 private:
-    
-    vector<long long> m_memory;  	// Memory for the VC8000
-    long long m_reg[10] = { 0 };    // Registers for the VC8000
+
+    // Special values of DecodedInstruction::m_opCode.  1 - 17 are the VC8000 op codes.
+    enum : unsigned char {
+        OP_EMPTY = 0,       // The word is zero and is skipped over.
+        OP_ILLEGAL = 18,    // The word does not hold a valid instruction.
+        OP_STALE = 19,      // The word was overwritten and must be decoded again.
+        OP_END = 20,        // The sentinel past the end of memory.
+
+        // Fused instructions, recorded on the LOAD that starts them.  The LOAD keeps its own
+        // register and address; the other fields are read from the words that follow it.
+        OP_LOAD_ADD_STORE = 21,     // load r,x / add r,y / store r,x
+        OP_LOAD_SUB_STORE = 22,     // load r,x / sub r,y / store r,x
+        OP_LOAD_SUB_STORE_BP = 23,  // load r,x / sub r,y / store r,x / bp r,L
+
+        // BM, BZ and BP back to a location at most MAX_LOOP_WORDS words before them, which
+        // close a loop that fastForwardLoop() may skip ahead in.
+        OP_LOOP_BM = 24,
+        OP_LOOP_BZ = 25,
+        OP_LOOP_BP = 26
+    };
+
+    // The longest loop, in words, that fastForwardLoop() is tried on.
+    const static int MAX_LOOP_WORDS = 64;
+
+    // Taken branches that close a loop between tries of fastForwardLoop(), to begin with and
+    // at most.  Each try that does not pay doubles the gap, up to the most.
+    const static int LOOP_RETRY = 64;
+    const static int MAX_LOOP_RETRY = 1 << 16;
+
+    // The fewest iterations worth skipping, since working out where they lead costs about
+    // as much as running a few dozen.
+    const static long long MIN_LOOP_SKIP = 64;
+
+    // A memory word split into its fields, so that the run loop does not have to divide.
+    struct DecodedInstruction {
+        unsigned char m_opCode = OP_EMPTY;
+        unsigned char m_reg1 = 0;
+        unsigned char m_reg2 = 0;
+        int m_address = 0;
+    };
+
+    // Decodes the word at a location into the predecoded table, and updates the fused
+    // instructions that the word starts or belongs to.
+    void decodeMemory(int a_location);
+
+    // Decodes the word at a location without fusing it.
+    void decodeWord(int a_location);
+
+    // Records a fused instruction at a location if the words starting there form one.
+    void fuseInstructions(int a_location);
+
+    // Checks whether a predecoded op code is a fused instruction.
+    static bool isFused(int a_opCode) { return a_opCode >= OP_LOAD_ADD_STORE && a_opCode <= OP_LOAD_SUB_STORE_BP; }
+
+    // Checks whether a predecoded op code is a branch that closes a loop, and returns the
+    // VC8000 op code of the branch.
+    static bool isLoopBranch(int a_opCode) { return a_opCode >= OP_LOOP_BM; }
+    static int plainBranch(int a_opCode) { return a_opCode - OP_LOOP_BM + 14; }
+
+    // Called on each taken branch that closes a loop, before its block is counted.  Every
+    // so often tries to skip ahead in the loop.
+    void closeLoop(int a_branch, int a_blockStart) {
+        if (--m_loopCountdown == 0) {
+            fastForwardLoop(a_branch, a_blockStart);
+        }
+    }
+
+    // Runs as many iterations of the loop closed by the taken branch at a_branch as can be
+    // worked out at once, if it is a counted loop.  a_blockStart is where the block the
+    // branch ends began.
+    void fastForwardLoop(int a_branch, int a_blockStart);
+
+    // Marks a location whose contents were changed by the running program.  A fused
+    // instruction checks that none of its words is stale before it is executed.  Only an
+    // empty location can be missing from the index, since locations are never removed from it.
+    // The JIT compiler is told too, since its translations of the word are as stale.
+    void invalidateDecoded(int a_location) {
+        DecodedInstruction& decoded = m_decoded.getWritable(a_location);
+        if (decoded.m_opCode == OP_EMPTY) {
+            markOccupied(a_location);
+        }
+        decoded.m_opCode = OP_STALE;
+        if (m_jit) {
+            m_jit->notifyWrite(a_location);
+        }
+    }
+
+    // Writes a word of memory.  The caller marks its predecoded copy.
+    void setMemory(int a_location, MemoryWord a_contents) { m_memory.getWritable(a_location) = a_contents; }
+
+    // Displays an error that stops the program, after the output written before it, and
+    // records why it stopped.
+    void reportError(Termination a_reason, const string& a_message);
+
+    // Stops the program at an instruction whose result does not fit in a word.  Returns false,
+    // as the engines do when the program stops.
+    bool trapOverflow(int a_location);
+
+    // The number of words in each page of memory and of the predecoded table.
+    const static int MEMORY_PAGE = PagedMemory<MemoryWord>::PAGE_SIZE;
+    const static int DECODED_PAGE = PagedMemory<DecodedInstruction>::PAGE_SIZE;
+
+    // Number of words covered by each bit of m_groupIndex, and the number of such groups.
+    const static int GROUP_WORDS = 64;
+    const static int NUM_GROUPS = (MEMSZ + GROUP_WORDS - 1) / GROUP_WORDS;
+    static_assert(MEMORY_PAGE % GROUP_WORDS == 0, "a group must not cross pages");
+
+    // Records in the index that a location may hold a non-zero word.
+    void markOccupied(int a_location) {
+        int group = a_location / GROUP_WORDS;
+        m_groupIndex[group / 64] |= 1ULL << (group % 64);
+        m_summaryIndex[group / (64 * 64)] |= 1ULL << ((group / 64) % 64);
+    }
+
+    // Returns the location of the first non-zero word at or after a location, or MEMSZ if
+    // the rest of memory is empty.
+    int findNextInstruction(int a_location) const;
+
+    // Returns the first group at or after a group that may hold a non-zero word, or NUM_GROUPS.
+    int nextOccupiedGroup(int a_group) const;
+
+    // Returns the index of the lowest bit that is set in a non-zero value.
+    static int lowestSetBit(unsigned long long a_bits);
+
+    // Executes READ, recording the number entered in memory.  Returns true if the program
+    // is to pause after it.
+    bool readInput(int a_address);
+
+    // Records where a paused program resumes.  Returns true, as the engines do when paused.
+    bool pauseAt(int a_location) {
+        m_resumeLocation = a_location;
+        return true;
+    }
+
+    // Pauses the program at a READ whose input device has no number ready.  Returns true, as
+    // the engines do when paused.
+    bool awaitInput(int a_location) {
+        m_isWaitingForInput = true;
+        m_readWaitCount++;
+        return pauseAt(a_location);
+    }
+
+    // Instructions executed between readings of the clock for the time limit.
+    const static long long CHECK_INTERVAL = 1 << 16;
+
+    // Starts counting a run's instructions towards its limits.
+    void startBudget();
+
+    // Hands the engine the instructions it may execute before the limits are next checked.
+    void grantBudget();
+
+    // Called by an engine that has used up its budget, with the location the run continues
+    // from.  Checks the limits and grants more instructions if none was reached; otherwise
+    // records the limit and returns false.
+    bool renewBudget(int a_location);
+
+    // Publishes the counters of the run so far, with the location it is at, to the telemetry
+    // segment if there is one.
+    void publishCounters(int a_location);
+
+    // Counts the instructions from a_blockStart up to a taken branch at a_branch, and starts
+    // the next block at its target.  Returns true if the run is to stop at the target.
+    bool spendBudget(int& a_blockStart, int a_branch, int a_target) {
+        m_budget -= a_branch - a_blockStart + 1;
+        a_blockStart = a_target;
+        return m_budget < 0 && !renewBudget(a_target);
+    }
+
+    // Counts the instructions from a_blockStart up to a_stop, where the run stops in the
+    // middle of a block, so that getInstructionsExecuted() includes them.
+    void settleBudget(int a_blockStart, int a_stop) { m_budget -= a_stop - a_blockStart; }
+
+    // Runs the program from a location with the selected engine, or the debugging engine.
+    // a_isResuming is true if the program is continuing from where it paused.
+    bool runFrom(int a_location, bool a_isResuming);
+
+    // Stops the program at an instruction that uses memory outside the address bounds.
+    bool trapAddress(int a_location, int a_address);
+
+    // Executes the instruction at a location.  Returns the location of the next instruction,
+    // or a negative value if the program halted, paused or hit an illegal op code.
+    int stepInstruction(int a_location);
+
+    // The engines behind runProgram.  Each starts at a location and returns true if the
+    // program paused.  The switch engine is built with a trace, a check, a break and a code
+    // policy from EmulatorPolicies.h, and the threaded engine with a code policy; a_resumed
+    // is the location of the breakpoint it is resuming from, or -1.
+    template <class Trace, class Check, class Break, class Code>
+    bool runSwitch(int a_start, int a_resumed);
+    template <class Code>
+    bool runThreaded(int a_start);
+    bool runJit(int a_start);
+
+    PagedMemory<MemoryWord> m_memory;   // Memory for the VC8000
+    PagedMemory<DecodedInstruction> m_decoded;  // Predecoded copy of every word in memory
+    MemoryWord m_reg[10] = { 0 };   // Registers for the VC8000
+    int m_entryPoint = 0;           // Location of the first instruction to be executed
+    vector<unsigned long long> m_groupIndex;    // One bit per group of words that may be non-zero
+    vector<unsigned long long> m_summaryIndex;  // One bit per word of m_groupIndex that is non-zero
+    Engine m_engine = VC8000_THREADED_DISPATCH ? Engine::Threaded : Engine::Switch;   // Engine used by runProgram
+    unique_ptr<JitCompiler> m_jit;  // Translations made by the JIT engine, created on first use
+    int m_readsUntilPause = 0;      // READs left before the program pauses, or 0 to never pause
+    int m_resumeLocation = -1;      // Location a paused program resumes from, or -1
+    bool m_isAtBreakpoint = false;  // == true if the program paused at a breakpoint
+    bool m_isWaitingForInput = false;   // == true if the program paused at a READ with no input
+    long long m_quantum = 0;        // Instructions in each time slice, or 0 for no time slices
+    RunLimits m_limits;             // Limits on each run
+    Termination m_termination = Termination::Halted;    // Why the last run ended
+    long long m_budget = 0;         // Instructions the engine may execute before renewBudget()
+    long long m_granted = 0;        // The budget last granted
+    long long m_executed = 0;       // Instructions counted in this run before the last grant
+    chrono::steady_clock::time_point m_deadline;    // When the run reaches its time limit
+    DebugSettings m_debug;          // What the debugging policies are to do
+    int m_breakpointCount = 0;      // Number of breakpoints set
+    unique_ptr<TelemetrySegment> m_telemetry;   // Where the counters are published, if anywhere
+    long long m_published = 0;      // Instructions of this run already published
+    long long m_writeCount = 0;     // WRITEs executed
+    long long m_readWaitCount = 0;  // READs that paused for want of input
+    int m_loopRetry = LOOP_RETRY;   // Taken loop branches between tries of fastForwardLoop()
+    int m_loopCountdown = LOOP_RETRY;   // Taken loop branches left until the next try
+    bool m_isVerifyPending = true;  // == true if the program changed since it was verified
+    bool m_isVerified = false;      // == true if the program never stores into its code
+    vector<int> m_storeTargets;     // The words a verified program may store into
+    shared_ptr<InputDevice> m_input;    // Device READ takes its input from
+    shared_ptr<OutputDevice> m_output;  // Device WRITE and the emulator's messages go to
 
 };
 
-#endif
+class Emulator::Snapshot {
+    friend class Emulator;
+
+    Snapshot() { }
+
+    PagedMemory<MemoryWord>::Snapshot m_memory;
+    PagedMemory<DecodedInstruction>::Snapshot m_decoded;
+    MemoryWord m_reg[10] = { 0 };
+    int m_entryPoint = 0;
+    int m_resumeLocation = -1;
+    bool m_isAtBreakpoint = false;
+    bool m_isWaitingForInput = false;
+    vector<unsigned long long> m_groupIndex;
+    vector<unsigned long long> m_summaryIndex;
+    bool m_isVerified = false;
+    vector<int> m_storeTargets;
+};
+
+inline Emulator::Emulator(const Snapshot& a_snapshot)
+: m_memory(MEMSZ, a_snapshot.m_memory),
+  m_decoded(MEMSZ + 1, a_snapshot.m_decoded),
+  m_input(make_shared<ConsoleInput>()),
+  m_output(make_shared<ConsoleOutput>())
+{
+    restoreSnapshot(a_snapshot);
+}
 
+#endif
@@ -0,0 +1,113 @@
+//
+//		Policies that add tracing, profiling, recording, address checks, breakpoints, time slices and code checks to the emulator's run loop
+//
+#ifndef _EMULATORPOLICIES_H
+#define _EMULATORPOLICIES_H
+
+#include "MemoryWord.h"
+#include "ExecutionProfile.h"
+#include "ExecutionTrace.h"
+
+// What the debugging policies are asked to do, set through the Emulator.
+struct DebugSettings {
+    ostream* m_trace = nullptr;     // Receives a line for every instruction executed, if set.
+    ExecutionProfile* m_profile = nullptr;  // Counts every instruction executed, if set.
+    TraceWriter* m_recorder = nullptr;      // Records every instruction executed, if set.
+    TraceReader* m_replay = nullptr;        // Checks every instruction against a recording, if set.
+    int m_lowAddress = 0;           // The lowest memory address the program may use.
+    int m_highAddress = -1;         // The highest, or -1 if any address may be used.
+    vector<char> m_breakpoints;     // == 1 at each location where the program pauses.
+};
+
+// The run loop is a template on one trace, one check and one break policy.  Each policy has
+// a no-op version whose functions are empty or return a constant, so that a run loop built
+// with it has no trace of the feature.  ENABLED tells the run loop whether it must execute
+// every instruction on its own, rather than as part of a fused instruction.
+
+// Trace policies are told of every instruction before it is executed, and trace, profile,
+// record or check it.
+struct NoTrace {
+    const static bool ENABLED = false;
+    static void instruction(const DebugSettings&, int, int, int, int, int, const MemoryWord*) { }
+};
+
+struct TraceAndProfile {
+    const static bool ENABLED = true;
+    static void instruction(const DebugSettings& a_settings, int a_location, int a_opCode, int a_reg1,
+                            int a_reg2, int a_address, const MemoryWord* a_reg) {
+        if (a_settings.m_profile != nullptr) {
+            a_settings.m_profile->countInstruction(a_location, a_opCode, a_reg1, a_address, a_reg);
+        }
+        if (a_settings.m_recorder != nullptr) {
+            a_settings.m_recorder->recordInstruction(a_location, a_reg);
+        }
+        if (a_settings.m_replay != nullptr) {
+            a_settings.m_replay->checkInstruction(a_location, a_reg);
+        }
+        if (a_settings.m_trace == nullptr) {
+            return;
+        }
+        *a_settings.m_trace << setw(6) << a_location << ": " << setfill('0') << setw(2) << a_opCode << " "
+            << a_reg1 << " " << a_reg2 << " " << setw(6) << a_address << setfill(' ')
+            << "    R" << a_reg1 << " = " << a_reg[a_reg1] << endl;
+    }
+};
+
+// Check policies are given the op code and address of every instruction, and return false
+// if the instruction uses memory outside the permitted addresses.
+struct NoCheck {
+    const static bool ENABLED = false;
+    static bool address(const DebugSettings&, int, int) { return true; }
+};
+
+struct BoundsCheck {
+    const static bool ENABLED = true;
+    static bool address(const DebugSettings& a_settings, int a_opCode, int a_address) {
+        bool usesMemory = (a_opCode >= 1 && a_opCode <= 6) || a_opCode == 11 || a_opCode == 12;
+        return !usesMemory || a_settings.m_highAddress < 0 ||
+            (a_address >= a_settings.m_lowAddress && a_address <= a_settings.m_highAddress);
+    }
+};
+
+// Break policies return true if the program is to pause before the instruction at a
+// location.  a_resumed is the location the run started at, whose breakpoint has already
+// been hit; it is cleared once that instruction has been let through.  isSliceOver() counts
+// down a_stepsLeft, the instructions left in the time slice, once per instruction and returns
+// true when none are left; a_stepsLeft starts negative when the run has no time slice.
+struct NoBreak {
+    const static bool ENABLED = false;
+    static bool atBreakpoint(const DebugSettings&, int, int&) { return false; }
+    static bool isSliceOver(long long&) { return false; }
+};
+
+struct Breakpoints {
+    const static bool ENABLED = true;
+    static bool atBreakpoint(const DebugSettings& a_settings, int a_location, int& a_resumed) {
+        if (a_location == a_resumed) {
+            a_resumed = -1;
+            return false;
+        }
+        return !a_settings.m_breakpoints.empty() && a_settings.m_breakpoints[a_location] != 0;
+    }
+    static bool isSliceOver(long long& a_stepsLeft) { return a_stepsLeft-- == 0; }
+};
+
+struct Timeslice {
+    const static bool ENABLED = true;
+    static bool atBreakpoint(const DebugSettings&, int, int&) { return false; }
+    static bool isSliceOver(long long& a_stepsLeft) { return a_stepsLeft-- == 0; }
+};
+
+// Code policies tell the run loop whether the program may store into its own code.  If it
+// may, each store marks the word it changes for decoding again, and a fused instruction checks
+// that none of its words was overwritten before it is executed.  A program that the verifier
+// has proved never stores into its code needs neither.
+struct CheckedCode {
+    const static bool ENABLED = true;
+};
+
+struct VerifiedCode {
+    const static bool ENABLED = false;
+};
+
+#endif
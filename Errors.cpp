@@ -1,7 +1,8 @@
 #include "stdafx.h"
 #include "Errors.h"
 
-vector<string> Errors::m_ErrorMsgs;
+thread_local vector<string> Errors::m_ErrorMsgs;
+thread_local ostream* Errors::m_Output = &cout;
 
 /*
 NAME:
@@ -77,7 +78,8 @@ SYNOPSIS:
 
 DESCRIPTION:
 
-	The function iterates over the vector of error messages and prints each one
+	The function iterates over the vector of error messages recorded by this thread and
+	prints each one on the stream set with SetOutput(), cout by default.
 
 RETURN:
 
@@ -96,6 +98,6 @@ DATE:
 void Errors::DisplayErrors() {
 
 	for (const auto& error : m_ErrorMsgs) {
-		cout << error << endl;
+		*m_Output << error << endl;
 	}
 }
\ No newline at end of file
@@ -26,9 +26,15 @@ public:
         return m_ErrorMsgs.empty();
     }
 
+    // Sets the stream errors are displayed on by this thread.  It is cout unless set.
+    static void SetOutput( ostream* a_output ) { m_Output = a_output; }
+
 private:
 
-    static vector<string> m_ErrorMsgs;  // This must be declared in the .cpp file.  Why?
+    // Each thread records and displays its own errors, so that programs run in parallel
+    // by the batch runner do not see each other's.
+    static thread_local vector<string> m_ErrorMsgs;  // This must be declared in the .cpp file.  Why?
+    static thread_local ostream* m_Output;          // Where DisplayErrors() writes.
     
 };
 #endif
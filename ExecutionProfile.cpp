@@ -0,0 +1,115 @@
+//
+//		Implementation of the ExecutionProfile class.
+//
+#include "stdafx.h"
+#include "ExecutionProfile.h"
+
+/*
+NAME:
+
+    ExecutionProfile() - creates an empty profile
+
+SYNOPSIS:
+
+    ExecutionProfile::ExecutionProfile(int a_size);
+    a_size      --> the number of words in the memory profiled
+
+DESCRIPTION:
+
+    Every count starts on the shared zero page, so nothing is allocated until the run
+    executes an instruction or uses an address.
+
+RETURNS:
+
+    constructor, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+ExecutionProfile::ExecutionProfile(int a_size)
+: m_executions(a_size),
+  m_taken(a_size),
+  m_reads(a_size),
+  m_writes(a_size)
+{
+}
+
+/*
+NAME:
+
+    countInstruction() - counts an instruction about to be executed
+
+SYNOPSIS:
+
+    void ExecutionProfile::countInstruction(int a_location, int a_opCode, int a_reg1, int a_address,
+                                            const MemoryWord* a_reg);
+    a_location  --> the location of the instruction
+    a_opCode    --> its op code, 1 - 17
+    a_reg1      --> its register
+    a_address   --> its address
+    a_reg       --> the registers, before the instruction is executed
+
+DESCRIPTION:
+
+    ADD, SUB, MULT, DIV, LOAD and WRITE read their address, and STORE and READ write it. B is
+    always taken, and BM, BZ and BP are taken when the register is negative, zero or positive,
+    which is known before they are executed.
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void ExecutionProfile::countInstruction(int a_location, int a_opCode, int a_reg1, int a_address,
+                                        const MemoryWord* a_reg)
+{
+    m_executions.getWritable(a_location)++;
+    m_total++;
+
+    bool isTaken = false;
+    switch (a_opCode) {
+    case 1:
+    case 2:
+    case 3:
+    case 4:
+    case 5:
+    case 12:
+        m_reads.getWritable(a_address)++;
+        break;
+    case 6:
+    case 11:
+        m_writes.getWritable(a_address)++;
+        break;
+    case 13:
+        isTaken = true;
+        break;
+    case 14:
+        isTaken = a_reg[a_reg1] < 0;
+        break;
+    case 15:
+        isTaken = a_reg[a_reg1] == 0;
+        break;
+    case 16:
+        isTaken = a_reg[a_reg1] > 0;
+        break;
+    }
+    if (isTaken) {
+        m_taken.getWritable(a_location)++;
+    }
+}
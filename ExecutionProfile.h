@@ -0,0 +1,54 @@
+//
+//		ExecutionProfile class - counts what a run of a VC8000 program does at each memory address
+//
+#ifndef _EXECUTIONPROFILE_H
+#define _EXECUTIONPROFILE_H
+
+#include "MemoryWord.h"
+#include "PagedMemory.h"
+
+// Counts the instructions executed at each location, how often each branch was taken, and the
+// reads and writes of each data address.  The counts are kept in paged memory, so a profile
+// only takes room for the pages of addresses the program used.  An emulator given a profile
+// with Emulator::setProfile() runs on its debugging engine, which counts every instruction;
+// the other engines never look at a profile.
+class ExecutionProfile {
+
+public:
+
+    // Creates an empty profile of a memory of a_size words.
+    explicit ExecutionProfile(int a_size);
+
+    ExecutionProfile(const ExecutionProfile&) = delete;
+    ExecutionProfile& operator=(const ExecutionProfile&) = delete;
+
+    // Counts an instruction about to be executed.  a_reg holds the registers, from which the
+    // branch instructions are known to be taken or not.
+    void countInstruction(int a_location, int a_opCode, int a_reg1, int a_address, const MemoryWord* a_reg);
+
+    // Returns the number of instructions counted.
+    long long getTotal() const { return m_total; }
+
+    // Returns the number of times the instruction at a location was executed, and, if it is a
+    // branch, the number of times it was taken.
+    long long getExecutions(int a_location) const { return m_executions.get(a_location); }
+    long long getTaken(int a_location) const { return m_taken.get(a_location); }
+
+    // Returns the number of times instructions read and wrote an address.  Fetching an
+    // instruction is not counted as a read.
+    long long getReads(int a_address) const { return m_reads.get(a_address); }
+    long long getWrites(int a_address) const { return m_writes.get(a_address); }
+
+    // Returns the number of locations in the profile.
+    int size() const { return m_executions.size(); }
+
+private:
+
+    PagedMemory<long long> m_executions;    // Instructions executed at each location.
+    PagedMemory<long long> m_taken;         // Branches taken at each location.
+    PagedMemory<long long> m_reads;         // Reads of each address.
+    PagedMemory<long long> m_writes;        // Writes of each address.
+    long long m_total = 0;                  // Instructions counted.
+};
+
+#endif
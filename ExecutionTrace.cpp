@@ -0,0 +1,449 @@
+//
+//		Implementation of the TraceWriter and TraceReader classes.
+//
+#include "stdafx.h"
+#include "ExecutionTrace.h"
+
+namespace {
+    const char MAGIC[4] = { 'V', 'C', '8', 'T' };   // The first bytes of every trace.
+    const char VERSION = 1;                         // The version of the format.
+    const char HAS_INSTRUCTIONS = 1;                // The flag of a trace that records instructions.
+    const size_t BUFFER_SIZE = 1 << 16;             // The bytes buffered on the way to or from the file.
+
+    // Maps signed numbers to unsigned ones with small magnitudes staying small: 0, -1, 1, -2,
+    // 2 ... become 0, 1, 2, 3, 4 ...  The difference is taken modulo 2^64, so it never overflows.
+    unsigned long long zigzag(unsigned long long a_difference)
+    {
+        return (a_difference << 1) ^ (0 - (a_difference >> 63));
+    }
+
+    unsigned long long unzigzag(unsigned long long a_value)
+    {
+        return (a_value >> 1) ^ (0 - (a_value & 1));
+    }
+}
+
+/*
+NAME:
+
+    TraceWriter() - creates a trace file
+
+SYNOPSIS:
+
+    TraceWriter::TraceWriter(const string& a_fileName, bool a_hasInstructions);
+    a_fileName  --> the name of the file
+    a_hasInstructions --> true to record every instruction, false to record only the numbers read
+
+RETURNS:
+
+    constructor, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+TraceWriter::TraceWriter(const string& a_fileName, bool a_hasInstructions)
+: m_file(a_fileName, ios::out | ios::binary | ios::trunc),
+  m_buffer(BUFFER_SIZE),
+  m_hasInstructions(a_hasInstructions)
+{
+    m_file.write(MAGIC, sizeof(MAGIC));
+    m_file.put(VERSION);
+    m_file.put(a_hasInstructions ? HAS_INSTRUCTIONS : 0);
+    m_written = sizeof(MAGIC) + 2;
+}
+
+/*
+NAME:
+
+    recordInput() - records a number taken by a READ
+
+SYNOPSIS:
+
+    void TraceWriter::recordInput(int a_value);
+    a_value     --> the number
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void TraceWriter::recordInput(int a_value)
+{
+    putVarint(zigzag(static_cast<unsigned long long>(static_cast<long long>(a_value))) << 1);
+    m_inputs++;
+}
+
+/*
+NAME:
+
+    recordInstruction() - records an instruction about to be executed
+
+SYNOPSIS:
+
+    void TraceWriter::recordInstruction(int a_location, const MemoryWord* a_reg);
+    a_location  --> the location of the instruction
+    a_reg       --> the registers, before it is executed
+
+DESCRIPTION:
+
+    The location is recorded as its distance from the word after the last instruction, which
+    is zero unless a branch was taken or empty memory skipped. A register is recorded only if
+    it changed since the last record, as the difference from its old value. The distance is
+    shifted past the mask of changed registers; locations are below a million, so it always
+    fits in the bits left.
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void TraceWriter::recordInstruction(int a_location, const MemoryWord* a_reg)
+{
+    unsigned changed = 0;
+    for (int reg = 0; reg < REGISTERS; reg++) {
+        if (a_reg[reg] != m_lastReg[reg]) {
+            changed |= 1u << reg;
+        }
+    }
+    long long distance = static_cast<long long>(a_location) - m_lastLocation - 1;
+    putVarint(zigzag(static_cast<unsigned long long>(distance)) << 11 | changed << 1 | 1);
+    for (int reg = 0; changed != 0; reg++, changed >>= 1) {
+        if ((changed & 1) != 0) {
+            putVarint(zigzag(static_cast<unsigned long long>(a_reg[reg]) - static_cast<unsigned long long>(m_lastReg[reg])));
+            m_lastReg[reg] = a_reg[reg];
+        }
+    }
+    m_lastLocation = a_location;
+    m_instructions++;
+}
+
+/*
+NAME:
+
+    flush() - writes the buffer to the file
+
+SYNOPSIS:
+
+    void TraceWriter::flush();
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void TraceWriter::flush()
+{
+    if (m_used > 0) {
+        m_file.write(reinterpret_cast<const char*>(m_buffer.data()), static_cast<streamsize>(m_used));
+        m_written += static_cast<long long>(m_used);
+        m_used = 0;
+    }
+    m_file.flush();
+}
+
+/*
+NAME:
+
+    TraceReader() - opens a trace file
+
+SYNOPSIS:
+
+    TraceReader::TraceReader(const string& a_fileName);
+    a_fileName  --> the name of the file
+
+DESCRIPTION:
+
+    A file that cannot be opened, or does not begin with the header of a trace of this
+    version, is not open.
+
+RETURNS:
+
+    constructor, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+TraceReader::TraceReader(const string& a_fileName)
+: m_file(a_fileName, ios::in | ios::binary),
+  m_buffer(BUFFER_SIZE)
+{
+    char header[sizeof(MAGIC) + 2];
+    if (!m_file.read(header, sizeof(header)) || !equal(MAGIC, MAGIC + sizeof(MAGIC), header) ||
+        header[sizeof(MAGIC)] != VERSION) {
+        return;
+    }
+    m_hasInstructions = (header[sizeof(MAGIC) + 1] & HAS_INSTRUCTIONS) != 0;
+    m_isOpen = true;
+}
+
+/*
+NAME:
+
+    getVarint() - reads the next varint
+
+SYNOPSIS:
+
+    bool TraceReader::getVarint(unsigned long long& a_value);
+    a_value     --> set to the varint
+
+DESCRIPTION:
+
+    The buffer is refilled from the file whenever it has been decoded to its end, so the
+    trace is read as a stream whatever its length.
+
+RETURNS:
+
+    bool - returns true if a varint was read, false at the end of the file
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+bool TraceReader::getVarint(unsigned long long& a_value)
+{
+    a_value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (m_next == m_used) {
+            m_file.read(reinterpret_cast<char*>(m_buffer.data()), static_cast<streamsize>(m_buffer.size()));
+            m_used = static_cast<size_t>(m_file.gcount());
+            m_next = 0;
+            if (m_used == 0) {
+                return false;
+            }
+        }
+        unsigned char byte = m_buffer[m_next++];
+        a_value |= static_cast<unsigned long long>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+NAME:
+
+    readInstruction() - reads the rest of an instruction record
+
+SYNOPSIS:
+
+    bool TraceReader::readInstruction(unsigned long long a_first);
+    a_first     --> the record's first varint
+
+RETURNS:
+
+    bool - returns true if the record was read whole, false if the file ended in it
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+bool TraceReader::readInstruction(unsigned long long a_first)
+{
+    m_location = static_cast<int>(m_location + 1 + unzigzag(a_first >> 11));
+    unsigned changed = static_cast<unsigned>(a_first >> 1) & 0x3ff;
+    for (int reg = 0; changed != 0; reg++, changed >>= 1) {
+        unsigned long long difference;
+        if ((changed & 1) != 0) {
+            if (!getVarint(difference)) {
+                return false;
+            }
+            m_reg[reg] = static_cast<MemoryWord>(static_cast<unsigned long long>(m_reg[reg]) + unzigzag(difference));
+        }
+    }
+    return true;
+}
+
+/*
+NAME:
+
+    skipToInput() - reads up to the next number read
+
+SYNOPSIS:
+
+    bool TraceReader::skipToInput(unsigned long long& a_first);
+    a_first     --> set to the first varint of the input record
+
+RETURNS:
+
+    bool - returns true if an input record was found, false at the end of the file
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+bool TraceReader::skipToInput(unsigned long long& a_first)
+{
+    while (getVarint(a_first)) {
+        if ((a_first & 1) == 0) {
+            return true;
+        }
+        if (!readInstruction(a_first)) {
+            return false;
+        }
+    }
+    return false;
+}
+
+/*
+NAME:
+
+    nextInput() - takes the next number read by the recorded run
+
+SYNOPSIS:
+
+    bool TraceReader::nextInput(int& a_value);
+    a_value     --> set to the number, or left unchanged if there is none
+
+DESCRIPTION:
+
+    In a trace with instructions, the number follows the record of the READ that took it,
+    which checkInstruction() has just read. Instructions recorded before the number mean the
+    replay reached a READ the recorded run did not, so the replay has differed from the trace
+    here, if not before; they are passed over to the number.
+
+RETURNS:
+
+    bool - returns true if there was a number, false at the end of the trace
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+bool TraceReader::nextInput(int& a_value)
+{
+    unsigned long long first;
+    if (!getVarint(first)) {
+        if (!m_hasDiverged) {
+            m_hasDiverged = true;
+            m_divergence = -1;
+        }
+        return false;
+    }
+    if ((first & 1) != 0) {
+        if (!m_hasDiverged) {
+            m_hasDiverged = true;
+            m_divergence = m_location;
+        }
+        if (!readInstruction(first) || !skipToInput(first)) {
+            return false;
+        }
+    }
+    a_value = static_cast<int>(static_cast<long long>(unzigzag(first >> 1)));
+    return true;
+}
+
+/*
+NAME:
+
+    checkInstruction() - checks an instruction of the replay against the trace
+
+SYNOPSIS:
+
+    bool TraceReader::checkInstruction(int a_location, const MemoryWord* a_reg);
+    a_location  --> the location of the instruction about to be executed
+    a_reg       --> the registers, before it is executed
+
+DESCRIPTION:
+
+    The next instruction record is read and its location and registers compared with the
+    replay's. Once the replay has differed, nothing more is checked, and the instruction
+    records are left for nextInput() to pass over.
+
+RETURNS:
+
+    bool - returns true if the instruction is as recorded, false otherwise
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+bool TraceReader::checkInstruction(int a_location, const MemoryWord* a_reg)
+{
+    if (m_hasDiverged) {
+        return false;
+    }
+    unsigned long long first;
+    bool isRecorded = getVarint(first) && (first & 1) != 0 && readInstruction(first) && m_location == a_location;
+    for (int reg = 0; reg < TraceWriter::REGISTERS && isRecorded; reg++) {
+        isRecorded = m_reg[reg] == a_reg[reg];
+    }
+    if (!isRecorded) {
+        m_hasDiverged = true;
+        m_divergence = a_location;
+        return false;
+    }
+    m_matched++;
+    return true;
+}
@@ -0,0 +1,182 @@
+//
+//		Execution traces - record a run of a VC8000 program so that it can be replayed exactly
+//
+#ifndef _EXECUTIONTRACE_H
+#define _EXECUTIONTRACE_H
+
+#include "MemoryWord.h"
+#include "IoDevices.h"
+
+// A trace is a binary file: the bytes "VC8T", a version byte and a flags byte, then one record
+// for each number a READ took and, if the flags say so, one for each instruction executed, in
+// the order they happened.  Every record is a sequence of varints, seven bits to a byte with
+// the high bit set on all but the last.  The first varint's low bit tells the records apart:
+//
+//     input:        zigzag(number) << 1
+//     instruction:  zigzag(location - last location - 1) << 11 | changed registers << 1 | 1,
+//                   then zigzag(new - old) for each changed register, lowest first
+//
+// An instruction record is made before the instruction is executed, so the registers it shows
+// as changed are those the instruction before it changed.  A program that runs straight
+// through memory and changes one low register per instruction takes two or three bytes an
+// instruction.
+
+// Writes a trace to a file as the run goes, through a buffer of fixed size, so a run of any
+// length takes no more memory to record than a short one.
+class TraceWriter {
+
+public:
+
+    const static int REGISTERS = 10;    // The number of VC8000 registers.
+
+    // Creates the file and writes its header.  Instructions are recorded only if
+    // a_hasInstructions.  isOpen() tells whether the file could be created.
+    TraceWriter(const string& a_fileName, bool a_hasInstructions);
+    ~TraceWriter() { flush(); }
+
+    TraceWriter(const TraceWriter&) = delete;
+    TraceWriter& operator=(const TraceWriter&) = delete;
+
+    // Checks whether the file could be created and every byte so far written to it.
+    bool isOpen() const { return static_cast<bool>(m_file); }
+
+    // Checks whether instructions are recorded, rather than only the numbers read.
+    bool hasInstructions() const { return m_hasInstructions; }
+
+    // Records a number taken by a READ.
+    void recordInput(int a_value);
+
+    // Records an instruction about to be executed at a location, with the registers as the
+    // instructions before it left them.
+    void recordInstruction(int a_location, const MemoryWord* a_reg);
+
+    // Writes the buffer to the file.
+    void flush();
+
+    // Return the numbers and instructions recorded, and the bytes of the trace.
+    long long getInputs() const { return m_inputs; }
+    long long getInstructions() const { return m_instructions; }
+    long long getBytes() const { return m_written + static_cast<long long>(m_used); }
+
+private:
+
+    // Adds a varint to the buffer.
+    void putVarint(unsigned long long a_value) {
+        if (m_used + 10 > m_buffer.size()) {
+            flush();
+        }
+        while (a_value >= 0x80) {
+            m_buffer[m_used++] = static_cast<unsigned char>(a_value | 0x80);
+            a_value >>= 7;
+        }
+        m_buffer[m_used++] = static_cast<unsigned char>(a_value);
+    }
+
+    ofstream m_file;                    // The trace.
+    vector<unsigned char> m_buffer;     // The bytes not yet written to the file.
+    size_t m_used = 0;                  // The number of bytes of m_buffer in use.
+    long long m_written = 0;            // The bytes written to the file.
+    bool m_hasInstructions;             // == true if instructions are recorded.
+    int m_lastLocation = -1;            // The location of the last instruction recorded.
+    MemoryWord m_lastReg[REGISTERS] = { 0 };    // The registers in the last record.
+    long long m_inputs = 0;             // The numbers recorded.
+    long long m_instructions = 0;       // The instructions recorded.
+};
+
+// Reads a trace back, as the run it records is replayed.  When the trace has instructions,
+// each instruction of the replay is checked against it, and the first one that differs in
+// location or registers is remembered.
+class TraceReader {
+
+public:
+
+    // Opens the file and reads its header.  isOpen() tells whether it is a trace.
+    explicit TraceReader(const string& a_fileName);
+
+    TraceReader(const TraceReader&) = delete;
+    TraceReader& operator=(const TraceReader&) = delete;
+
+    // Checks whether the file could be opened and has the header of a trace.
+    bool isOpen() const { return m_isOpen; }
+
+    // Checks whether the trace records instructions, rather than only the numbers read.
+    bool hasInstructions() const { return m_hasInstructions; }
+
+    // Takes the next number read by the recorded run.  Returns false if there is none.
+    bool nextInput(int& a_value);
+
+    // Checks an instruction about to be executed against the next one recorded.  Returns
+    // false if it differs, or has differed before.
+    bool checkInstruction(int a_location, const MemoryWord* a_reg);
+
+    // Returns the number of instructions checked and found as recorded, and whether and where
+    // the replay first differed from the trace: the location of the replay's instruction, or
+    // -1 if it ran past the end of the trace.
+    long long getMatched() const { return m_matched; }
+    bool hasDiverged() const { return m_hasDiverged; }
+    int getDivergence() const { return m_divergence; }
+
+private:
+
+    // Reads the next varint.  Returns false at the end of the file.
+    bool getVarint(unsigned long long& a_value);
+
+    // Reads the rest of an instruction record whose first varint was a_first, updating the
+    // location and registers.
+    bool readInstruction(unsigned long long a_first);
+
+    // Reads the rest of the records of instructions up to the next number read, for a READ of
+    // a replay that has already differed from the trace.  Returns false at the end.
+    bool skipToInput(unsigned long long& a_first);
+
+    ifstream m_file;                    // The trace.
+    vector<unsigned char> m_buffer;     // Bytes read from the file and not yet decoded.
+    size_t m_next = 0;                  // The index of the next byte of m_buffer to decode.
+    size_t m_used = 0;                  // The number of bytes of m_buffer read.
+    bool m_isOpen = false;              // == true if the file is a trace.
+    bool m_hasInstructions = false;     // == true if the trace records instructions.
+    int m_location = -1;                // The location of the last instruction read.
+    MemoryWord m_reg[TraceWriter::REGISTERS] = { 0 };   // The registers of the last one read.
+    long long m_matched = 0;            // The instructions found as recorded.
+    bool m_hasDiverged = false;         // == true once an instruction differed.
+    int m_divergence = -1;              // Where it differed.
+};
+
+// Takes numbers from another device, recording each one in a trace.
+class RecordingInput : public InputDevice {
+
+public:
+
+    RecordingInput(shared_ptr<InputDevice> a_input, TraceWriter& a_trace) : m_input(a_input), m_trace(a_trace) { }
+
+    // The number recorded is the one READ stores, which is 0 when a device finds none.
+    bool read(int& a_value) override {
+        bool isRead = m_input->read(a_value);
+        m_trace.recordInput(a_value);
+        return isRead;
+    }
+    bool isInteractive() const override { return m_input->isInteractive(); }
+    bool hasInput() override { return m_input->hasInput(); }
+
+private:
+
+    shared_ptr<InputDevice> m_input;    // The device the numbers come from.
+    TraceWriter& m_trace;               // Where they are recorded.
+};
+
+// Supplies the numbers recorded in a trace, without prompting.
+class ReplayInput : public InputDevice {
+
+public:
+
+    explicit ReplayInput(TraceReader& a_trace) : m_trace(a_trace) { }
+
+    bool read(int& a_value) override { return m_trace.nextInput(a_value); }
+    bool isInteractive() const override { return false; }
+
+private:
+
+    TraceReader& m_trace;               // Where the numbers come from.
+};
+
+#endif
@@ -22,7 +22,15 @@ SYNOPSIS:
 DESCRIPTION:
 
     "argc" will tell the program how many arguments were provided. It must be at least 2: one for the filename
-    and one for the program name. ( for example: helloworld input.txt)
+    and one for the program name. ( for example: helloworld input.txt) It is 4 when the assembler is asked
+    to write a C++ translation ( for example: helloworld input.txt -cpp input.cpp), and at least 4 when it
+    is asked to run the translation on several cores ( for example: helloworld input.txt -cores main worker)
+    , and 6 when the run is limited ( for example: helloworld input.txt -limits 1000000 5000 100, where 0 is
+    no limit). It is 3 when the run is profiled, its phases measured, the program verified first or its cost
+    estimated ( for example: helloworld input.txt -profile, helloworld input.txt -perf, helloworld input.txt -verify
+    or helloworld input.txt -cost), and 4 or 5 when the run is recorded or
+    replayed ( for example: helloworld input.txt -record run.trace -instructions, or helloworld input.txt
+    -replay run.trace)
     "*argv[]" is an array of characters where argv[0] usually holds the name of the program itself, and argv[1]
     , and so on hold a additional arguments when running the program. The constructor checks if correct number 
     of arguments are provided, and displays message accordingly. 
@@ -44,9 +52,26 @@ DATE:
 */
 FileAccess::FileAccess( int argc, char *argv[] )
 {
-    // Check that there is exactly one run time parameter.
-    if( argc != 2 ) {
-        cerr << "Usage: Assem <FileName>" << endl;
+    // Check that there is a file name, optionally followed by -cpp and the name of the C++ translation,
+    // by -cores and the labels the cores start at, by -limits and the limits on the run, or by
+    // -profile, -perf, -verify or -cost, or by -record or -replay and the name of a trace file.
+    if( argc != 2 && !( argc == 3 && ( string( argv[2] ) == "-profile" || string( argv[2] ) == "-perf" ||
+                                       string( argv[2] ) == "-verify" || string( argv[2] ) == "-cost" ) ) &&
+        !( argc == 4 && ( string( argv[2] ) == "-cpp" || string( argv[2] ) == "-record" || string( argv[2] ) == "-replay" ) ) &&
+        !( argc == 5 && string( argv[2] ) == "-record" && string( argv[4] ) == "-instructions" ) &&
+        !( argc >= 4 && string( argv[2] ) == "-cores" ) &&
+        !( argc == 6 && string( argv[2] ) == "-limits" ) ) {
+        cerr << "Usage: Assem <FileName> [-cpp <C++ FileName>]" << endl;
+        cerr << "       Assem <FileName> -cores <Label> [<Label> ...]" << endl;
+        cerr << "       Assem <FileName> -limits <Instructions> <Milliseconds> <Pages>" << endl;
+        cerr << "       Assem <FileName> -profile" << endl;
+        cerr << "       Assem <FileName> -perf" << endl;
+        cerr << "       Assem <FileName> -verify" << endl;
+        cerr << "       Assem <FileName> -cost" << endl;
+        cerr << "       Assem <FileName> -record <TraceFile> [-instructions]" << endl;
+        cerr << "       Assem <FileName> -replay <TraceFile>" << endl;
+        cerr << "       Assem -batch <ManifestFile> [<Threads>] [-lockstep] [-telemetry <Name>]" << endl;
+        cerr << "       Assem -watch <Name>" << endl;
         exit( 1 );
     }
     // Open the file.  One might question if this is the best place to open the file.
@@ -61,6 +86,48 @@ FileAccess::FileAccess( int argc, char *argv[] )
     }
 }
 
+/*
+
+NAME:
+
+    FileAccess - constructor function that opens a named file
+
+SYNOPSIS:
+
+    FileAccess( const string &a_fileName )
+    a_fileName  -> the name of the source file
+
+DESCRIPTION:
+
+    Used when the file name does not come from the command line, as in batch mode, where the
+    manifest names many source files. A file that cannot be opened is reported and the
+    program terminated, as for the file named on the command line.
+
+RETURNS:
+
+    construction class
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+FileAccess::FileAccess( const string &a_fileName )
+{
+    m_sfile.open( a_fileName, ios::in );
+
+    if( ! m_sfile ) {
+        cerr << "Source file " << a_fileName << " could not be opened, assembler terminated."
+            << endl;
+        exit( 1 );
+    }
+}
+
 /*
 NAME:
 
@@ -15,6 +15,9 @@ public:
     // Opens the file.
     FileAccess( int argc, char *argv[] );
 
+    // Opens a named file, as the batch runner does for each program.
+    explicit FileAccess( const string &a_fileName );
+
     // Closes the file.
     ~FileAccess( );
 
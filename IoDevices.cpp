@@ -0,0 +1,785 @@
+//
+//		Implementation of the I/O devices.
+//
+#include "stdafx.h"
+#include "IoDevices.h"
+#include "Errors.h"
+
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    // Room for the longest word, its sign and the end of the line.
+    const int WORD_TEXT_SIZE = 24;
+
+    // Formats a word followed by the end of a line, as ostream << word << endl would, into
+    // a_text.  Returns the number of characters.
+    size_t formatWord(MemoryWord a_word, char* a_text)
+    {
+        char digits[WORD_TEXT_SIZE];
+        int count = 0;
+        unsigned long long magnitude = a_word < 0 ? 0 - static_cast<unsigned long long>(a_word)
+                                                  : static_cast<unsigned long long>(a_word);
+        do {
+            digits[count++] = static_cast<char>('0' + magnitude % 10);
+            magnitude /= 10;
+        } while (magnitude != 0);
+
+        size_t length = 0;
+        if (a_word < 0) {
+            a_text[length++] = '-';
+        }
+        while (count > 0) {
+            a_text[length++] = digits[--count];
+        }
+        a_text[length++] = '\n';
+        return length;
+    }
+}
+
+/*
+NAME:
+
+    writeError() - reports an error that stopped the program
+
+SYNOPSIS:
+
+    void OutputDevice::writeError(const string& a_message);
+    a_message   --> the error
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void OutputDevice::writeError(const string& a_message)
+{
+    Errors::RecordError(a_message);
+    Errors::DisplayErrors();
+}
+
+/*
+NAME:
+
+    supply() - adds a number to be read
+
+SYNOPSIS:
+
+    void QueueInput::supply(int a_value);
+    a_value     --> the number
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void QueueInput::supply(int a_value)
+{
+    lock_guard<mutex> lock(m_lock);
+    m_values.push_back(a_value);
+}
+
+/*
+NAME:
+
+    close() - marks the end of the input
+
+SYNOPSIS:
+
+    void QueueInput::close();
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void QueueInput::close()
+{
+    lock_guard<mutex> lock(m_lock);
+    m_isClosed = true;
+}
+
+/*
+NAME:
+
+    read() - takes the oldest number added
+
+SYNOPSIS:
+
+    bool QueueInput::read(int& a_value);
+    a_value     --> set to the number
+
+RETURNS:
+
+    bool - returns false, leaving a_value unchanged, if no number is waiting
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+bool QueueInput::read(int& a_value)
+{
+    lock_guard<mutex> lock(m_lock);
+    if (m_values.empty()) {
+        return false;
+    }
+    a_value = m_values.front();
+    m_values.pop_front();
+    return true;
+}
+
+/*
+NAME:
+
+    hasInput() - checks whether a READ can go ahead
+
+SYNOPSIS:
+
+    bool QueueInput::hasInput();
+
+RETURNS:
+
+    bool - returns true if a number is waiting or the input has been closed
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+bool QueueInput::hasInput()
+{
+    lock_guard<mutex> lock(m_lock);
+    return !m_values.empty() || m_isClosed;
+}
+
+/*
+NAME:
+
+    MappedFileInput() - maps a file of numbers into memory
+
+SYNOPSIS:
+
+    MappedFileInput::MappedFileInput(const string& a_fileName);
+    a_fileName  --> the name of the file
+
+DESCRIPTION:
+
+    The whole file is mapped read only, so reading it costs no system calls after this one.
+    A file that cannot be opened leaves the device with no input; isOpen() tells the caller.
+
+RETURNS:
+
+    constructor, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+MappedFileInput::MappedFileInput(const string& a_fileName)
+{
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(a_fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return;
+    }
+    m_isOpen = true;
+    LARGE_INTEGER size;
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+        m_mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (m_mapping != nullptr) {
+            m_view = static_cast<const char*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+            if (m_view != nullptr) {
+                m_size = static_cast<size_t>(size.QuadPart);
+            }
+        }
+    }
+    CloseHandle(file);
+#else
+    int file = open(a_fileName.c_str(), O_RDONLY);
+    if (file < 0) {
+        return;
+    }
+    m_isOpen = true;
+    struct stat status;
+    if (fstat(file, &status) == 0 && status.st_size > 0) {
+        void* view = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+        if (view != MAP_FAILED) {
+            m_view = static_cast<const char*>(view);
+            m_size = static_cast<size_t>(status.st_size);
+        }
+    }
+    close(file);
+#endif
+    m_next = m_view;
+    m_end = m_view + m_size;
+}
+
+/*
+NAME:
+
+    ~MappedFileInput() - unmaps the file
+
+SYNOPSIS:
+
+    MappedFileInput::~MappedFileInput();
+
+RETURNS:
+
+    destructor, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+MappedFileInput::~MappedFileInput()
+{
+#if defined(_WIN32)
+    if (m_view != nullptr) {
+        UnmapViewOfFile(m_view);
+    }
+    if (m_mapping != nullptr) {
+        CloseHandle(m_mapping);
+    }
+#else
+    if (m_view != nullptr) {
+        munmap(const_cast<char*>(m_view), m_size);
+    }
+#endif
+}
+
+/*
+NAME:
+
+    read() - reads the next number in the file
+
+SYNOPSIS:
+
+    bool MappedFileInput::read(int& a_value);
+    a_value     --> set to the number
+
+RETURNS:
+
+    bool - returns false, leaving a_value unchanged, if there are no more numbers
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+bool MappedFileInput::read(int& a_value)
+{
+    return parseNumber(m_next, m_end, a_value);
+}
+
+/*
+NAME:
+
+    parseNumber() - parses a number from text
+
+SYNOPSIS:
+
+    bool MappedFileInput::parseNumber(const char*& a_next, const char* a_end, int& a_value);
+    a_next      --> the text, moved past the number
+    a_end       --> the end of the text
+    a_value     --> set to the number
+
+DESCRIPTION:
+
+    Accepts what stream extraction of an int does: white space, an optional sign and
+    decimal digits. Once text that is not a number is reached, it is never passed, so no
+    more numbers are read, just as a stream stops reading once extraction fails.
+
+RETURNS:
+
+    bool - returns false, leaving a_value unchanged, if there is no number
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+bool MappedFileInput::parseNumber(const char*& a_next, const char* a_end, int& a_value)
+{
+    const char* next = a_next;
+    while (next < a_end && (*next == ' ' || (*next >= '\t' && *next <= '\r'))) {
+        next++;
+    }
+    bool isNegative = false;
+    if (next < a_end && (*next == '-' || *next == '+')) {
+        isNegative = (*next == '-');
+        next++;
+    }
+    if (next == a_end || *next < '0' || *next > '9') {
+        return false;
+    }
+
+    // Accumulate in a wider type, stopping once the value is certainly out of range.
+    long long value = 0;
+    for (; next < a_end && *next >= '0' && *next <= '9'; next++) {
+        if (value <= INT_MAX) {
+            value = value * 10 + (*next - '0');
+        }
+    }
+    if (isNegative) {
+        value = -value;
+    }
+    a_value = static_cast<int>(value > INT_MAX ? INT_MAX : (value < INT_MIN ? INT_MIN : value));
+    a_next = next;
+    return true;
+}
+
+/*
+NAME:
+
+    BufferedOutput() - creates a buffer in front of a stream
+
+SYNOPSIS:
+
+    BufferedOutput::BufferedOutput(ostream& a_stream, size_t a_capacity);
+    a_stream    --> the stream the output is passed to
+    a_capacity  --> the size of the buffer in bytes
+
+RETURNS:
+
+    constructor, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+BufferedOutput::BufferedOutput(ostream& a_stream, size_t a_capacity)
+: m_stream(a_stream),
+  m_buffer(a_capacity > WORD_TEXT_SIZE ? a_capacity : WORD_TEXT_SIZE)
+{
+}
+
+/*
+NAME:
+
+    writeWord() - writes a word on a line of its own
+
+SYNOPSIS:
+
+    void BufferedOutput::writeWord(MemoryWord a_word);
+    a_word      --> the word
+
+DESCRIPTION:
+
+    The word is formatted straight into the buffer, without the stream's formatting.
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void BufferedOutput::writeWord(MemoryWord a_word)
+{
+    if (m_buffer.size() - m_used < WORD_TEXT_SIZE) {
+        flush();
+    }
+    m_used += formatWord(a_word, m_buffer.data() + m_used);
+}
+
+/*
+NAME:
+
+    writeText() - writes text
+
+SYNOPSIS:
+
+    void BufferedOutput::writeText(const string& a_text);
+    a_text      --> the text
+
+DESCRIPTION:
+
+    Text longer than the buffer is passed straight to the stream.
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void BufferedOutput::writeText(const string& a_text)
+{
+    if (m_buffer.size() - m_used < a_text.size()) {
+        flush();
+        if (a_text.size() > m_buffer.size()) {
+            m_stream.write(a_text.data(), a_text.size());
+            return;
+        }
+    }
+    std::copy(a_text.begin(), a_text.end(), m_buffer.begin() + m_used);
+    m_used += a_text.size();
+}
+
+/*
+NAME:
+
+    flush() - passes the buffer to the stream
+
+SYNOPSIS:
+
+    void BufferedOutput::flush();
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void BufferedOutput::flush()
+{
+    if (m_used > 0) {
+        m_stream.write(m_buffer.data(), m_used);
+        m_used = 0;
+    }
+    m_stream.flush();
+}
+
+/*
+NAME:
+
+    AsyncOutput() - creates the ring buffer and starts the writer thread
+
+SYNOPSIS:
+
+    AsyncOutput::AsyncOutput(ostream& a_stream, size_t a_capacity);
+    a_stream    --> the stream the output is written to; only the writer uses it from now on
+    a_capacity  --> the size of the ring in bytes, rounded up to a power of two
+
+RETURNS:
+
+    constructor, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+AsyncOutput::AsyncOutput(ostream& a_stream, size_t a_capacity)
+: m_stream(a_stream)
+{
+    size_t size = 1;
+    while (size < a_capacity || size < WORD_TEXT_SIZE) {
+        size *= 2;
+    }
+    m_ring.resize(size);
+    m_mask = size - 1;
+    m_writer = thread(&AsyncOutput::writeOut, this);
+}
+
+/*
+NAME:
+
+    ~AsyncOutput() - writes out what is left and stops the writer thread
+
+SYNOPSIS:
+
+    AsyncOutput::~AsyncOutput();
+
+RETURNS:
+
+    destructor, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+AsyncOutput::~AsyncOutput()
+{
+    m_isClosing.store(true, memory_order_release);
+    m_writer.join();
+}
+
+/*
+NAME:
+
+    writeWord(), writeText() - add output to the ring
+
+SYNOPSIS:
+
+    void AsyncOutput::writeWord(MemoryWord a_word);
+    void AsyncOutput::writeText(const string& a_text);
+    a_word      --> a word, written on a line of its own
+    a_text      --> text, written exactly as given
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void AsyncOutput::writeWord(MemoryWord a_word)
+{
+    char text[WORD_TEXT_SIZE];
+    put(text, formatWord(a_word, text));
+}
+
+void AsyncOutput::writeText(const string& a_text)
+{
+    put(a_text.data(), a_text.size());
+}
+
+/*
+NAME:
+
+    put() - copies bytes into the ring
+
+SYNOPSIS:
+
+    void AsyncOutput::put(const char* a_bytes, size_t a_length);
+    a_bytes     --> the bytes
+    a_length    --> the number of bytes
+
+DESCRIPTION:
+
+    The bytes are copied into the free part of the ring, and m_added is advanced with a
+    release store so that the writer sees them once it sees the new count. While the ring
+    is full, the thread yields to the writer.
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void AsyncOutput::put(const char* a_bytes, size_t a_length)
+{
+    size_t added = m_added.load(memory_order_relaxed);
+    while (a_length > 0) {
+        size_t room = m_ring.size() - (added - m_written.load(memory_order_acquire));
+        if (room == 0) {
+            this_thread::yield();
+            continue;
+        }
+        size_t count = (a_length < room ? a_length : room);
+        for (size_t byte = 0; byte < count; byte++) {
+            m_ring[(added + byte) & m_mask] = a_bytes[byte];
+        }
+        added += count;
+        a_bytes += count;
+        a_length -= count;
+        m_added.store(added, memory_order_release);
+    }
+}
+
+/*
+NAME:
+
+    flush() - waits until everything added has been written
+
+SYNOPSIS:
+
+    void AsyncOutput::flush();
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void AsyncOutput::flush()
+{
+    size_t added = m_added.load(memory_order_relaxed);
+    while (m_written.load(memory_order_acquire) != added) {
+        this_thread::yield();
+    }
+}
+
+/*
+NAME:
+
+    writeOut() - empties the ring into the stream
+
+SYNOPSIS:
+
+    void AsyncOutput::writeOut();
+
+DESCRIPTION:
+
+    Runs on the writer thread. Whatever has been added is written in at most two pieces,
+    one on each side of the end of the ring. The stream is flushed whenever the ring is
+    empty, before m_written is advanced, so that flush() returns only once the output has
+    reached the stream's destination. While there is nothing to write the thread yields,
+    and sleeps once it has been idle for a while.
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void AsyncOutput::writeOut()
+{
+    size_t written = 0;
+    int idle = 0;
+    for (;;) {
+        bool isClosing = m_isClosing.load(memory_order_acquire);
+        size_t added = m_added.load(memory_order_acquire);
+        if (added == written) {
+            if (isClosing) {
+                return;
+            }
+            if (++idle < 64) {
+                this_thread::yield();
+            }
+            else {
+                this_thread::sleep_for(chrono::microseconds(100));
+            }
+            continue;
+        }
+        idle = 0;
+        size_t start = written & m_mask;
+        size_t length = added - written;
+        size_t first = (length < m_ring.size() - start ? length : m_ring.size() - start);
+        m_stream.write(m_ring.data() + start, first);
+        if (first < length) {
+            m_stream.write(m_ring.data(), length - first);
+        }
+        written = added;
+        if (m_added.load(memory_order_acquire) == written) {
+            m_stream.flush();
+        }
+        m_written.store(written, memory_order_release);
+    }
+}
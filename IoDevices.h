@@ -0,0 +1,233 @@
+//
+//		I/O devices - where the emulator's READs take their input and its WRITEs go
+//
+#ifndef _IODEVICES_H
+#define _IODEVICES_H
+
+#include "MemoryWord.h"
+
+// The devices are chosen when an emulator is created.  The run loop calls them only for
+// READ and WRITE, through one virtual call, and never checks which device it has.
+
+// Supplies the numbers read by READ.
+class InputDevice {
+
+public:
+
+    virtual ~InputDevice() { }
+
+    // Reads the next number.  Returns false, leaving a_value unchanged, if there is none.
+    virtual bool read(int& a_value) = 0;
+
+    // Checks whether a prompt is displayed, and the output flushed, before each READ.
+    virtual bool isInteractive() const = 0;
+
+    // Checks whether read() can return at once.  When it cannot, the READ pauses the program
+    // instead of waiting.  Devices that are never short of input, or that wait for it
+    // themselves, always return true.
+    virtual bool hasInput() { return true; }
+};
+
+// Receives the words written by WRITE and the emulator's messages.
+class OutputDevice {
+
+public:
+
+    virtual ~OutputDevice() { }
+
+    // Writes a word on a line of its own.
+    virtual void writeWord(MemoryWord a_word) = 0;
+
+    // Writes text exactly as given.
+    virtual void writeText(const string& a_text) = 0;
+
+    // Passes everything written so far on to its destination.
+    virtual void flush() = 0;
+
+    // Reports an error that stopped the program.  Unless the device takes errors itself,
+    // they are recorded and displayed by the Errors class.
+    virtual void writeError(const string& a_message);
+};
+
+// Reads numbers typed at the console, or from any stream, prompting before each one.
+class ConsoleInput : public InputDevice {
+
+public:
+
+    explicit ConsoleInput(istream& a_stream = cin) : m_stream(a_stream) { }
+
+    bool read(int& a_value) override { return static_cast<bool>(m_stream >> a_value); }
+    bool isInteractive() const override { return true; }
+
+private:
+
+    istream& m_stream;
+};
+
+// Supplies numbers given in advance, without prompting.
+class VectorInput : public InputDevice {
+
+public:
+
+    explicit VectorInput(const vector<int>& a_values) : m_values(a_values) { }
+
+    bool read(int& a_value) override {
+        if (m_next == m_values.size()) {
+            return false;
+        }
+        a_value = m_values[m_next++];
+        return true;
+    }
+    bool isInteractive() const override { return false; }
+
+private:
+
+    vector<int> m_values;   // The numbers.
+    size_t m_next = 0;      // The index of the next one to be read.
+};
+
+// Supplies numbers as they are added by another thread, without prompting.  Until the
+// device is closed, a program that reads past the numbers added so far pauses at the READ.
+class QueueInput : public InputDevice {
+
+public:
+
+    QueueInput() { }
+
+    QueueInput(const QueueInput&) = delete;
+    QueueInput& operator=(const QueueInput&) = delete;
+
+    // Adds a number to be read.
+    void supply(int a_value);
+
+    // Marks the end of the input.  READs past it no longer pause, and find no number.
+    void close();
+
+    bool read(int& a_value) override;
+    bool isInteractive() const override { return false; }
+    bool hasInput() override;
+
+private:
+
+    mutex m_lock;               // Guards the members below.
+    deque<int> m_values;        // The numbers added and not yet read.
+    bool m_isClosed = false;    // == true once no more numbers will be added.
+};
+
+// Supplies the numbers in a file, without prompting.  The file is mapped into memory and
+// each number is parsed from it as it is read.
+class MappedFileInput : public InputDevice {
+
+public:
+
+    explicit MappedFileInput(const string& a_fileName);
+    ~MappedFileInput();
+
+    MappedFileInput(const MappedFileInput&) = delete;
+    MappedFileInput& operator=(const MappedFileInput&) = delete;
+
+    // Checks whether the file could be opened.
+    bool isOpen() const { return m_isOpen; }
+
+    bool read(int& a_value) override;
+    bool isInteractive() const override { return false; }
+
+    // Parses the number that starts after any white space at a_next, and moves a_next past
+    // it.  Returns false if there is no number there.  Values beyond the range of an int
+    // are clamped to it, as stream extraction does.
+    static bool parseNumber(const char*& a_next, const char* a_end, int& a_value);
+
+private:
+
+    const char* m_view = nullptr;   // The contents of the file.
+    const char* m_next = nullptr;   // Where the next number starts.
+    const char* m_end = nullptr;    // The end of the file.
+    size_t m_size = 0;              // The size of the mapped view.
+    bool m_isOpen = false;          // == true if the file was opened.
+#if defined(_WIN32)
+    HANDLE m_mapping = nullptr;     // The file mapping object behind the view.
+#endif
+};
+
+// Writes to the console, or to any stream, flushing after every line as the emulator
+// always has.
+class ConsoleOutput : public OutputDevice {
+
+public:
+
+    explicit ConsoleOutput(ostream& a_stream = cout) : m_stream(a_stream) { }
+
+    void writeWord(MemoryWord a_word) override { m_stream << a_word << endl; }
+    void writeText(const string& a_text) override { m_stream << a_text << std::flush; }
+    void writeError(const string& a_message) override { writeText(a_message + "\n"); }
+    void flush() override { m_stream.flush(); }
+
+private:
+
+    ostream& m_stream;
+};
+
+// Formats output into a large buffer, and passes the buffer to a stream only when it is full
+// or flushed.  Errors are written with the output, so that the errors of emulators sharing a
+// thread, as under the Scheduler, each go to their own device.
+class BufferedOutput : public OutputDevice {
+
+public:
+
+    explicit BufferedOutput(ostream& a_stream, size_t a_capacity = 1 << 20);
+    ~BufferedOutput() { flush(); }
+
+    BufferedOutput(const BufferedOutput&) = delete;
+    BufferedOutput& operator=(const BufferedOutput&) = delete;
+
+    void writeWord(MemoryWord a_word) override;
+    void writeText(const string& a_text) override;
+    void writeError(const string& a_message) override { writeText(a_message + "\n"); }
+    void flush() override;
+
+private:
+
+    ostream& m_stream;
+    vector<char> m_buffer;      // The output not yet passed to the stream.
+    size_t m_used = 0;          // The number of bytes of m_buffer in use.
+};
+
+// Formats output into a ring buffer that a writer thread empties into a stream, so that the
+// emulator never waits for the stream.  The emulator's thread is the only one that adds to
+// the ring and the writer the only one that takes from it, so neither takes a lock.
+class AsyncOutput : public OutputDevice {
+
+public:
+
+    // a_capacity is rounded up to a power of two.
+    explicit AsyncOutput(ostream& a_stream, size_t a_capacity = 1 << 20);
+    ~AsyncOutput();
+
+    AsyncOutput(const AsyncOutput&) = delete;
+    AsyncOutput& operator=(const AsyncOutput&) = delete;
+
+    void writeWord(MemoryWord a_word) override;
+    void writeText(const string& a_text) override;
+    void writeError(const string& a_message) override { writeText(a_message + "\n"); }
+
+    // Waits until the writer has passed everything to the stream and flushed it.
+    void flush() override;
+
+private:
+
+    // Copies bytes into the ring, waiting for the writer to make room if it is full.
+    void put(const char* a_bytes, size_t a_length);
+
+    // The writer thread: empties the ring into the stream until the device is destroyed.
+    void writeOut();
+
+    ostream& m_stream;
+    vector<char> m_ring;            // The bytes not yet written; the index is masked.
+    size_t m_mask;                  // m_ring.size() - 1.
+    atomic<size_t> m_added{ 0 };    // Bytes ever added, advanced by the emulator's thread.
+    atomic<size_t> m_written{ 0 };  // Bytes ever written, advanced by the writer.
+    atomic<bool> m_isClosing{ false };  // == true once the writer is to finish.
+    thread m_writer;                // Runs writeOut().
+};
+
+#endif
@@ -0,0 +1,927 @@
+//
+//		Implementation of the JitCompiler class.
+//
+#include "stdafx.h"
+#include "JitCompiler.h"
+
+#if VC8000_JIT && !defined(_WIN32)
+#include <sys/mman.h>
+#endif
+
+namespace {
+
+#if VC8000_JIT
+    // The host register that holds each VC8000 register while translated code runs:
+    // rbx, rbp, r12 - r15 and r8 - r11.  rax, rcx and rdx are left for scratch.
+    const int VC_REGISTER[10] = { 3, 5, 12, 13, 14, 15, 8, 9, 10, 11 };
+
+    // x86-64 op codes.  Values above 0xFF are two byte op codes.
+    const int X86_ADD = 0x03;
+    const int X86_SUB = 0x2B;
+    const int X86_IMUL = 0x0FAF;
+    const int X86_LOAD = 0x8B;      // mov reg, r/m
+    const int X86_STORE = 0x89;     // mov r/m, reg
+    const int X86_TEST = 0x85;
+    const int X86_GROUP3 = 0xF7;    // idiv is /7
+    const int X86_JMP = 0xE9;
+    const int X86_JO = 0x0F80;
+    const int X86_JS = 0x0F88;
+    const int X86_JZ = 0x0F84;
+    const int X86_JG = 0x0F8F;
+
+    // The function type of the trampoline that enters translated code.
+    typedef int (*EntryFunction)(MemoryWord* a_reg, const unsigned char* a_block, long long* a_budget);
+#endif
+}
+
+const int JitCompiler::NO_BLOCK;
+
+/*
+NAME:
+
+    JitCompiler - constructor, sets aside the executable buffer for the translations
+
+SYNOPSIS:
+
+    JitCompiler::JitCompiler(PagedMemory<MemoryWord>& a_memory);
+    a_memory    --> the memory of the emulator whose program is translated
+
+DESCRIPTION:
+
+    Maps a buffer that is readable, writable and executable, and generates the trampoline
+    that enters and leaves translated code at its start. If the buffer cannot be mapped,
+    isReady() reports false and the emulator interprets the program instead.
+
+RETURNS:
+
+    constructor class so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+JitCompiler::JitCompiler(PagedMemory<MemoryWord>& a_memory)
+: m_memory(a_memory)
+{
+#if VC8000_JIT
+#if defined(_WIN32)
+    void* buffer = VirtualAlloc(nullptr, CODE_SIZE, MEM_COMMIT | MEM_RESERVE, PAGE_EXECUTE_READWRITE);
+#else
+    void* buffer = mmap(nullptr, CODE_SIZE, PROT_READ | PROT_WRITE | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (buffer == MAP_FAILED) {
+        buffer = nullptr;
+    }
+#endif
+    if (buffer == nullptr) {
+        return;
+    }
+    m_code = static_cast<unsigned char*>(buffer);
+
+    m_blockOffset.assign(m_memory.size(), NO_BLOCK);
+    m_isCode.assign(m_memory.size(), 0);
+    m_isStoreTarget.assign(m_memory.size(), 0);
+    m_pageRead.assign((m_memory.size() + MEMORY_PAGE - 1) / MEMORY_PAGE, nullptr);
+
+    emitTrampoline();
+    m_firstBlock = m_used;
+#endif
+}
+
+JitCompiler::~JitCompiler()
+{
+#if VC8000_JIT
+    if (m_code != nullptr) {
+#if defined(_WIN32)
+        VirtualFree(m_code, 0, MEM_RELEASE);
+#else
+        munmap(m_code, CODE_SIZE);
+#endif
+    }
+#endif
+}
+
+/*
+NAME:
+
+    flush() - discards every translation
+
+SYNOPSIS:
+
+    void JitCompiler::flush();
+
+DESCRIPTION:
+
+    Called when the program writes into translated code, when the buffer is full, and when
+    the emulator's memory is replaced by a snapshot. The trampoline is kept; all blocks, the
+    jumps linking them, and the record of which locations they cover are thrown away, so the
+    blocks are translated again from the current memory. Only the entries of the tables that
+    the translations set are cleared, so a flush costs as much as the code it discards. The
+    locations the discarded translations stored into are kept for takeFlushedStoreTargets(),
+    since their predecoded entries are still stale.
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void JitCompiler::flush()
+{
+    if (m_code == nullptr) {
+        return;
+    }
+    m_used = m_firstBlock;
+    for (const pair<int, int>& block : m_blocks) {
+        m_blockOffset[block.first] = NO_BLOCK;
+        std::fill(m_isCode.begin() + block.first, m_isCode.begin() + block.second + 1, 0);
+    }
+    for (int loc : m_storeTargets) {
+        m_isStoreTarget[loc] = 0;
+    }
+    for (int page : m_pagesRead) {
+        m_pageRead[page] = nullptr;
+    }
+    m_flushedStoreTargets.insert(m_flushedStoreTargets.end(), m_storeTargets.begin(), m_storeTargets.end());
+    m_blocks.clear();
+    m_storeTargets.clear();
+    m_pagesRead.clear();
+    m_pendingExits.clear();
+}
+
+/*
+NAME:
+
+    checkPages() - discards the translations if a page they read has moved
+
+SYNOPSIS:
+
+    void JitCompiler::checkPages();
+
+DESCRIPTION:
+
+    Translations read a page where it was kept when they were made, which for a page never
+    written is the shared zero page. A write made without notifyWrite(), as a store of a
+    verified program run by another engine, gives such a page storage of its own, and the
+    translations would go on reading the old storage.
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void JitCompiler::checkPages()
+{
+    for (int page : m_pagesRead) {
+        if (isPageMoved(page)) {
+            flush();
+            return;
+        }
+    }
+}
+
+/*
+NAME:
+
+    getResidentBytes() - returns the bytes of host memory used by the JIT compiler
+
+SYNOPSIS:
+
+    size_t JitCompiler::getResidentBytes() const;
+
+DESCRIPTION:
+
+    Counts the part of the executable buffer holding code and the tables kept for every
+    location. The rest of the buffer is reserved but never touched.
+
+RETURNS:
+
+    size_t - the number of bytes
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+size_t JitCompiler::getResidentBytes() const
+{
+    return m_used + m_blockOffset.capacity() * sizeof(int) + m_isCode.capacity() + m_isStoreTarget.capacity() +
+        m_blocks.capacity() * sizeof(pair<int, int>) +
+        (m_storeTargets.capacity() + m_newStoreTargets.capacity() + m_flushedStoreTargets.capacity() +
+         m_pagesRead.capacity()) * sizeof(int) + m_pageRead.capacity() * sizeof(const MemoryWord*);
+}
+
+/*
+NAME:
+
+    getBlock() - finds or creates the translation of the block starting at a location
+
+SYNOPSIS:
+
+    const unsigned char* JitCompiler::getBlock(int a_location);
+    a_location  --> the location of the next instruction to execute
+
+RETURNS:
+
+    const unsigned char* - the entry of the translation, or nullptr if the instruction at
+    a_location must be interpreted
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+const unsigned char* JitCompiler::getBlock(int a_location)
+{
+    if (m_code == nullptr) {
+        return nullptr;
+    }
+    if (m_blockOffset[a_location] != NO_BLOCK) {
+        return m_code + m_blockOffset[a_location];
+    }
+    if (CODE_SIZE - m_used < MAX_BLOCK_BYTES) {
+        flush();
+    }
+    return translate(a_location);
+}
+
+/*
+NAME:
+
+    execute() - runs translated code
+
+SYNOPSIS:
+
+    int JitCompiler::execute(const unsigned char* a_block, MemoryWord* a_reg, long long& a_budget);
+    a_block     --> the translation to start with, from getBlock() or skipBudgetCheck()
+    a_reg       --> the VC8000 registers, loaded into host registers while the code runs
+    a_budget    --> the instructions the blocks may execute, kept in rsi while the code runs
+
+DESCRIPTION:
+
+    Enters the translation through the trampoline. Blocks jump directly to each other, so the
+    VC8000 registers stay in host registers until a block leaves for a location that is not
+    translated or must be interpreted; the registers are then written back to a_reg. Each
+    block subtracts its length from the budget on entry, and leaves if that makes it negative.
+
+RETURNS:
+
+    int - the location of the next instruction, HALTED, OVERFLOWED plus the location of
+    an instruction whose result did not fit in a compact word, or OUT_OF_BUDGET plus the
+    location of a block the budget could not cover
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+int JitCompiler::execute(const unsigned char* a_block, MemoryWord* a_reg, long long& a_budget)
+{
+#if VC8000_JIT
+    EntryFunction entry = reinterpret_cast<EntryFunction>(m_code);
+    return entry(a_reg, a_block, &a_budget);
+#else
+    return HALTED;
+#endif
+}
+
+/*
+NAME:
+
+    decodeWord() - splits a memory word into its fields
+
+SYNOPSIS:
+
+    bool JitCompiler::decodeWord(long long a_word, int& a_opCode, int& a_reg1, int& a_reg2, int& a_address);
+    a_word      --> the memory word
+    a_opCode, a_reg1, a_reg2, a_address  --> receive the fields of the instruction
+
+RETURNS:
+
+    bool - returns false if the word is not a valid instruction
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+bool JitCompiler::decodeWord(long long a_word, int& a_opCode, int& a_reg1, int& a_reg2, int& a_address)
+{
+    if (a_word < 10'000'000 || a_word >= 180'000'000) {
+        return false;
+    }
+    a_opCode = static_cast<int>(a_word / 10'000'000);
+    a_reg1 = static_cast<int>((a_word / 1'000'000) % 10);
+    a_reg2 = static_cast<int>((a_word / 100'000) % 10);
+    a_address = static_cast<int>(a_word % 1'000'000);
+    return true;
+}
+
+/*
+NAME:
+
+    translate() - translates the block starting at a location
+
+SYNOPSIS:
+
+    const unsigned char* JitCompiler::translate(int a_start);
+    a_start     --> the location of the first word of the block
+
+DESCRIPTION:
+
+    A block runs from a_start up to and including the first branch or HALT (op codes 13 - 17).
+    It starts by taking its length from the budget held in rsi, leaving for OUT_OF_BUDGET plus
+    a_start if the budget would go below zero.
+    The block ends early, and leaves to the interpreter, at a READ, WRITE or invalid word, at
+    a STORE into the block itself or into another translation, and at a zero word, since the
+    interpreter skips over empty memory with its index. If the new block covers a location that an
+    existing translation stores into, everything is flushed first so that the store can
+    never change translated code unnoticed. The exits of the block jump straight into the
+    translation of their target when there is one; otherwise they return to the interpreter
+    and are linked once their target is translated.
+
+RETURNS:
+
+    const unsigned char* - the entry of the translation, or nullptr if the instruction at
+    a_start must be interpreted
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+const unsigned char* JitCompiler::translate(int a_start)
+{
+#if VC8000_JIT
+    const int memsz = static_cast<int>(m_memory.size());
+    int opCode = 0, reg1 = 0, reg2 = 0, address = 0;
+
+    // Find the extent of the block: [a_start, end) is straight-line code, and if
+    // isTerminated, the word at end is the branch or HALT that ends it.
+    int end = a_start;
+    bool isTerminated = false;
+    for (; end < memsz && end - a_start < MAX_BLOCK_WORDS; end++) {
+        if (m_memory.get(end) == 0) {
+            break;
+        }
+        if (!decodeWord(m_memory.get(end), opCode, reg1, reg2, address) || opCode == 11 || opCode == 12) {
+            break;
+        }
+        if (opCode >= 13) {
+            isTerminated = true;
+            break;
+        }
+    }
+    int last = isTerminated ? end : end - 1;
+
+    // Stores into the block or into other translations are left to the interpreter.
+    for (int loc = a_start; loc < end; loc++) {
+        if (decodeWord(m_memory.get(loc), opCode, reg1, reg2, address) && opCode == 6) {
+            if ((address >= a_start && address <= last) || m_isCode[address]) {
+                end = loc;
+                last = loc - 1;
+                isTerminated = false;
+                break;
+            }
+        }
+    }
+    if (last < a_start) {
+        return nullptr;
+    }
+
+    // A translation already stores into this block, so it must be translated again.
+    for (int loc = a_start; loc <= last; loc++) {
+        if (m_isStoreTarget[loc]) {
+            flush();
+            break;
+        }
+    }
+
+    // The pages the block stores into are given storage of their own before anything is
+    // read from them, and the translations reading them where they were are discarded.
+    for (int loc = a_start; loc < end; loc++) {
+        if (decodeWord(m_memory.get(loc), opCode, reg1, reg2, address) && opCode == 6) {
+            m_memory.getWritable(address);
+            if (isPageMoved(address / MEMORY_PAGE)) {
+                flush();
+            }
+        }
+    }
+
+    size_t blockOffset = m_used;
+    vector<Exit> stubs;
+    m_pageInRcx = -1;
+
+    // sub rsi, length; js out of budget
+    emitByte(REX_W);
+    emitByte(0x81);
+    emitByte(0xC0 | (5 << 3) | RSI);
+    emitInt32(last - a_start + 1);
+    emitJumpTo(X86_JS, OUT_OF_BUDGET + a_start, stubs);
+
+    for (int loc = a_start; loc < end; loc++) {
+        if (!decodeWord(m_memory.get(loc), opCode, reg1, reg2, address)) {
+            continue;
+        }
+        int host1 = VC_REGISTER[reg1];
+        int host2 = VC_REGISTER[reg2];
+        switch (opCode) {
+        case 1:
+            emitArithmetic(X86_ADD, host1, true, address, loc, stubs);
+            break;
+        case 2:
+            emitArithmetic(X86_SUB, host1, true, address, loc, stubs);
+            break;
+        case 3:
+            emitArithmetic(X86_IMUL, host1, true, address, loc, stubs);
+            break;
+        case 4:
+            // rax <-- c(Reg), sign extended into rdx, divided by c(ADDR)
+            emitRegReg(X86_LOAD, RAX, host1);
+            emitByte(REX_WORD);
+            emitByte(0x99);
+            emitRegMemory(X86_GROUP3, 7, address);
+            emitRegReg(X86_LOAD, host1, RAX);
+            break;
+        case 5:
+            emitRegMemory(X86_LOAD, host1, address);
+            break;
+        case 6:
+            emitRegMemory(X86_STORE, host1, address);
+            if (!m_isStoreTarget[address]) {
+                m_isStoreTarget[address] = 1;
+                m_storeTargets.push_back(address);
+            }
+            m_newStoreTargets.push_back(address);
+            break;
+        case 7:
+            emitArithmetic(X86_ADD, host1, false, host2, loc, stubs);
+            break;
+        case 8:
+            emitArithmetic(X86_SUB, host1, false, host2, loc, stubs);
+            break;
+        case 9:
+            emitArithmetic(X86_IMUL, host1, false, host2, loc, stubs);
+            break;
+        case 10:
+            emitRegReg(X86_LOAD, RAX, host1);
+            emitByte(REX_WORD);
+            emitByte(0x99);
+            emitRegReg(X86_GROUP3, 7, host2);
+            emitRegReg(X86_LOAD, host1, RAX);
+            break;
+        }
+    }
+
+    if (!isTerminated) {
+        emitJumpTo(X86_JMP, end, stubs);
+    }
+    else {
+        decodeWord(m_memory.get(end), opCode, reg1, reg2, address);
+        int host1 = VC_REGISTER[reg1];
+        switch (opCode) {
+        case 13:
+            emitJumpTo(X86_JMP, address, stubs);
+            break;
+        case 14:
+            emitRegReg(X86_TEST, host1, host1);
+            emitJumpTo(X86_JS, address, stubs);
+            emitJumpTo(X86_JMP, end + 1, stubs);
+            break;
+        case 15:
+            emitRegReg(X86_TEST, host1, host1);
+            emitJumpTo(X86_JZ, address, stubs);
+            emitJumpTo(X86_JMP, end + 1, stubs);
+            break;
+        case 16:
+            emitRegReg(X86_TEST, host1, host1);
+            emitJumpTo(X86_JG, address, stubs);
+            emitJumpTo(X86_JMP, end + 1, stubs);
+            break;
+        case 17:
+            // mov eax, HALTED; jmp exit
+            emitByte(0xB8);
+            emitInt32(HALTED);
+            emitByte(X86_JMP);
+            emitInt32(0);
+            patchRel32(m_used - 4, m_exitOffset);
+            break;
+        }
+    }
+
+    // The stubs return the target location to the interpreter.
+    for (const Exit& stub : stubs) {
+        patchRel32(stub.m_jumpOffset, m_used);
+        if (stub.m_undoOpCode != 0) {
+            emitRegBase(stub.m_undoOpCode, stub.m_undoReg, RCX, stub.m_undoDisp);
+        }
+        emitByte(0xB8);
+        emitInt32(stub.m_target);
+        emitByte(X86_JMP);
+        emitInt32(0);
+        patchRel32(m_used - 4, m_exitOffset);
+        if (stub.m_target < memsz) {
+            m_pendingExits[stub.m_target].push_back(stub.m_jumpOffset);
+        }
+    }
+
+    m_blockOffset[a_start] = static_cast<int>(blockOffset);
+    std::fill(m_isCode.begin() + a_start, m_isCode.begin() + last + 1, 1);
+    m_blocks.push_back(make_pair(a_start, last));
+    linkExits(a_start);
+
+    return m_code + blockOffset;
+#else
+    return nullptr;
+#endif
+}
+
+/*
+NAME:
+
+    emitJumpTo() - emits a jump that leaves the block for a location
+
+SYNOPSIS:
+
+    void JitCompiler::emitJumpTo(int a_opCode, int a_target, vector<Exit>& a_stubs);
+    a_opCode    --> X86_JMP or a conditional jump
+    a_target    --> the location to continue at
+    a_stubs     --> receives the jump if it must go through a stub
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void JitCompiler::emitJumpTo(int a_opCode, int a_target, vector<Exit>& a_stubs)
+{
+    emitOpCode(a_opCode);
+    emitInt32(0);
+    size_t jumpOffset = m_used - 4;
+
+    if (a_target < static_cast<int>(m_memory.size()) && m_blockOffset[a_target] != NO_BLOCK) {
+        patchRel32(jumpOffset, m_blockOffset[a_target]);
+    }
+    else {
+        a_stubs.push_back({ jumpOffset, a_target });
+    }
+}
+
+/*
+NAME:
+
+    emitArithmetic() - emits an ADD, SUB or IMUL into the host register of a VC8000 register
+
+SYNOPSIS:
+
+    void JitCompiler::emitArithmetic(int a_opCode, int a_host, bool a_isMemory, int a_operand,
+                                     int a_location, vector<Exit>& a_stubs);
+    a_opCode    --> X86_ADD, X86_SUB or X86_IMUL
+    a_host      --> the host register that receives the result
+    a_isMemory  --> true if a_operand is a VC8000 memory location, false if a host register
+    a_operand   --> the memory location or host register added, subtracted or multiplied
+    a_location  --> the location of the instruction being translated
+    a_stubs     --> receives the jump taken on overflow
+
+DESCRIPTION:
+
+    Full words are not checked for overflow, so the operation is done in place. With compact
+    words a JO leaves the block for OVERFLOWED + a_location, and the registers are left as
+    they were before the instruction: an ADD or SUB of a memory word is done in place and
+    reversed by the stub the JO goes to, and the other operations are done in rax and only
+    copied back if they did not overflow.
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void JitCompiler::emitArithmetic(int a_opCode, int a_host, bool a_isMemory, int a_operand, int a_location,
+                                 vector<Exit>& a_stubs)
+{
+    if (VC8000_COMPACT_WORDS && a_isMemory && a_opCode != X86_IMUL) {
+        emitRegMemory(a_opCode, a_host, a_operand);
+        emitJumpTo(X86_JO, OVERFLOWED + a_location, a_stubs);
+        a_stubs.back().m_undoOpCode = (a_opCode == X86_ADD ? X86_SUB : X86_ADD);
+        a_stubs.back().m_undoReg = a_host;
+        a_stubs.back().m_undoDisp = wordOffset(a_operand);
+        return;
+    }
+
+    int result = VC8000_COMPACT_WORDS ? RAX : a_host;
+    if (result != a_host) {
+        emitRegReg(X86_LOAD, result, a_host);
+    }
+    if (a_isMemory) {
+        emitRegMemory(a_opCode, result, a_operand);
+    }
+    else {
+        emitRegReg(a_opCode, result, a_operand);
+    }
+    if (result != a_host) {
+        emitJumpTo(X86_JO, OVERFLOWED + a_location, a_stubs);
+        emitRegReg(X86_LOAD, a_host, result);
+    }
+}
+
+/*
+NAME:
+
+    linkExits() - chains the blocks waiting for a location to its translation
+
+SYNOPSIS:
+
+    void JitCompiler::linkExits(int a_location);
+    a_location  --> the location that was just translated
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void JitCompiler::linkExits(int a_location)
+{
+    auto pending = m_pendingExits.find(a_location);
+    if (pending == m_pendingExits.end()) {
+        return;
+    }
+    for (size_t jumpOffset : pending->second) {
+        patchRel32(jumpOffset, m_blockOffset[a_location]);
+    }
+    m_pendingExits.erase(pending);
+}
+
+/*
+NAME:
+
+    emitTrampoline() - generates the code that enters and leaves translated code
+
+SYNOPSIS:
+
+    void JitCompiler::emitTrampoline();
+
+DESCRIPTION:
+
+    The entry saves the callee-saved host registers, keeps the addresses of the budget and of
+    the VC8000 registers on the stack, loads the budget into rsi and the VC8000 registers into
+    their host registers and jumps to the block. The exit, which every stub jumps to with the
+    next location in eax, writes the VC8000 registers and the budget back and returns to
+    execute().
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void JitCompiler::emitTrampoline()
+{
+#if VC8000_JIT
+    const int saved[] = { RBX, RBP, RSI, R12, R13, R14, R15 };
+    const int numSaved = sizeof(saved) / sizeof(saved[0]);
+    for (int reg : saved) {
+        emitPush(reg);
+    }
+#if defined(_WIN32)
+    // The arguments arrive in rcx, rdx and r8.
+    emitRegReg(X86_LOAD, RAX, RCX, REX_W);
+    emitRegReg(X86_LOAD, RCX, RDX, REX_W);
+    emitRegReg(X86_LOAD, RDX, R8, REX_W);
+#else
+    // The arguments arrive in rdi, rsi and rdx.
+    emitRegReg(X86_LOAD, RAX, RDI, REX_W);
+    emitRegReg(X86_LOAD, RCX, RSI, REX_W);
+#endif
+    emitPush(RDX);
+    emitRegBase(X86_LOAD, RSI, RDX, 0, REX_W);
+    emitPush(RAX);
+    for (int reg = 0; reg < 10; reg++) {
+        emitRegBase(X86_LOAD, VC_REGISTER[reg], RAX, reg * sizeof(MemoryWord));
+    }
+    // jmp rcx
+    emitByte(0xFF);
+    emitByte(0xE1);
+
+    m_exitOffset = m_used;
+    emitPop(RCX);
+    for (int reg = 0; reg < 10; reg++) {
+        emitRegBase(X86_STORE, VC_REGISTER[reg], RCX, reg * sizeof(MemoryWord));
+    }
+    emitPop(RCX);
+    emitRegBase(X86_STORE, RSI, RCX, 0, REX_W);
+    for (int i = numSaved - 1; i >= 0; i--) {
+        emitPop(saved[i]);
+    }
+    // ret
+    emitByte(0xC3);
+#endif
+}
+
+/*
+NAME:
+
+    emitInt32(), emitInt64(), emitOpCode(), emitRegMemory(), emitRegReg(), emitRegBase(),
+    emitPush(), emitPop(), patchRel32() - emit x86-64 machine code
+
+SYNOPSIS:
+
+    void JitCompiler::emitRegMemory(int a_opCode, int a_reg, int a_location);
+    void JitCompiler::emitRegReg(int a_opCode, int a_reg, int a_rm, int a_rex = REX_WORD);
+    void JitCompiler::emitRegBase(int a_opCode, int a_reg, int a_base, int a_disp, int a_rex = REX_WORD);
+    a_opCode    --> a one or two byte x86-64 op code, operating on a VC8000 word
+    a_reg       --> the register in the reg field of the ModRM byte
+    a_location  --> a VC8000 memory location, addressed through rcx, which holds the address
+                    of its page
+    a_rm        --> the register in the r/m field of the ModRM byte
+    a_rex       --> REX_WORD, or REX_W for an operation on a host pointer or on the budget
+    a_base, a_disp  --> base register and displacement of a memory operand
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void JitCompiler::emitInt32(int a_value)
+{
+    unsigned int value = static_cast<unsigned int>(a_value);
+    for (int i = 0; i < 4; i++) {
+        emitByte((value >> (8 * i)) & 0xFF);
+    }
+}
+
+void JitCompiler::emitInt64(unsigned long long a_value)
+{
+    for (int i = 0; i < 8; i++) {
+        emitByte((a_value >> (8 * i)) & 0xFF);
+    }
+}
+
+void JitCompiler::emitOpCode(int a_opCode)
+{
+    if (a_opCode > 0xFF) {
+        emitByte(a_opCode >> 8);
+    }
+    emitByte(a_opCode & 0xFF);
+}
+
+void JitCompiler::emitRegMemory(int a_opCode, int a_reg, int a_location)
+{
+#if VC8000_JIT
+    // mov rcx, imm64 with the address of the word's page, unless rcx already holds it.
+    // A STORE's page was given storage of its own by translate(), so that the address stays
+    // valid as long as the translation does. Other operations only read the page, so a page
+    // never written is read from the shared zero page, and is not made dirty or private;
+    // the page is recorded, so that the translation is discarded once it is given storage.
+    int page = a_location / MEMORY_PAGE;
+    if (page != m_pageInRcx) {
+        const MemoryWord* storage = m_memory.getPageTable()[page];
+        if (m_pageRead[page] == nullptr) {
+            m_pageRead[page] = storage;
+            m_pagesRead.push_back(page);
+        }
+        emitByte(REX_W);
+        emitByte(0xB8 + RCX);
+        emitInt64(reinterpret_cast<unsigned long long>(storage));
+        m_pageInRcx = page;
+    }
+    emitRegBase(a_opCode, a_reg, RCX, wordOffset(a_location));
+#endif
+}
+
+void JitCompiler::emitRegReg(int a_opCode, int a_reg, int a_rm, int a_rex)
+{
+    emitByte(a_rex | ((a_reg >> 3) << 2) | (a_rm >> 3));
+    emitOpCode(a_opCode);
+    emitByte(0xC0 | ((a_reg & 7) << 3) | (a_rm & 7));
+}
+
+void JitCompiler::emitRegBase(int a_opCode, int a_reg, int a_base, int a_disp, int a_rex)
+{
+    // REX, then [base + disp8] or [base + disp32]; the bases used here never need a SIB byte
+    emitByte(a_rex | ((a_reg >> 3) << 2) | (a_base >> 3));
+    emitOpCode(a_opCode);
+    if (a_disp < 128) {
+        emitByte(0x40 | ((a_reg & 7) << 3) | (a_base & 7));
+        emitByte(a_disp);
+    }
+    else {
+        emitByte(0x80 | ((a_reg & 7) << 3) | (a_base & 7));
+        emitInt32(a_disp);
+    }
+}
+
+void JitCompiler::emitPush(int a_reg)
+{
+    if (a_reg >= 8) {
+        emitByte(0x41);
+    }
+    emitByte(0x50 + (a_reg & 7));
+}
+
+void JitCompiler::emitPop(int a_reg)
+{
+    if (a_reg >= 8) {
+        emitByte(0x41);
+    }
+    emitByte(0x58 + (a_reg & 7));
+}
+
+void JitCompiler::patchRel32(size_t a_jumpOffset, size_t a_destination)
+{
+    long long rel = static_cast<long long>(a_destination) - static_cast<long long>(a_jumpOffset + 4);
+    unsigned int value = static_cast<unsigned int>(rel);
+    for (int i = 0; i < 4; i++) {
+        m_code[a_jumpOffset + i] = static_cast<unsigned char>((value >> (8 * i)) & 0xFF);
+    }
+}
@@ -0,0 +1,206 @@
+//
+//		JitCompiler class - translates basic blocks of VC8000 instructions into x86-64 machine code
+//
+#ifndef _JITCOMPILER_H
+#define _JITCOMPILER_H
+
+// Translation is only possible when the host is an x86-64 processor.
+#if defined(__x86_64__) || defined(_M_X64)
+#define VC8000_JIT 1
+#else
+#define VC8000_JIT 0
+#endif
+
+#include "MemoryWord.h"
+#include "PagedMemory.h"
+
+class JitCompiler {
+
+public:
+
+    // Returned by execute() when the translated code reached a HALT.
+    const static int HALTED = -1;
+
+    // Added by execute() to the location of an instruction whose result did not fit in a
+    // compact word.  The instruction is not executed.
+    const static int OVERFLOWED = 0x40000000;
+
+    // Added by execute() to the location of a block that the budget could not cover.  The
+    // block's instructions have been taken from the budget, but it has not been executed;
+    // getBlockLength() tells how many to give back, and skipBudgetCheck() gives the entry
+    // that runs it without taking them again.
+    const static int OUT_OF_BUDGET = 0x20000000;
+
+    JitCompiler(PagedMemory<MemoryWord>& a_memory);
+    ~JitCompiler();
+
+    JitCompiler(const JitCompiler&) = delete;
+    JitCompiler& operator=(const JitCompiler&) = delete;
+
+    // Checks whether executable memory could be set aside for the translations.
+    bool isReady() const { return m_code != nullptr; }
+
+    // Returns the translation of the block starting at a location, translating it first if
+    // needed.  Returns nullptr if the instruction at the location must be interpreted.
+    const unsigned char* getBlock(int a_location);
+
+    // Runs translated code from a block until it leaves translated code.  Each block takes
+    // its instructions from a_budget as it is entered, and leaves rather than take it below
+    // zero.  Returns the location of the next instruction to interpret, HALTED, or
+    // OVERFLOWED or OUT_OF_BUDGET plus a location.
+    int execute(const unsigned char* a_block, MemoryWord* a_reg, long long& a_budget);
+
+    // Returns the instructions of the translated block starting at a location, or 0 if there
+    // is none.  Only looked up when a block is out of budget, so the blocks are searched.
+    int getBlockLength(int a_location) const {
+        for (const pair<int, int>& block : m_blocks) {
+            if (block.first == a_location) {
+                return block.second - block.first + 1;
+            }
+        }
+        return 0;
+    }
+
+    // Returns the last location of the translated block covering a location, or the location
+    // if none does.  Only looked up when a block overflows, so the blocks are searched.
+    int getBlockLast(int a_location) const {
+        int first = -1;
+        int last = a_location;
+        for (const pair<int, int>& block : m_blocks) {
+            if (block.first <= a_location && a_location <= block.second && block.first > first) {
+                first = block.first;
+                last = block.second;
+            }
+        }
+        return last;
+    }
+
+    // Returns the entry of a block past the code that takes its instructions from the budget.
+    static const unsigned char* skipBudgetCheck(const unsigned char* a_block) { return a_block + BUDGET_CHECK_BYTES; }
+
+    // Discards the translations if the interpreter wrote into translated code, or gave a
+    // page that translations read its own storage.
+    void notifyWrite(int a_location) {
+        if (m_isCode[a_location] || isPageMoved(a_location / MEMORY_PAGE)) {
+            flush();
+        }
+    }
+
+    // Discards the translations if a page they read was given storage of its own since, as
+    // by a write outside translated code.
+    void checkPages();
+
+    // Discards every translation.
+    void flush();
+
+    // Checks whether translations made since the last call to takeNewStoreTargets() store
+    // into memory, and returns the locations they store into.
+    bool hasNewStoreTargets() const { return !m_newStoreTargets.empty(); }
+    vector<int> takeNewStoreTargets() {
+        vector<int> locations;
+        locations.swap(m_newStoreTargets);
+        return locations;
+    }
+
+    // Returns the locations that the current translations store into.
+    const vector<int>& getStoreTargets() const { return m_storeTargets; }
+
+    // Returns the locations that translations discarded by flush() stored into, which the
+    // interpreter must decode again as it does those of the current translations.
+    vector<int> takeFlushedStoreTargets() {
+        vector<int> locations;
+        locations.swap(m_flushedStoreTargets);
+        return locations;
+    }
+
+    // Returns the bytes of host memory taken by the translations and the tables about them.
+    size_t getResidentBytes() const;
+
+private:
+
+    // Numbers of the x86-64 registers used by the translations.
+    enum HostRegister {
+        RAX = 0, RCX = 1, RDX = 2, RBX = 3, RSP = 4, RBP = 5, RSI = 6, RDI = 7,
+        R8 = 8, R9 = 9, R10 = 10, R11 = 11, R12 = 12, R13 = 13, R14 = 14, R15 = 15
+    };
+
+    // REX prefixes of an operation on 64 bits and on a VC8000 word.  The plain REX prefix
+    // changes nothing but lets every register be encoded the same way.
+    const static int REX_W = 0x48;
+    const static int REX_WORD = VC8000_COMPACT_WORDS ? 0x40 : REX_W;
+
+    const static int NO_BLOCK = -1;                 // m_blockOffset of an untranslated location.
+    const static int MEMORY_PAGE = PagedMemory<MemoryWord>::PAGE_SIZE;     // Words in a page of memory.
+    const static int MAX_BLOCK_WORDS = 1024;        // Longest run of words translated as one block.
+    const static size_t MAX_BLOCK_BYTES = 64 * 1024;    // Room always left for the next block.
+    const static size_t CODE_SIZE = 16 * 1024 * 1024;   // Size of the executable buffer.
+    const static int BUDGET_CHECK_BYTES = 13;       // Size of the code that starts each block.
+
+    // A jump out of a block to a location that has not been translated yet.
+    struct Exit {
+        size_t m_jumpOffset;    // Offset of the rel32 field of the jump.
+        int m_target;           // Location the jump leaves for.
+        int m_undoOpCode = 0;   // X86 op code the stub applies to m_undoReg and [rcx + m_undoDisp]
+        int m_undoReg = 0;      // before leaving, to reverse an operation that overflowed, or 0.
+        int m_undoDisp = 0;
+    };
+
+    // Generates the code that enters and leaves translated code.
+    void emitTrampoline();
+
+    // Checks whether a page that translations read is no longer kept where they read it.
+    bool isPageMoved(int a_page) const {
+        return m_pageRead[a_page] != nullptr && m_pageRead[a_page] != m_memory.getPageTable()[a_page];
+    }
+
+    // Translates the block starting at a location.
+    const unsigned char* translate(int a_start);
+
+    // Splits a memory word into its fields.  Returns false if it is not an instruction.
+    static bool decodeWord(long long a_word, int& a_opCode, int& a_reg1, int& a_reg2, int& a_address);
+
+    // Emits an instruction that leaves for a location, either straight into its translation
+    // or through a stub that returns to the interpreter.
+    void emitJumpTo(int a_opCode, int a_target, vector<Exit>& a_stubs);
+
+    // Points the jumps waiting for a location at its new translation.
+    void linkExits(int a_location);
+
+    // Emits an ADD, SUB or IMUL of a memory word or of a host register into a host register.
+    // With compact words the result is formed in rax and only kept if it fits; otherwise the
+    // block is left for OVERFLOWED plus the location of the instruction.
+    void emitArithmetic(int a_opCode, int a_host, bool a_isMemory, int a_operand, int a_location, vector<Exit>& a_stubs);
+
+    // Machine code emitters.
+    void emitByte(int a_byte) { m_code[m_used++] = static_cast<unsigned char>(a_byte); }
+    void emitInt32(int a_value);
+    void emitInt64(unsigned long long a_value);
+    void emitOpCode(int a_opCode);
+    void emitRegMemory(int a_opCode, int a_reg, int a_location);
+    int wordOffset(int a_location) const { return (a_location % MEMORY_PAGE) * sizeof(MemoryWord); }
+    void emitRegReg(int a_opCode, int a_reg, int a_rm, int a_rex = REX_WORD);
+    void emitRegBase(int a_opCode, int a_reg, int a_base, int a_disp, int a_rex = REX_WORD);
+    void emitPush(int a_reg);
+    void emitPop(int a_reg);
+    void patchRel32(size_t a_jumpOffset, size_t a_destination);
+
+    PagedMemory<MemoryWord>& m_memory;      // Memory of the emulator being translated.
+    unsigned char* m_code = nullptr;        // Executable buffer holding the translations.
+    size_t m_used = 0;                      // Bytes of m_code in use.
+    size_t m_firstBlock = 0;                // Offset of the first translated block.
+    size_t m_exitOffset = 0;                // Offset of the code that leaves translated code.
+    int m_pageInRcx = -1;                   // Page whose address rcx holds in the block being translated, or -1.
+
+    vector<int> m_blockOffset;              // Offset of the translation starting at each location.
+    vector<char> m_isCode;                  // == 1 if a location is covered by a translation.
+    vector<char> m_isStoreTarget;           // == 1 if a translation stores into a location.
+    vector<pair<int, int>> m_blocks;        // First and last location of each translation.
+    vector<int> m_storeTargets;             // Locations with m_isStoreTarget set.
+    map<int, vector<size_t>> m_pendingExits;    // Jumps waiting for each location to be translated.
+    vector<int> m_newStoreTargets;          // Locations stored into by translations not yet reported.
+    vector<int> m_flushedStoreTargets;      // Locations stored into by discarded translations.
+    vector<const MemoryWord*> m_pageRead;   // Storage each page is read from by translations, or nullptr.
+    vector<int> m_pagesRead;                // Pages with m_pageRead set.
+};
+
+#endif
@@ -0,0 +1,1104 @@
+//
+//		Implementation of the LockstepEmulator class.
+//
+#include "stdafx.h"
+#include "LockstepEmulator.h"
+#include "ZeroScanner.h"
+
+#if VC8000_SIMD_SCAN
+#include <immintrin.h>
+#endif
+
+namespace {
+    // The number of lanes in a 256 bit register, and the lanes of one register.
+    const int WORDS_PER_YMM = 32 / sizeof(MemoryWord);
+    const unsigned YMM_LANES = (1u << WORDS_PER_YMM) - 1;
+
+#if VC8000_SIMD_SCAN
+    // Returns a vector with every bit set in the lanes whose bit is set in a_lanes.
+    VC8000_TARGET("avx2")
+    inline __m256i laneMask(unsigned a_lanes)
+    {
+#if VC8000_COMPACT_WORDS
+        const __m256i bits = _mm256_set_epi32(128, 64, 32, 16, 8, 4, 2, 1);
+        return _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32(static_cast<int>(a_lanes)), bits), bits);
+#else
+        const __m256i bits = _mm256_set_epi64x(8, 4, 2, 1);
+        return _mm256_cmpeq_epi64(_mm256_and_si256(_mm256_set1_epi64x(a_lanes), bits), bits);
+#endif
+    }
+
+    // Returns one bit per lane, set if the lane's sign bit is set.
+    VC8000_TARGET("avx2")
+    inline unsigned signBits(__m256i a_words)
+    {
+#if VC8000_COMPACT_WORDS
+        return static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(a_words)));
+#else
+        return static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(a_words)));
+#endif
+    }
+#endif
+}
+
+const LockstepEmulator::Kernels LockstepEmulator::s_kernels = LockstepEmulator::selectKernels();
+
+/*
+NAME:
+
+    LockstepEmulator() - creates the lanes with the memory of a program image
+
+SYNOPSIS:
+
+    LockstepEmulator::LockstepEmulator(const Emulator::Snapshot& a_image);
+    a_image     --> a snapshot of an emulator with the program loaded and not yet run
+
+DESCRIPTION:
+
+    The image is kept in an emulator of its own, which shares its pages with the snapshot.
+    No page of the lanes' memory is created until the program uses it.
+
+RETURNS:
+
+    constructor, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+LockstepEmulator::LockstepEmulator(const Emulator::Snapshot& a_image)
+: m_image(a_image),
+  m_pages((MEMSZ + PAGE_SIZE - 1) / PAGE_SIZE),
+  m_decoded(m_pages.size())
+{
+    for (int lane = 0; lane < LANES; lane++) {
+        m_input[lane] = &cin;
+        m_output[lane] = &cout;
+    }
+    reset();
+}
+
+/*
+NAME:
+
+    reset() - returns every lane to the program image
+
+SYNOPSIS:
+
+    void LockstepEmulator::reset();
+
+DESCRIPTION:
+
+    The pages the lanes used are released, to be copied from the image again when they are
+    next used, and the registers are cleared.
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void LockstepEmulator::reset()
+{
+    for (int page : m_loadedPages) {
+        m_pages[page].reset();
+        m_decoded[page].reset();
+    }
+    m_loadedPages.clear();
+    for (LaneWord& reg : m_reg) {
+        std::fill(reg.m_lane, reg.m_lane + LANES, 0);
+    }
+    m_groups.clear();
+    m_running = 0;
+}
+
+/*
+NAME:
+
+    getMemory() - returns the contents of a location in a lane's memory
+
+SYNOPSIS:
+
+    MemoryWord LockstepEmulator::getMemory(int a_lane, int a_location) const;
+    a_lane      --> the lane
+    a_location  --> the location
+
+RETURNS:
+
+    MemoryWord - the contents
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+MemoryWord LockstepEmulator::getMemory(int a_lane, int a_location) const
+{
+    const unique_ptr<LaneWord[]>& page = m_pages[a_location / PAGE_SIZE];
+    if (!page) {
+        return m_image.getMemory(a_location);
+    }
+    return page[a_location % PAGE_SIZE].m_lane[a_lane];
+}
+
+/*
+NAME:
+
+    loadPage() - copies a page of the program image into every lane
+
+SYNOPSIS:
+
+    void LockstepEmulator::loadPage(int a_page);
+    a_page      --> the page
+
+DESCRIPTION:
+
+    Every instruction on the page is left to be decoded when it is first executed.
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void LockstepEmulator::loadPage(int a_page)
+{
+    unique_ptr<LaneWord[]> page(new LaneWord[PAGE_SIZE]);
+    int base = a_page * PAGE_SIZE;
+    for (int offset = 0; offset < PAGE_SIZE; offset++) {
+        MemoryWord contents = (base + offset < MEMSZ ? m_image.getMemory(base + offset) : 0);
+        std::fill(page[offset].m_lane, page[offset].m_lane + LANES, contents);
+    }
+    m_pages[a_page] = std::move(page);
+    m_decoded[a_page].reset(new LaneInstruction[PAGE_SIZE]());
+    m_loadedPages.push_back(a_page);
+}
+
+/*
+NAME:
+
+    runProgram() - runs the program in a number of lanes
+
+SYNOPSIS:
+
+    void LockstepEmulator::runProgram(int a_lanes);
+    a_lanes     --> the number of lanes to run, starting with the first
+
+DESCRIPTION:
+
+    The lanes start as one group at the entry point. A group runs on its own until it
+    splits; then the group at the lowest location runs next, so that lanes which branched
+    back to repeat a loop catch up with the ones that left it, and are joined with them.
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void LockstepEmulator::runProgram(int a_lanes)
+{
+    m_running = (a_lanes >= LANES ? (1u << LANES) - 1 : (1u << a_lanes) - 1);
+    for (int lane = 0; lane < a_lanes && lane < LANES; lane++) {
+        *m_output[lane] << endl;
+        *m_output[lane] << "Running the Emulator, Ritika's version" << endl;
+    }
+
+    m_groups.clear();
+    m_groups.push_back(Group{ m_image.getEntryPoint(), m_running });
+    while (!m_groups.empty()) {
+        Group group = takeGroup();
+        while (group.m_lanes != 0 && group.m_pc < MEMSZ) {
+            step(group);
+            if (!m_groups.empty()) {
+                break;
+            }
+        }
+        if (group.m_lanes != 0 && group.m_pc < MEMSZ) {
+            m_groups.push_back(group);
+        }
+        else {
+            m_running &= ~group.m_lanes;
+        }
+    }
+}
+
+/*
+NAME:
+
+    takeGroup() - takes the group at the lowest location
+
+SYNOPSIS:
+
+    LockstepEmulator::Group LockstepEmulator::takeGroup();
+
+DESCRIPTION:
+
+    Every other group at the same location is joined with it.
+
+RETURNS:
+
+    Group - the group, which is removed from m_groups
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+LockstepEmulator::Group LockstepEmulator::takeGroup()
+{
+    size_t lowest = 0;
+    for (size_t index = 1; index < m_groups.size(); index++) {
+        if (m_groups[index].m_pc < m_groups[lowest].m_pc) {
+            lowest = index;
+        }
+    }
+    Group group = m_groups[lowest];
+    size_t kept = 0;
+    for (size_t index = 0; index < m_groups.size(); index++) {
+        if (m_groups[index].m_pc == group.m_pc) {
+            group.m_lanes |= m_groups[index].m_lanes;
+        }
+        else {
+            m_groups[kept++] = m_groups[index];
+        }
+    }
+    m_groups.resize(kept);
+    return group;
+}
+
+/*
+NAME:
+
+    decodeInstruction() - decodes the instruction at a location
+
+SYNOPSIS:
+
+    const LockstepEmulator::LaneInstruction& LockstepEmulator::decodeInstruction(int a_location);
+    a_location  --> the location
+
+DESCRIPTION:
+
+    Called by instruction() when the instruction is not already decoded. An instruction is
+    kept decoded from when it is first executed until a lane writes to its location. When
+    the lanes hold different words there, OP_UNDECODED is returned and the caller decodes
+    the word of each lane.
+
+RETURNS:
+
+    const LaneInstruction& - the instruction
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+const LockstepEmulator::LaneInstruction& LockstepEmulator::decodeInstruction(int a_location)
+{
+    const LaneWord& contents = word(a_location);
+    LaneInstruction& decoded = m_decoded[a_location / PAGE_SIZE][a_location % PAGE_SIZE];
+    if (decoded.m_opCode == OP_UNDECODED) {
+        for (int lane = 1; lane < LANES; lane++) {
+            if (contents.m_lane[lane] != contents.m_lane[0]) {
+                return decoded;
+            }
+        }
+        decoded = decodeWord(contents.m_lane[0]);
+    }
+    return decoded;
+}
+
+/*
+NAME:
+
+    decodeWord() - splits a word into its op code, registers and address
+
+SYNOPSIS:
+
+    LockstepEmulator::LaneInstruction LockstepEmulator::decodeWord(MemoryWord a_word);
+    a_word      --> the word
+
+DESCRIPTION:
+
+    The same divisions as Emulator::decodeWord(). Zero words are recorded as OP_EMPTY, and
+    words whose op code is not 1 - 17 as OP_ILLEGAL.
+
+RETURNS:
+
+    LaneInstruction - the fields
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+LockstepEmulator::LaneInstruction LockstepEmulator::decodeWord(MemoryWord a_word)
+{
+    LaneInstruction decoded;
+    long long OpCode = a_word / 10'000'000;
+    if (a_word == 0) {
+        decoded.m_opCode = OP_EMPTY;
+    }
+    else if (OpCode < 1 || OpCode > 17) {
+        decoded.m_opCode = OP_ILLEGAL;
+    }
+    else {
+        decoded.m_opCode = static_cast<unsigned char>(OpCode);
+    }
+    decoded.m_reg1 = static_cast<unsigned char>((a_word / 1'000'000) % 10);
+    decoded.m_reg2 = static_cast<unsigned char>((a_word / 100'000) % 10);
+    decoded.m_address = static_cast<int>(a_word % 1'000'000);
+    return decoded;
+}
+
+/*
+NAME:
+
+    step() - executes the instruction at a group's location
+
+SYNOPSIS:
+
+    void LockstepEmulator::step(Group& a_group);
+    a_group     --> the group, which is moved on to its next instruction
+
+DESCRIPTION:
+
+    If the lanes of the group hold different words at its location, the lanes holding the
+    same word as the first of them execute it, and the rest are left as a group of their
+    own at the same location.
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void LockstepEmulator::step(Group& a_group)
+{
+    const LaneInstruction& decoded = instruction(a_group.m_pc);
+    if (decoded.m_opCode != OP_UNDECODED) {
+        if (a_group.m_lanes == m_running) {
+            m_lockstepSteps++;
+        }
+        else {
+            m_splitSteps++;
+        }
+        execute(decoded, a_group);
+        return;
+    }
+
+    const LaneWord& contents = word(a_group.m_pc);
+    int first = 0;
+    while ((a_group.m_lanes & (1u << first)) == 0) {
+        first++;
+    }
+    unsigned same = 0;
+    for (int lane = first; lane < LANES; lane++) {
+        if ((a_group.m_lanes & (1u << lane)) != 0 && contents.m_lane[lane] == contents.m_lane[first]) {
+            same |= 1u << lane;
+        }
+    }
+    if (same != a_group.m_lanes) {
+        m_groups.push_back(Group{ a_group.m_pc, a_group.m_lanes & ~same });
+        a_group.m_lanes = same;
+    }
+    if (a_group.m_lanes == m_running) {
+        m_lockstepSteps++;
+    }
+    else {
+        m_splitSteps++;
+    }
+    LaneInstruction own = decodeWord(contents.m_lane[first]);
+    if (own.m_opCode == OP_EMPTY) {
+        // zero in these lanes but not in every lane, so it is stepped over
+        a_group.m_pc++;
+        return;
+    }
+    execute(own, a_group);
+}
+
+/*
+NAME:
+
+    execute() - executes an instruction in the lanes of a group
+
+SYNOPSIS:
+
+    void LockstepEmulator::execute(const LaneInstruction& a_instruction, Group& a_group);
+    a_instruction   --> the instruction
+    a_group         --> the group, which is moved on to its next instruction
+
+DESCRIPTION:
+
+    Each instruction does what it does in Emulator::runSwitch(), in every lane of the group.
+    Additions, subtractions, loads and stores are applied to all the lanes at once by the
+    vector kernels; the other instructions are applied lane by lane. A branch that some
+    lanes take and others do not leaves the lanes that take it as a new group.
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void LockstepEmulator::execute(const LaneInstruction& a_instruction, Group& a_group)
+{
+    int pc = a_group.m_pc;
+    unsigned lanes = a_group.m_lanes;
+    MemoryWord* reg1 = m_reg[a_instruction.m_reg1].m_lane;
+    const MemoryWord* reg2 = m_reg[a_instruction.m_reg2].m_lane;
+    int address = a_instruction.m_address;
+    int next = pc + 1;
+    unsigned overflow = 0;
+    unsigned negative = 0;
+    unsigned zero = 0;
+    unsigned taken = 0;
+
+    switch (a_instruction.m_opCode) {
+    case OP_EMPTY:
+        // zero words are skipped over
+        next = findNextInstruction(pc);
+        break;
+    case 1:
+        // Reg <-- c(Reg) + c(ADDR)
+        overflow = s_kernels.m_add(reg1, word(address).m_lane, lanes);
+        break;
+    case 2:
+        // Reg <-- c(Reg) - c(ADDR)
+        overflow = s_kernels.m_subtract(reg1, word(address).m_lane, lanes);
+        break;
+    case 3: {
+        // Reg <-- c(Reg) * c(ADDR)
+        const MemoryWord* source = word(address).m_lane;
+        for (int lane = 0; lane < LANES; lane++) {
+            if ((lanes & (1u << lane)) != 0 && !multiplyWords(reg1[lane], source[lane], reg1[lane])) {
+                overflow |= 1u << lane;
+            }
+        }
+        break;
+    }
+    case 4: {
+        // Reg <-- c(Reg) / c(ADDR)
+        const MemoryWord* source = word(address).m_lane;
+        for (int lane = 0; lane < LANES; lane++) {
+            if ((lanes & (1u << lane)) != 0) {
+                reg1[lane] /= source[lane];
+            }
+        }
+        break;
+    }
+    case 5:
+        // Reg <-- c(ADDR)
+        s_kernels.m_copy(reg1, word(address).m_lane, lanes);
+        break;
+    case 6:
+        // ADDR <-- c(Reg)
+        s_kernels.m_copy(word(address).m_lane, reg1, lanes);
+        invalidate(address);
+        break;
+    case 7:
+        // REG1 <--c(REG1) + c(REG2)
+        overflow = s_kernels.m_add(reg1, reg2, lanes);
+        break;
+    case 8:
+        // REG1 <--c(REG1) - c(REG2)
+        overflow = s_kernels.m_subtract(reg1, reg2, lanes);
+        break;
+    case 9:
+        // REG1 <--c(REG1) * c(REG2)
+        for (int lane = 0; lane < LANES; lane++) {
+            if ((lanes & (1u << lane)) != 0 && !multiplyWords(reg1[lane], reg2[lane], reg1[lane])) {
+                overflow |= 1u << lane;
+            }
+        }
+        break;
+    case 10:
+        // REG1 <--c(REG1) / c(REG2)
+        for (int lane = 0; lane < LANES; lane++) {
+            if ((lanes & (1u << lane)) != 0) {
+                reg1[lane] /= reg2[lane];
+            }
+        }
+        break;
+    case 11: {
+        // A line is read in by each lane and the number found there is recorded
+        // in the specified memory address.
+        MemoryWord* dest = word(address).m_lane;
+        for (int lane = 0; lane < LANES; lane++) {
+            if ((lanes & (1u << lane)) == 0) {
+                continue;
+            }
+            *m_output[lane] << "Enter: " << endl;
+            int userInput = 0;
+            *m_output[lane] << "? ";
+            *m_input[lane] >> userInput;
+            if (userInput < MEMSZ) {
+                dest[lane] = userInput;
+            }
+            else {
+                *m_output[lane] << "Too large value" << endl;
+            }
+        }
+        invalidate(address);
+        break;
+    }
+    case 12: {
+        // c(ADDR) is displayed by each lane.  The register value is ignored.
+        const MemoryWord* source = word(address).m_lane;
+        for (int lane = 0; lane < LANES; lane++) {
+            if ((lanes & (1u << lane)) != 0) {
+                *m_output[lane] << source[lane] << endl;
+            }
+        }
+        break;
+    }
+    case 13:
+        // go to ADDR for the next instruction.  The register value is ignored.
+        next = address;
+        break;
+    case 14:
+    case 15:
+    case 16:
+        // go to ADDR if c(Reg) < 0, = 0 or > 0, in the lanes where it is
+        s_kernels.m_classify(reg1, negative, zero);
+        if (a_instruction.m_opCode == 14) {
+            taken = negative & lanes;
+        }
+        else if (a_instruction.m_opCode == 15) {
+            taken = zero & lanes;
+        }
+        else {
+            taken = ~(negative | zero) & lanes;
+        }
+        if (taken == lanes) {
+            next = address;
+        }
+        else if (taken != 0) {
+            m_groups.push_back(Group{ address, taken });
+            a_group.m_lanes &= ~taken;
+        }
+        break;
+    case 17:
+        // terminate execution.  The register value and address are ignored.
+        m_running &= ~lanes;
+        a_group.m_lanes = 0;
+        break;
+    default:
+        stopLanes(a_group, lanes, "Error! Error in OpCode!!");
+        break;
+    }
+    if (overflow != 0) {
+        stopLanes(a_group, overflow, "Error! Arithmetic overflow at location " + to_string(pc));
+    }
+    a_group.m_pc = next;
+}
+
+/*
+NAME:
+
+    stopLanes() - stops lanes with an error
+
+SYNOPSIS:
+
+    void LockstepEmulator::stopLanes(Group& a_group, unsigned a_lanes, const string& a_message);
+    a_group     --> the group the lanes are in
+    a_lanes     --> the lanes to stop
+    a_message   --> the error displayed on each lane's output
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void LockstepEmulator::stopLanes(Group& a_group, unsigned a_lanes, const string& a_message)
+{
+    for (int lane = 0; lane < LANES; lane++) {
+        if ((a_lanes & (1u << lane)) != 0) {
+            *m_output[lane] << a_message << endl;
+        }
+    }
+    m_running &= ~a_lanes;
+    a_group.m_lanes &= ~a_lanes;
+}
+
+/*
+NAME:
+
+    findNextInstruction() - finds the next word that is not zero in every lane
+
+SYNOPSIS:
+
+    int LockstepEmulator::findNextInstruction(int a_location);
+    a_location  --> the location where the search starts
+
+DESCRIPTION:
+
+    Pages the lanes have not used still hold the program image, so they are searched with
+    the image's own index of empty memory. Pages the lanes have used are searched word by
+    word.
+
+RETURNS:
+
+    int - the location of the word, or MEMSZ if there is none
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+int LockstepEmulator::findNextInstruction(int a_location)
+{
+    int loc = a_location;
+    while (loc < MEMSZ) {
+        int page = loc / PAGE_SIZE;
+        int end = (page + 1) * PAGE_SIZE < MEMSZ ? (page + 1) * PAGE_SIZE : MEMSZ;
+        if (!m_pages[page]) {
+            int found = m_image.findNonZeroWord(loc);
+            if (found < end) {
+                return found;
+            }
+            // the image is empty up to found, but pages in between may have been used
+            int next = end;
+            while (next < found && !m_pages[next / PAGE_SIZE]) {
+                next += PAGE_SIZE;
+            }
+            loc = (next < found ? next : found);
+            continue;
+        }
+        for (; loc < end; loc++) {
+            const MemoryWord* contents = m_pages[page][loc % PAGE_SIZE].m_lane;
+            for (int lane = 0; lane < LANES; lane++) {
+                if (contents[lane] != 0) {
+                    return loc;
+                }
+            }
+        }
+    }
+    return MEMSZ;
+}
+
+/*
+NAME:
+
+    addScalar(), subtractScalar() - add or subtract a lane word one lane at a time
+
+SYNOPSIS:
+
+    unsigned LockstepEmulator::addScalar(MemoryWord* a_dest, const MemoryWord* a_source, unsigned a_lanes);
+    unsigned LockstepEmulator::subtractScalar(MemoryWord* a_dest, const MemoryWord* a_source, unsigned a_lanes);
+    a_dest      --> the lanes added to or subtracted from
+    a_source    --> the lanes added or subtracted
+    a_lanes     --> the lanes to change
+
+RETURNS:
+
+    unsigned - the lanes whose result does not fit in a word, which are left unchanged
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+unsigned LockstepEmulator::addScalar(MemoryWord* a_dest, const MemoryWord* a_source, unsigned a_lanes)
+{
+    unsigned overflow = 0;
+    for (int lane = 0; lane < LANES; lane++) {
+        if ((a_lanes & (1u << lane)) != 0 && !addWords(a_dest[lane], a_source[lane], a_dest[lane])) {
+            overflow |= 1u << lane;
+        }
+    }
+    return overflow;
+}
+
+unsigned LockstepEmulator::subtractScalar(MemoryWord* a_dest, const MemoryWord* a_source, unsigned a_lanes)
+{
+    unsigned overflow = 0;
+    for (int lane = 0; lane < LANES; lane++) {
+        if ((a_lanes & (1u << lane)) != 0 && !subtractWords(a_dest[lane], a_source[lane], a_dest[lane])) {
+            overflow |= 1u << lane;
+        }
+    }
+    return overflow;
+}
+
+/*
+NAME:
+
+    copyScalar() - copies a lane word one lane at a time
+
+SYNOPSIS:
+
+    void LockstepEmulator::copyScalar(MemoryWord* a_dest, const MemoryWord* a_source, unsigned a_lanes);
+    a_dest      --> the lanes copied to
+    a_source    --> the lanes copied
+    a_lanes     --> the lanes to change
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void LockstepEmulator::copyScalar(MemoryWord* a_dest, const MemoryWord* a_source, unsigned a_lanes)
+{
+    for (int lane = 0; lane < LANES; lane++) {
+        if ((a_lanes & (1u << lane)) != 0) {
+            a_dest[lane] = a_source[lane];
+        }
+    }
+}
+
+/*
+NAME:
+
+    classifyScalar() - finds the lanes of a lane word that are negative or zero
+
+SYNOPSIS:
+
+    void LockstepEmulator::classifyScalar(const MemoryWord* a_words, unsigned& a_negative, unsigned& a_zero);
+    a_words     --> the lane word
+    a_negative  --> set to the lanes that are negative
+    a_zero      --> set to the lanes that are zero
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void LockstepEmulator::classifyScalar(const MemoryWord* a_words, unsigned& a_negative, unsigned& a_zero)
+{
+    a_negative = 0;
+    a_zero = 0;
+    for (int lane = 0; lane < LANES; lane++) {
+        if (a_words[lane] < 0) {
+            a_negative |= 1u << lane;
+        }
+        else if (a_words[lane] == 0) {
+            a_zero |= 1u << lane;
+        }
+    }
+}
+
+/*
+NAME:
+
+    addAvx2(), subtractAvx2() - add or subtract a lane word one 256 bit register at a time
+
+SYNOPSIS:
+
+    unsigned LockstepEmulator::addAvx2(MemoryWord* a_dest, const MemoryWord* a_source, unsigned a_lanes);
+    unsigned LockstepEmulator::subtractAvx2(MemoryWord* a_dest, const MemoryWord* a_source, unsigned a_lanes);
+    a_dest      --> the lanes added to or subtracted from
+    a_source    --> the lanes added or subtracted
+    a_lanes     --> the lanes to change
+
+DESCRIPTION:
+
+    Every lane is computed, and the results are blended into a_dest only in the lanes to
+    change. Compact words overflow when both operands of an addition have the same sign
+    and the result has the other, or when the operands of a subtraction have different
+    signs and the result has the sign of the one subtracted.
+
+RETURNS:
+
+    unsigned - the lanes whose result does not fit in a word, which are left unchanged
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+VC8000_TARGET("avx2")
+unsigned LockstepEmulator::addAvx2(MemoryWord* a_dest, const MemoryWord* a_source, unsigned a_lanes)
+{
+#if VC8000_SIMD_SCAN
+    unsigned overflow = 0;
+    for (int lane = 0; lane < LANES; lane += WORDS_PER_YMM) {
+        unsigned lanes = (a_lanes >> lane) & YMM_LANES;
+        if (lanes == 0) {
+            continue;
+        }
+        __m256i* dest = reinterpret_cast<__m256i*>(a_dest + lane);
+        __m256i left = _mm256_loadu_si256(dest);
+        __m256i right = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a_source + lane));
+#if VC8000_COMPACT_WORDS
+        __m256i result = _mm256_add_epi32(left, right);
+        unsigned overflowed = signBits(_mm256_and_si256(_mm256_xor_si256(left, result),
+                                                        _mm256_xor_si256(right, result))) & lanes;
+        lanes &= ~overflowed;
+        overflow |= overflowed << lane;
+#else
+        __m256i result = _mm256_add_epi64(left, right);
+#endif
+        _mm256_storeu_si256(dest, _mm256_blendv_epi8(left, result, laneMask(lanes)));
+    }
+    return overflow;
+#else
+    return addScalar(a_dest, a_source, a_lanes);
+#endif
+}
+
+VC8000_TARGET("avx2")
+unsigned LockstepEmulator::subtractAvx2(MemoryWord* a_dest, const MemoryWord* a_source, unsigned a_lanes)
+{
+#if VC8000_SIMD_SCAN
+    unsigned overflow = 0;
+    for (int lane = 0; lane < LANES; lane += WORDS_PER_YMM) {
+        unsigned lanes = (a_lanes >> lane) & YMM_LANES;
+        if (lanes == 0) {
+            continue;
+        }
+        __m256i* dest = reinterpret_cast<__m256i*>(a_dest + lane);
+        __m256i left = _mm256_loadu_si256(dest);
+        __m256i right = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a_source + lane));
+#if VC8000_COMPACT_WORDS
+        __m256i result = _mm256_sub_epi32(left, right);
+        unsigned overflowed = signBits(_mm256_and_si256(_mm256_xor_si256(left, right),
+                                                        _mm256_xor_si256(left, result))) & lanes;
+        lanes &= ~overflowed;
+        overflow |= overflowed << lane;
+#else
+        __m256i result = _mm256_sub_epi64(left, right);
+#endif
+        _mm256_storeu_si256(dest, _mm256_blendv_epi8(left, result, laneMask(lanes)));
+    }
+    return overflow;
+#else
+    return subtractScalar(a_dest, a_source, a_lanes);
+#endif
+}
+
+/*
+NAME:
+
+    copyAvx2() - copies a lane word one 256 bit register at a time
+
+SYNOPSIS:
+
+    void LockstepEmulator::copyAvx2(MemoryWord* a_dest, const MemoryWord* a_source, unsigned a_lanes);
+    a_dest      --> the lanes copied to
+    a_source    --> the lanes copied
+    a_lanes     --> the lanes to change
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+VC8000_TARGET("avx2")
+void LockstepEmulator::copyAvx2(MemoryWord* a_dest, const MemoryWord* a_source, unsigned a_lanes)
+{
+#if VC8000_SIMD_SCAN
+    for (int lane = 0; lane < LANES; lane += WORDS_PER_YMM) {
+        unsigned lanes = (a_lanes >> lane) & YMM_LANES;
+        if (lanes == 0) {
+            continue;
+        }
+        __m256i* dest = reinterpret_cast<__m256i*>(a_dest + lane);
+        __m256i source = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a_source + lane));
+        _mm256_storeu_si256(dest, _mm256_blendv_epi8(_mm256_loadu_si256(dest), source, laneMask(lanes)));
+    }
+#else
+    copyScalar(a_dest, a_source, a_lanes);
+#endif
+}
+
+/*
+NAME:
+
+    classifyAvx2() - finds the lanes of a lane word that are negative or zero
+
+SYNOPSIS:
+
+    void LockstepEmulator::classifyAvx2(const MemoryWord* a_words, unsigned& a_negative, unsigned& a_zero);
+    a_words     --> the lane word
+    a_negative  --> set to the lanes that are negative
+    a_zero      --> set to the lanes that are zero
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+VC8000_TARGET("avx2")
+void LockstepEmulator::classifyAvx2(const MemoryWord* a_words, unsigned& a_negative, unsigned& a_zero)
+{
+#if VC8000_SIMD_SCAN
+    a_negative = 0;
+    a_zero = 0;
+    for (int lane = 0; lane < LANES; lane += WORDS_PER_YMM) {
+        __m256i words = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a_words + lane));
+#if VC8000_COMPACT_WORDS
+        __m256i zero = _mm256_cmpeq_epi32(words, _mm256_setzero_si256());
+#else
+        __m256i zero = _mm256_cmpeq_epi64(words, _mm256_setzero_si256());
+#endif
+        a_negative |= signBits(words) << lane;
+        a_zero |= signBits(zero) << lane;
+    }
+#else
+    classifyScalar(a_words, a_negative, a_zero);
+#endif
+}
+
+/*
+NAME:
+
+    selectKernels() - chooses the kernels for the processor
+
+SYNOPSIS:
+
+    LockstepEmulator::Kernels LockstepEmulator::selectKernels();
+
+DESCRIPTION:
+
+    The AVX2 kernels are used if ZeroScanner::hasAvx2() finds that they can be.
+    Multiplication and division have no AVX2 instruction for 64 bit lanes, so they are
+    always done one lane at a time.
+
+RETURNS:
+
+    Kernels - the kernels to use
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+LockstepEmulator::Kernels LockstepEmulator::selectKernels()
+{
+    if (ZeroScanner::hasAvx2()) {
+        return Kernels{ addAvx2, subtractAvx2, copyAvx2, classifyAvx2, "AVX2" };
+    }
+    return Kernels{ addScalar, subtractScalar, copyScalar, classifyScalar, "scalar" };
+}
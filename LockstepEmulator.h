@@ -0,0 +1,165 @@
+//
+//		LockstepEmulator class - runs one program on several inputs at once, one lane per input
+//
+#ifndef _LOCKSTEPEMULATOR_H
+#define _LOCKSTEPEMULATOR_H
+
+#include "Emulator.h"
+
+// Each register and each word of memory holds one value per lane, stored side by side, so
+// that an instruction executed by every lane is one vector operation.  The lanes start
+// together at the entry point and stay together while they take the same branches and hold
+// the same instructions.  Where they part, each group of lanes continues on its own with the
+// other lanes masked off, and groups that reach the same location are joined again.  The
+// output of each lane is the same as running its input through Emulator::runProgram.
+class LockstepEmulator {
+
+public:
+
+    const static int LANES = 8;                     // The number of inputs run at once.
+    const static int MEMSZ = Emulator::MEMSZ;       // The size of each lane's memory.
+
+    // Creates the lanes with the memory of a program image, a snapshot of an emulator with
+    // the program loaded and not yet run.
+    explicit LockstepEmulator(const Emulator::Snapshot& a_image);
+
+    LockstepEmulator(const LockstepEmulator&) = delete;
+    LockstepEmulator& operator=(const LockstepEmulator&) = delete;
+
+    // Sets the streams a lane's READs take their input from and its WRITEs and messages go
+    // to.  They are cin and cout unless set.
+    void setInput(int a_lane, istream* a_input) { m_input[a_lane] = a_input; }
+    void setOutput(int a_lane, ostream* a_output) { m_output[a_lane] = a_output; }
+
+    // Runs the program in the first a_lanes lanes until each has halted.
+    void runProgram(int a_lanes = LANES);
+
+    // Returns every lane to the program image, ready to run again.
+    void reset();
+
+    // Returns the contents of a location in a lane's memory.
+    MemoryWord getMemory(int a_lane, int a_location) const;
+
+    // Returns the number of instructions executed by every running lane together, and by
+    // groups of lanes that had parted from the others.
+    long long getLockstepSteps() const { return m_lockstepSteps; }
+    long long getSplitSteps() const { return m_splitSteps; }
+
+    // Returns the name of the vector kernels chosen for this processor: "AVX2" or "scalar".
+    static const char* implementation() { return s_kernels.m_name; }
+
+private:
+
+    // A word of memory or a register, one value per lane.
+    struct LaneWord {
+        MemoryWord m_lane[LANES];
+    };
+
+    // The fields of the instruction at a location, when every lane holds the same word there.
+    struct LaneInstruction {
+        unsigned char m_opCode;     // 1 - 17, or one of the values below.
+        unsigned char m_reg1;
+        unsigned char m_reg2;
+        int m_address;
+    };
+
+    // Special values of LaneInstruction::m_opCode.
+    enum : unsigned char {
+        OP_UNDECODED = 0,   // Not decoded since it was last written, or the lanes differ.
+        OP_EMPTY = 18,      // The word is zero in every lane and is skipped over.
+        OP_ILLEGAL = 19     // The word does not hold a valid instruction.
+    };
+
+    // Lanes at the same location, one bit per lane.
+    struct Group {
+        int m_pc;
+        unsigned m_lanes;
+    };
+
+    const static int PAGE_SIZE = PagedMemory<MemoryWord>::PAGE_SIZE;   // Words in a page of memory.
+
+    // The vector operations on a lane word, applied only to the lanes in a_lanes.  The
+    // arithmetic kernels return the lanes whose result does not fit in a word, which are
+    // left unchanged; only compact words can overflow.
+    typedef unsigned (*Arithmetic)(MemoryWord* a_dest, const MemoryWord* a_source, unsigned a_lanes);
+    typedef void (*Copy)(MemoryWord* a_dest, const MemoryWord* a_source, unsigned a_lanes);
+    typedef void (*Classify)(const MemoryWord* a_words, unsigned& a_negative, unsigned& a_zero);
+
+    struct Kernels {
+        Arithmetic m_add;
+        Arithmetic m_subtract;
+        Copy m_copy;
+        Classify m_classify;
+        const char* m_name;
+    };
+
+    static unsigned addScalar(MemoryWord* a_dest, const MemoryWord* a_source, unsigned a_lanes);
+    static unsigned subtractScalar(MemoryWord* a_dest, const MemoryWord* a_source, unsigned a_lanes);
+    static void copyScalar(MemoryWord* a_dest, const MemoryWord* a_source, unsigned a_lanes);
+    static void classifyScalar(const MemoryWord* a_words, unsigned& a_negative, unsigned& a_zero);
+    static unsigned addAvx2(MemoryWord* a_dest, const MemoryWord* a_source, unsigned a_lanes);
+    static unsigned subtractAvx2(MemoryWord* a_dest, const MemoryWord* a_source, unsigned a_lanes);
+    static void copyAvx2(MemoryWord* a_dest, const MemoryWord* a_source, unsigned a_lanes);
+    static void classifyAvx2(const MemoryWord* a_words, unsigned& a_negative, unsigned& a_zero);
+
+    // Chooses the kernels for the processor the program is running on.
+    static Kernels selectKernels();
+
+    // Returns a word of memory for reading or writing, copying its page from the program
+    // image into every lane the first time the page is used.
+    LaneWord& word(int a_location) {
+        unique_ptr<LaneWord[]>& page = m_pages[a_location / PAGE_SIZE];
+        if (!page) {
+            loadPage(a_location / PAGE_SIZE);
+        }
+        return page[a_location % PAGE_SIZE];
+    }
+    void loadPage(int a_page);
+
+    // Returns the decoded instruction at a location, decoding it if it was written.
+    const LaneInstruction& instruction(int a_location) {
+        const unique_ptr<LaneInstruction[]>& page = m_decoded[a_location / PAGE_SIZE];
+        if (page && page[a_location % PAGE_SIZE].m_opCode != OP_UNDECODED) {
+            return page[a_location % PAGE_SIZE];
+        }
+        return decodeInstruction(a_location);
+    }
+    const LaneInstruction& decodeInstruction(int a_location);
+
+    // Marks the instruction at a location as needing to be decoded again.
+    void invalidate(int a_location) { m_decoded[a_location / PAGE_SIZE][a_location % PAGE_SIZE].m_opCode = OP_UNDECODED; }
+
+    // Splits a word into its fields the same way Emulator::decodeWord() does.
+    static LaneInstruction decodeWord(MemoryWord a_word);
+
+    // Takes the group at the lowest location, joined with every other group there.
+    Group takeGroup();
+
+    // Executes the instruction at a group's location, moving the group on.  Lanes that halt
+    // are removed from the group, and lanes that branch elsewhere become a new group.
+    void step(Group& a_group);
+    void execute(const LaneInstruction& a_instruction, Group& a_group);
+
+    // Removes the lanes in a_lanes from a group, displaying an error on each of them.
+    void stopLanes(Group& a_group, unsigned a_lanes, const string& a_message);
+
+    // Returns the location of the next word at or after a location that is not zero in
+    // every lane, or MEMSZ.
+    int findNextInstruction(int a_location);
+
+    Emulator m_image;                                   // The program every lane starts with.
+    vector<unique_ptr<LaneWord[]>> m_pages;             // The lanes' memory, loaded page by page.
+    vector<unique_ptr<LaneInstruction[]>> m_decoded;    // The decoded instructions of each loaded page.
+    vector<int> m_loadedPages;                          // The pages loaded since the last reset.
+    LaneWord m_reg[10];                                 // Registers for the VC8000, one set per lane.
+    istream* m_input[LANES];                            // The stream each lane's READs take input from.
+    ostream* m_output[LANES];                           // The stream each lane's output goes to.
+    vector<Group> m_groups;                             // Groups waiting while another runs.
+    long long m_lockstepSteps = 0;                      // Instructions executed by every running lane.
+    long long m_splitSteps = 0;                         // Instructions executed by part of them.
+    unsigned m_running = 0;                             // The lanes that have not halted.
+
+    static const Kernels s_kernels;                     // The kernels chosen when the program starts.
+};
+
+#endif
@@ -0,0 +1,66 @@
+//
+//		MemoryWord - the type of a word of VC8000 memory and of a VC8000 register
+//
+#ifndef _MEMORYWORD_H
+#define _MEMORYWORD_H
+
+// Every instruction word, at most 179999999, fits in 32 bits, as does every constant the
+// assembler accepts.  Building with VC8000_COMPACT_WORDS defined as 1 keeps memory and the
+// registers in 32 bit words, halving the cache footprint of the data a program touches.  A
+// program whose arithmetic no longer fits is then stopped with an overflow error.  The
+// Release Compact configuration of each project defines it.
+#ifndef VC8000_COMPACT_WORDS
+#define VC8000_COMPACT_WORDS 0
+#endif
+
+#if VC8000_COMPACT_WORDS
+typedef int MemoryWord;
+#else
+typedef long long MemoryWord;
+#endif
+
+// Adds, subtracts or multiplies two words into a_result.  Returns false, leaving a_result
+// unchanged, if the result does not fit in a compact word; full words are not checked.
+inline bool addWords(MemoryWord a_left, MemoryWord a_right, MemoryWord& a_result)
+{
+#if VC8000_COMPACT_WORDS
+    long long result = static_cast<long long>(a_left) + a_right;
+    if (result != static_cast<MemoryWord>(result)) {
+        return false;
+    }
+    a_result = static_cast<MemoryWord>(result);
+#else
+    a_result = a_left + a_right;
+#endif
+    return true;
+}
+
+inline bool subtractWords(MemoryWord a_left, MemoryWord a_right, MemoryWord& a_result)
+{
+#if VC8000_COMPACT_WORDS
+    long long result = static_cast<long long>(a_left) - a_right;
+    if (result != static_cast<MemoryWord>(result)) {
+        return false;
+    }
+    a_result = static_cast<MemoryWord>(result);
+#else
+    a_result = a_left - a_right;
+#endif
+    return true;
+}
+
+inline bool multiplyWords(MemoryWord a_left, MemoryWord a_right, MemoryWord& a_result)
+{
+#if VC8000_COMPACT_WORDS
+    long long result = static_cast<long long>(a_left) * a_right;
+    if (result != static_cast<MemoryWord>(result)) {
+        return false;
+    }
+    a_result = static_cast<MemoryWord>(result);
+#else
+    a_result = a_left * a_right;
+#endif
+    return true;
+}
+
+#endif
@@ -0,0 +1,400 @@
+//
+//		Implementation of the MultiCoreEmulator class.
+//
+#include "stdafx.h"
+#include "MultiCoreEmulator.h"
+
+/*
+NAME:
+
+    MultiCoreEmulator() - loads the shared memory from a program image
+
+SYNOPSIS:
+
+    MultiCoreEmulator::MultiCoreEmulator(const Emulator::Snapshot& a_image);
+    a_image     --> a snapshot of an emulator with the program loaded and not yet run
+
+DESCRIPTION:
+
+    Only the words of the image that are not zero are copied, found with the index of
+    empty memory that the emulator keeps.
+
+RETURNS:
+
+    constructor, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+MultiCoreEmulator::MultiCoreEmulator(const Emulator::Snapshot& a_image)
+: m_memory(new atomic<MemoryWord>[MEMSZ]()),
+  m_input(make_shared<ConsoleInput>()),
+  m_output(make_shared<ConsoleOutput>())
+{
+    Emulator image(a_image);
+    for (int loc = image.findNonZeroWord(0); loc < MEMSZ; loc = image.findNonZeroWord(loc + 1)) {
+        m_memory[loc].store(image.getMemory(loc), memory_order_relaxed);
+    }
+    m_entryPoint = image.getEntryPoint();
+}
+
+/*
+NAME:
+
+    addCore() - adds a core
+
+SYNOPSIS:
+
+    int MultiCoreEmulator::addCore(int a_location);
+    a_location  --> the location of the core's first instruction
+
+RETURNS:
+
+    int - the number identifying the core
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+int MultiCoreEmulator::addCore(int a_location)
+{
+    m_cores.emplace_back(new Core);
+    m_cores.back()->m_start = a_location;
+    return static_cast<int>(m_cores.size()) - 1;
+}
+
+/*
+NAME:
+
+    runProgram() - runs every core until each has halted
+
+SYNOPSIS:
+
+    bool MultiCoreEmulator::runProgram();
+
+DESCRIPTION:
+
+    The calling thread runs the first core, and one more thread is started for each other
+    core. The output device is flushed once every core has halted.
+
+RETURNS:
+
+    bool - returns false if a core stopped on an error, true otherwise
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+bool MultiCoreEmulator::runProgram()
+{
+    if (m_cores.empty()) {
+        addCore(m_entryPoint);
+    }
+    m_isStopping.store(false);
+    m_output->writeText("\nRunning the Emulator, Ritika's version\n");
+
+    vector<thread> threads;
+    for (size_t core = 1; core < m_cores.size(); core++) {
+        threads.emplace_back(&MultiCoreEmulator::runCore, this, ref(*m_cores[core]));
+    }
+    runCore(*m_cores[0]);
+    for (thread& core : threads) {
+        core.join();
+    }
+    m_output->flush();
+    return !m_isStopping.load();
+}
+
+/*
+NAME:
+
+    runCore() - runs one core until it halts
+
+SYNOPSIS:
+
+    void MultiCoreEmulator::runCore(Core& a_core);
+    a_core      --> the core
+
+DESCRIPTION:
+
+    Each instruction is fetched from the shared memory and decoded as it is executed, so
+    a core sees code written by the others. Memory is read and written with sequentially
+    consistent atomic operations, one per instruction that uses memory. The registers are
+    the core's own. The core also stops before its next instruction once another core has
+    stopped on an error.
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void MultiCoreEmulator::runCore(Core& a_core)
+{
+    MemoryWord* reg = a_core.m_reg;
+    long long steps = 0;
+    int pc = a_core.m_start;
+    while (pc >= 0 && pc < MEMSZ && !m_isStopping.load(memory_order_relaxed)) {
+        Instruction instruction = decodeWord(m_memory[pc].load());
+        int reg1 = instruction.m_reg1;
+        int reg2 = instruction.m_reg2;
+        int address = instruction.m_address;
+        int next = pc + 1;
+        steps++;
+
+        switch (instruction.m_opCode) {
+        case OP_EMPTY:
+            // zero words are skipped over
+            while (next < MEMSZ && m_memory[next].load() == 0) {
+                next++;
+            }
+            steps--;
+            break;
+        case 1:
+            if (!addWords(reg[reg1], m_memory[address].load(), reg[reg1])) {
+                a_core.m_steps = steps;
+                return stopOnError("Error! Arithmetic overflow at location " + to_string(pc));
+            }
+            break;
+        case 2:
+            if (!subtractWords(reg[reg1], m_memory[address].load(), reg[reg1])) {
+                a_core.m_steps = steps;
+                return stopOnError("Error! Arithmetic overflow at location " + to_string(pc));
+            }
+            break;
+        case 3:
+            if (!multiplyWords(reg[reg1], m_memory[address].load(), reg[reg1])) {
+                a_core.m_steps = steps;
+                return stopOnError("Error! Arithmetic overflow at location " + to_string(pc));
+            }
+            break;
+        case 4:
+            reg[reg1] /= m_memory[address].load();
+            break;
+        case 5:
+            reg[reg1] = m_memory[address].load();
+            break;
+        case 6:
+            m_memory[address].store(reg[reg1]);
+            break;
+        case 7:
+            if (!addWords(reg[reg1], reg[reg2], reg[reg1])) {
+                a_core.m_steps = steps;
+                return stopOnError("Error! Arithmetic overflow at location " + to_string(pc));
+            }
+            break;
+        case 8:
+            if (!subtractWords(reg[reg1], reg[reg2], reg[reg1])) {
+                a_core.m_steps = steps;
+                return stopOnError("Error! Arithmetic overflow at location " + to_string(pc));
+            }
+            break;
+        case 9:
+            if (!multiplyWords(reg[reg1], reg[reg2], reg[reg1])) {
+                a_core.m_steps = steps;
+                return stopOnError("Error! Arithmetic overflow at location " + to_string(pc));
+            }
+            break;
+        case 10:
+            reg[reg1] /= reg[reg2];
+            break;
+        case 11:
+            readInput(address);
+            break;
+        case 12:
+            writeOutput(address);
+            break;
+        case 13:
+            next = address;
+            break;
+        case 14:
+            if (reg[reg1] < 0) {
+                next = address;
+            }
+            break;
+        case 15:
+            if (reg[reg1] == 0) {
+                next = address;
+            }
+            break;
+        case 16:
+            if (reg[reg1] > 0) {
+                next = address;
+            }
+            break;
+        case 17:
+            next = MEMSZ;
+            break;
+        default:
+            a_core.m_steps = steps;
+            return stopOnError("Error! Error in OpCode!!");
+        }
+        pc = next;
+    }
+    a_core.m_steps = steps;
+}
+
+/*
+NAME:
+
+    readInput(), writeOutput() - execute READ and WRITE
+
+SYNOPSIS:
+
+    void MultiCoreEmulator::readInput(int a_address);
+    void MultiCoreEmulator::writeOutput(int a_address);
+    a_address   --> the memory location read into or written
+
+DESCRIPTION:
+
+    Both hold the I/O lock, so that a prompt and the number read after it, or a line of
+    output, are never split by another core. A READ behaves as Emulator::readInput() does.
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void MultiCoreEmulator::readInput(int a_address)
+{
+    lock_guard<mutex> lock(m_ioLock);
+    int userInput = 0;
+    if (m_input->isInteractive()) {
+        m_output->writeText("Enter: \n? ");
+        m_output->flush();
+    }
+    m_input->read(userInput);
+    if (userInput < MEMSZ) {
+        m_memory[a_address].store(userInput);
+    }
+    else {
+        m_output->writeText("Too large value\n");
+    }
+}
+
+void MultiCoreEmulator::writeOutput(int a_address)
+{
+    lock_guard<mutex> lock(m_ioLock);
+    m_output->writeWord(m_memory[a_address].load());
+}
+
+/*
+NAME:
+
+    stopOnError() - stops every core on an error
+
+SYNOPSIS:
+
+    void MultiCoreEmulator::stopOnError(const string& a_message);
+    a_message   --> the error
+
+DESCRIPTION:
+
+    The error goes to the output device, under the lock that orders the cores' READs and
+    WRITEs, so that it follows the output written before it.
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void MultiCoreEmulator::stopOnError(const string& a_message)
+{
+    m_isStopping.store(true);
+    lock_guard<mutex> lock(m_ioLock);
+    m_output->flush();
+    m_output->writeError(a_message);
+}
+
+/*
+NAME:
+
+    decodeWord() - splits an instruction word into its fields
+
+SYNOPSIS:
+
+    MultiCoreEmulator::Instruction MultiCoreEmulator::decodeWord(MemoryWord a_word);
+    a_word      --> the word
+
+DESCRIPTION:
+
+    The same divisions as Emulator::decodeWord(). Zero words are recorded as OP_EMPTY, and
+    words whose op code is not 1 - 17 as OP_ILLEGAL.
+
+RETURNS:
+
+    Instruction - the fields
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+MultiCoreEmulator::Instruction MultiCoreEmulator::decodeWord(MemoryWord a_word)
+{
+    Instruction decoded;
+    long long OpCode = a_word / 10'000'000;
+    if (a_word == 0) {
+        decoded.m_opCode = OP_EMPTY;
+    }
+    else if (OpCode < 1 || OpCode > 17) {
+        decoded.m_opCode = OP_ILLEGAL;
+    }
+    else {
+        decoded.m_opCode = static_cast<int>(OpCode);
+    }
+    decoded.m_reg1 = static_cast<int>((a_word / 1'000'000) % 10);
+    decoded.m_reg2 = static_cast<int>((a_word / 100'000) % 10);
+    decoded.m_address = static_cast<int>(a_word % 1'000'000);
+    return decoded;
+}
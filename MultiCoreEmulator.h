@@ -0,0 +1,109 @@
+//
+//		MultiCoreEmulator class - runs several VC8000 cores, one per thread, on one shared memory
+//
+#ifndef _MULTICOREEMULATOR_H
+#define _MULTICOREEMULATOR_H
+
+#include "Emulator.h"
+#include "IoDevices.h"
+
+// Each core has its own registers and program counter and runs on a thread of its own.  The
+// cores share one memory, loaded from a program image, and one pair of I/O devices.
+//
+// The memory model:
+//  - Every word of memory is an atomic variable, and every instruction that uses memory
+//    makes exactly one access to it: ADD, SUB, MULT, DIV, LOAD and WRITE read the word,
+//    and STORE and READ write it.  Fetching an instruction is also one read of its word.
+//  - Every access is sequentially consistent: the accesses of all the cores take place in
+//    one order that keeps each core's accesses in the order it executed them, and every read
+//    returns the latest write to its word in that order.  No core sees part of a word.
+//  - A core that writes into code is seen by every core that fetches the word afterwards.
+//  - READs and WRITEs are executed under one lock.  Each READ takes the next number from
+//    the input device, and each WRITE's line is written whole.  WRITEs from one core appear
+//    in the order it executed them.  WRITEs from different cores appear in the order the
+//    cores took the lock, which is consistent with the order of the memory accesses.
+//  - When one core stops on an error, the other cores stop before their next instruction.
+class MultiCoreEmulator {
+
+public:
+
+    const static int MEMSZ = Emulator::MEMSZ;   // The size of the shared memory.
+
+    // Loads the shared memory from a program image, a snapshot of an emulator with the
+    // program loaded and not yet run.  READs read from cin and WRITEs go to cout until
+    // setDevices() is called.
+    explicit MultiCoreEmulator(const Emulator::Snapshot& a_image);
+
+    MultiCoreEmulator(const MultiCoreEmulator&) = delete;
+    MultiCoreEmulator& operator=(const MultiCoreEmulator&) = delete;
+
+    // Adds a core that starts at a location.  Returns the number identifying it.
+    int addCore(int a_location);
+
+    // Replaces the devices every core's READs take their input from and WRITEs go to.
+    void setDevices(shared_ptr<InputDevice> a_input, shared_ptr<OutputDevice> a_output) {
+        m_input = a_input;
+        m_output = a_output;
+    }
+
+    // Runs every core on a thread of its own until each has halted.  Without any cores
+    // added, one core runs from the image's entry point.  Returns false if a core stopped on
+    // an error, true otherwise.
+    bool runProgram();
+
+    // Returns the number of cores.
+    int getCoreCount() const { return static_cast<int>(m_cores.size()); }
+
+    // Returns the number of instructions a core executed in the last run.
+    long long getSteps(int a_core) const { return m_cores[a_core]->m_steps; }
+
+    // Returns a register of a core, or the contents of a location in the shared memory.
+    MemoryWord getRegister(int a_core, int a_register) const { return m_cores[a_core]->m_reg[a_register]; }
+    MemoryWord getMemory(int a_location) const { return m_memory[a_location].load(); }
+
+private:
+
+    // The fields of an instruction word.
+    struct Instruction {
+        int m_opCode;       // 1 - 17, or OP_EMPTY or OP_ILLEGAL.
+        int m_reg1;
+        int m_reg2;
+        int m_address;
+    };
+
+    // Special values of Instruction::m_opCode.
+    enum {
+        OP_EMPTY = 0,       // The word is zero and is skipped over.
+        OP_ILLEGAL = 18     // The word does not hold a valid instruction.
+    };
+
+    // The registers and program counter of one core.
+    struct Core {
+        MemoryWord m_reg[10] = { 0 };   // Registers for the VC8000.
+        int m_start = 0;                // The location it starts at.
+        long long m_steps = 0;          // The instructions it executed in the last run.
+    };
+
+    // Splits a word into its fields the same way Emulator::decodeWord() does.
+    static Instruction decodeWord(MemoryWord a_word);
+
+    // Runs one core from its start until it halts, or until another core stops on an error.
+    void runCore(Core& a_core);
+
+    // Executes READ and WRITE under the I/O lock.
+    void readInput(int a_address);
+    void writeOutput(int a_address);
+
+    // Stops every core, displaying an error after the output written before it.
+    void stopOnError(const string& a_message);
+
+    unique_ptr<atomic<MemoryWord>[]> m_memory;      // The shared memory.
+    vector<unique_ptr<Core>> m_cores;               // Every core, in the order it was added.
+    shared_ptr<InputDevice> m_input;                // Device every READ takes its input from.
+    shared_ptr<OutputDevice> m_output;              // Device every WRITE and message goes to.
+    int m_entryPoint;                               // The image's entry point.
+    mutex m_ioLock;                                 // Held by a core executing READ or WRITE.
+    atomic<bool> m_isStopping{ false };             // == true once a core has stopped on an error.
+};
+
+#endif
@@ -0,0 +1,169 @@
+//
+//		PagedMemory class - an array whose pages are only allocated once they are written
+//
+#ifndef _PAGEDMEMORY_H
+#define _PAGEDMEMORY_H
+
+// Elements are read through a table of pages.  Until an element of a page is written, the page
+// is the shared zero page, so a large memory that a program barely uses costs little more than
+// its page table.  Element must be a type whose value-initialized state is all zero bits.
+//
+// A snapshot shares the pages of the memory it was taken from.  A shared page is copied the
+// first time either side writes to it, and the memory remembers which pages it has copied or
+// allocated since it last matched a snapshot, so returning to that snapshot only touches them.
+template <class Element>
+class PagedMemory {
+
+    typedef vector<shared_ptr<Element>> PageList;
+
+public:
+
+    const static int PAGE_SIZE = 1024;     // The number of elements in each page.
+
+    // The pages of a memory at one moment.  Copying a snapshot only copies a reference.
+    class Snapshot {
+    public:
+        Snapshot() { }
+    private:
+        friend class PagedMemory;
+        explicit Snapshot(const shared_ptr<const PageList>& a_pages) : m_pages(a_pages) { }
+        shared_ptr<const PageList> m_pages;     // The pages; a null page is the zero page.
+    };
+
+    explicit PagedMemory(int a_size)
+    : m_size(a_size),
+      m_pages((a_size + PAGE_SIZE - 1) / PAGE_SIZE, s_zeroPage),
+      m_writablePages(m_pages.size(), nullptr),
+      m_base(make_shared<PageList>(m_pages.size()))
+    { }
+
+    // Creates a memory holding the contents of a snapshot, sharing its pages.
+    PagedMemory(int a_size, const Snapshot& a_snapshot)
+    : PagedMemory(a_size)
+    {
+        restore(a_snapshot);
+    }
+
+    PagedMemory(const PagedMemory&) = delete;
+    PagedMemory& operator=(const PagedMemory&) = delete;
+
+    // Returns the number of elements.
+    int size() const { return m_size; }
+
+    // Returns an element for reading.
+    const Element& get(int a_index) const {
+        return m_pages[static_cast<unsigned>(a_index) / PAGE_SIZE][static_cast<unsigned>(a_index) % PAGE_SIZE];
+    }
+
+    // Returns an element for writing, giving its page its own elements if it is still the
+    // zero page or is shared with a snapshot.
+    Element& getWritable(int a_index) {
+        Element* page = m_writablePages[static_cast<unsigned>(a_index) / PAGE_SIZE];
+        if (page == nullptr) {
+            page = allocatePage(static_cast<unsigned>(a_index) / PAGE_SIZE);
+        }
+        return page[static_cast<unsigned>(a_index) % PAGE_SIZE];
+    }
+
+    // Returns the elements of a page for reading.
+    const Element* getPage(int a_page) const { return m_pages[a_page]; }
+
+    // Returns the table of pages, which stays at the same address for the life of the memory.
+    // The pages it points to change when a page is written for the first time.
+    const Element* const* getPageTable() const { return m_pages.data(); }
+
+    // Checks whether a page has been allocated, by this memory or by a snapshot it shares.
+    bool isAllocated(int a_page) const { return m_pages[a_page] != s_zeroPage; }
+
+    // Returns the number of pages that are not the zero page, including shared ones.
+    int getAllocatedPages() const { return m_allocatedPages; }
+
+    // Returns the number of pages written since the memory last matched a snapshot.
+    int getDirtyPages() const { return static_cast<int>(m_dirtyPages.size()); }
+
+    // Returns the bytes taken by the allocated pages and the page tables.  Pages shared with
+    // snapshots are counted in full.
+    size_t getResidentBytes() const {
+        return m_allocatedPages * sizeof(Element) * PAGE_SIZE +
+            m_pages.capacity() * sizeof(Element*) + m_writablePages.capacity() * sizeof(Element*) +
+            m_dirtyPages.capacity() * sizeof(OwnedPage);
+    }
+
+    // Takes a snapshot of the memory.  The pages written since the last snapshot become
+    // shared, and are copied again the next time they are written.
+    Snapshot takeSnapshot() {
+        if (!m_dirtyPages.empty()) {
+            shared_ptr<PageList> pages = make_shared<PageList>(*m_base);
+            for (const OwnedPage& dirty : m_dirtyPages) {
+                (*pages)[dirty.m_page] = dirty.m_elements;
+                m_writablePages[dirty.m_page] = nullptr;
+            }
+            m_dirtyPages.clear();
+            m_base = pages;
+        }
+        return Snapshot(m_base);
+    }
+
+    // Replaces the contents of the memory with a snapshot.  Returning to the snapshot the
+    // memory last matched only resets the pages written since.
+    void restore(const Snapshot& a_snapshot) {
+        if (a_snapshot.m_pages == m_base) {
+            for (const OwnedPage& dirty : m_dirtyPages) {
+                sharePage(dirty.m_page, (*m_base)[dirty.m_page]);
+            }
+        }
+        else {
+            m_base = a_snapshot.m_pages;
+            for (size_t page = 0; page < m_pages.size(); page++) {
+                sharePage(static_cast<int>(page), (*m_base)[page]);
+            }
+        }
+        m_dirtyPages.clear();
+    }
+
+private:
+
+    // Gives a page its own elements: zeroed if it was the zero page, otherwise a copy of
+    // the page it shared with a snapshot.
+    Element* allocatePage(int a_page) {
+        Element* page = new Element[PAGE_SIZE]();
+        if (m_pages[a_page] != s_zeroPage) {
+            std::copy(m_pages[a_page], m_pages[a_page] + PAGE_SIZE, page);
+        }
+        else {
+            m_allocatedPages++;
+        }
+        m_pages[a_page] = page;
+        m_writablePages[a_page] = page;
+        m_dirtyPages.push_back(OwnedPage{ a_page, shared_ptr<Element>(page, default_delete<Element[]>()) });
+        return page;
+    }
+
+    // Makes a page read the elements of a snapshot's page, which m_base keeps alive.
+    void sharePage(int a_page, const shared_ptr<Element>& a_shared) {
+        m_allocatedPages += (a_shared ? 1 : 0) - (isAllocated(a_page) ? 1 : 0);
+        m_pages[a_page] = a_shared ? a_shared.get() : s_zeroPage;
+        m_writablePages[a_page] = nullptr;
+    }
+
+    int m_size;                                 // The number of elements.
+    vector<Element*> m_pages;                   // The elements of each page.
+    vector<Element*> m_writablePages;           // The elements of each page this memory may write, or nullptr.
+    // A page written since the memory last matched a snapshot, and the elements it was given.
+    // Every other page is the zero page or one of m_base's, so only these need keeping alive.
+    struct OwnedPage {
+        int m_page;
+        shared_ptr<Element> m_elements;
+    };
+
+    shared_ptr<const PageList> m_base;          // The pages of the snapshot the memory last matched.
+    vector<OwnedPage> m_dirtyPages;             // The pages written since then.
+    int m_allocatedPages = 0;                   // The number of pages that are not the zero page.
+
+    static Element s_zeroPage[PAGE_SIZE];       // Read in place of every page not yet written.
+};
+
+template <class Element>
+Element PagedMemory<Element>::s_zeroPage[PagedMemory<Element>::PAGE_SIZE];
+
+#endif
@@ -0,0 +1,288 @@
+//
+//		Implementation of the PerfCounters class.
+//
+#include "stdafx.h"
+#include "PerfCounters.h"
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <string.h>
+#endif
+
+namespace {
+#if defined(__linux__)
+    // Opens the counter of one event for the calling thread on any processor, counting only
+    // the user's instructions so that it needs no more than the default permissions.  The
+    // counter starts disabled.  Returns its file descriptor, or -1 if the event is not available.
+    int openCounter(unsigned a_type, unsigned long long a_config)
+    {
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = a_type;
+        attr.config = a_config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+
+    // The configuration of a cache event that counts the read misses of a cache.
+    unsigned long long readMisses(unsigned long long a_cache)
+    {
+        return a_cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    }
+#endif
+}
+
+/*
+NAME:
+
+    PerfCounters() - opens the counters of the calling thread
+
+SYNOPSIS:
+
+    PerfCounters::PerfCounters();
+
+DESCRIPTION:
+
+    Each event is opened on its own rather than in a group, so that a host that lacks one of
+    them, as virtual machines often lack the cache events, still counts the others.
+
+RETURNS:
+
+    constructor, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+PerfCounters::PerfCounters()
+{
+    for (int event = 0; event < EVENT_COUNT; event++) {
+        m_fd[event] = -1;
+    }
+#if defined(__linux__)
+    m_fd[Cycles] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    m_fd[Instructions] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    m_fd[BranchMisses] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+    m_fd[L1Misses] = openCounter(PERF_TYPE_HW_CACHE, readMisses(PERF_COUNT_HW_CACHE_L1D));
+    m_fd[LlcMisses] = openCounter(PERF_TYPE_HW_CACHE, readMisses(PERF_COUNT_HW_CACHE_LL));
+#endif
+}
+
+/*
+NAME:
+
+    ~PerfCounters() - closes the counters
+
+SYNOPSIS:
+
+    PerfCounters::~PerfCounters();
+
+RETURNS:
+
+    destructor, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+PerfCounters::~PerfCounters()
+{
+#if defined(__linux__)
+    for (int event = 0; event < EVENT_COUNT; event++) {
+        if (m_fd[event] >= 0) {
+            close(m_fd[event]);
+        }
+    }
+#endif
+}
+
+/*
+NAME:
+
+    isAvailable() - checks whether any event can be counted
+
+SYNOPSIS:
+
+    bool PerfCounters::isAvailable() const;
+
+RETURNS:
+
+    bool - true if at least one event has a counter, false if phases are only timed
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+bool PerfCounters::isAvailable() const
+{
+    for (int event = 0; event < EVENT_COUNT; event++) {
+        if (m_fd[event] >= 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+NAME:
+
+    getName() - returns the name of an event
+
+SYNOPSIS:
+
+    const char* PerfCounters::getName(Event a_event);
+    a_event     --> the event
+
+RETURNS:
+
+    const char* - the name, as it is displayed
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+const char* PerfCounters::getName(Event a_event)
+{
+    switch (a_event) {
+    case Cycles:
+        return "Cycles";
+    case Instructions:
+        return "Instructions";
+    case BranchMisses:
+        return "Branch misses";
+    case L1Misses:
+        return "L1 misses";
+    case LlcMisses:
+        return "LLC misses";
+    default:
+        return "";
+    }
+}
+
+/*
+NAME:
+
+    start() - starts measuring
+
+SYNOPSIS:
+
+    void PerfCounters::start();
+
+DESCRIPTION:
+
+    The counters are reset and enabled, and then the clock is read, so that as little of
+    start() as possible is counted.
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void PerfCounters::start()
+{
+#if defined(__linux__)
+    for (int event = 0; event < EVENT_COUNT; event++) {
+        if (m_fd[event] >= 0) {
+            ioctl(m_fd[event], PERF_EVENT_IOC_RESET, 0);
+            ioctl(m_fd[event], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+#endif
+    m_start = chrono::steady_clock::now();
+}
+
+/*
+NAME:
+
+    stop() - stops measuring and returns what was measured
+
+SYNOPSIS:
+
+    PerfCounters::Reading PerfCounters::stop();
+
+DESCRIPTION:
+
+    The clock is read, and then the counters are disabled and read.  A counter that shared
+    the host's counters with others ran for only part of the time it was enabled, so its
+    count is scaled up by the time enabled over the time it ran.  A counter that could not be
+    read is left uncounted.
+
+RETURNS:
+
+    Reading - the time and counts since start()
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+PerfCounters::Reading PerfCounters::stop()
+{
+    Reading reading;
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - m_start;
+    reading.m_seconds = elapsed.count();
+
+#if defined(__linux__)
+    for (int event = 0; event < EVENT_COUNT; event++) {
+        if (m_fd[event] >= 0) {
+            ioctl(m_fd[event], PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+    for (int event = 0; event < EVENT_COUNT; event++) {
+        // the count, the time enabled and the time running
+        unsigned long long values[3];
+        if (m_fd[event] < 0 || read(m_fd[event], values, sizeof(values)) != sizeof(values) || values[2] == 0) {
+            continue;
+        }
+        double scale = static_cast<double>(values[1]) / values[2];
+        reading.m_counts[event] = static_cast<long long>(values[0] * scale);
+        reading.m_isCounted[event] = true;
+    }
+#endif
+    return reading;
+}
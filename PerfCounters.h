@@ -0,0 +1,54 @@
+//
+//		PerfCounters class - measures a phase of the assembler with the host's performance counters
+//
+#ifndef _PERFCOUNTERS_H
+#define _PERFCOUNTERS_H
+
+// Counts the host's cycles, instructions, branch misses and cache misses between start() and
+// stop(), so that a slow run can be put down to mispredicted branches, missed caches or the
+// instructions of the dispatch itself.  The counters are read with perf_event_open() on Linux.
+// Where it is not available, because of the host, its permissions or a virtual machine that
+// does not pass the counters through, each event that cannot be opened is left uncounted and
+// the phase is only timed.
+class PerfCounters {
+
+public:
+
+    // The events counted.  EVENT_COUNT is the number of them.
+    enum Event { Cycles, Instructions, BranchMisses, L1Misses, LlcMisses, EVENT_COUNT };
+
+    // What was measured between a start() and a stop().
+    struct Reading {
+        double m_seconds = 0;                       // Wall clock time.
+        long long m_counts[EVENT_COUNT] = { 0 };    // The count of each event.
+        bool m_isCounted[EVENT_COUNT] = { false };  // == true if the event could be counted.
+    };
+
+    // Opens the counters of the calling thread.
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    // Checks whether any event can be counted, rather than only timed.
+    bool isAvailable() const;
+
+    // Returns the name of an event.
+    static const char* getName(Event a_event);
+
+    // Starts measuring from zero.
+    void start();
+
+    // Stops measuring and returns what was measured since start().  The counters are
+    // multiplexed when the host has fewer than the events, and the counts are then scaled to
+    // the whole time measured.
+    Reading stop();
+
+private:
+
+    int m_fd[EVENT_COUNT];      // The file descriptor of each event's counter, or -1.
+    chrono::steady_clock::time_point m_start;   // When start() was called.
+};
+
+#endif
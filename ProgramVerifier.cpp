@@ -0,0 +1,140 @@
+//
+//		Implementation of the ProgramVerifier class.
+//
+#include "stdafx.h"
+#include "ProgramVerifier.h"
+
+/*
+NAME:
+
+    ProgramVerifier() - verifies a program image
+
+SYNOPSIS:
+
+    ProgramVerifier::ProgramVerifier(const PagedMemory<MemoryWord>& a_memory, int a_size, int a_entryPoint);
+    a_memory    --> the memory holding the program
+    a_size      --> the number of words of the memory
+    a_entryPoint --> the location of the first instruction executed
+
+DESCRIPTION:
+
+    Control is followed from the entry point through one straight run of words at a time:
+    zero words are passed over, B ends a run and starts one at its target, BM, BZ and BP
+    start one at their target and go on, and HALT ends a run, as does running off the end
+    of memory. A run also ends at a word already followed. Each word that is not zero is
+    split as the engines split it; register fields are single digits, so they are always
+    in range, and the op code and address are checked. Once every path is followed, the
+    addresses of the STOREs and READs are checked against the code.
+
+RETURNS:
+
+    constructor, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+ProgramVerifier::ProgramVerifier(const PagedMemory<MemoryWord>& a_memory, int a_size, int a_entryPoint)
+{
+    if (a_entryPoint < 0 || a_entryPoint >= a_size) {
+        fail(a_entryPoint, "the entry point is outside memory");
+        return;
+    }
+    vector<char> isCode(a_size, 0);
+    vector<int> pending(1, a_entryPoint);
+    vector<pair<int, int>> stores;      // The address of each STORE and READ, and its location.
+
+    while (!pending.empty()) {
+        int loc = pending.back();
+        pending.pop_back();
+        bool isRunning = true;
+        while (isRunning && loc < a_size && !isCode[loc]) {
+            isCode[loc] = 1;
+            m_codeWords++;
+            MemoryWord word = a_memory.get(loc);
+            if (word == 0) {
+                loc++;
+                continue;
+            }
+            long long opCode = word / 10'000'000;
+            int address = static_cast<int>(word % 1'000'000);
+            if (word < 0 || opCode < 1 || opCode > 17) {
+                fail(loc, "the word is not an instruction");
+                return;
+            }
+            if (address >= a_size) {
+                fail(loc, "the address is outside memory");
+                return;
+            }
+            switch (opCode) {
+            case 6:
+            case 11:
+                stores.push_back({ address, loc });
+                break;
+            case 13:
+                pending.push_back(address);
+                isRunning = false;
+                break;
+            case 14:
+            case 15:
+            case 16:
+                pending.push_back(address);
+                break;
+            case 17:
+                isRunning = false;
+                break;
+            }
+            loc++;
+        }
+    }
+
+    for (const pair<int, int>& store : stores) {
+        if (isCode[store.first]) {
+            fail(store.second, "it stores into the code at location " + to_string(store.first));
+            return;
+        }
+        m_storeTargets.push_back(store.first);
+    }
+    sort(m_storeTargets.begin(), m_storeTargets.end());
+    m_storeTargets.erase(unique(m_storeTargets.begin(), m_storeTargets.end()), m_storeTargets.end());
+    m_isVerified = true;
+}
+
+/*
+NAME:
+
+    fail() - records why the program cannot be verified
+
+SYNOPSIS:
+
+    void ProgramVerifier::fail(int a_location, const string& a_failure);
+    a_location  --> the location of the word that keeps it from being verified, or -1
+    a_failure   --> what is wrong with the word
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void ProgramVerifier::fail(int a_location, const string& a_failure)
+{
+    m_isVerified = false;
+    m_failure = a_failure;
+    m_failureLocation = a_location;
+    m_storeTargets.clear();
+}
@@ -0,0 +1,49 @@
+//
+//		ProgramVerifier class - proves before a run that a VC8000 program never changes its own code
+//
+#ifndef _PROGRAMVERIFIER_H
+#define _PROGRAMVERIFIER_H
+
+#include "MemoryWord.h"
+#include "PagedMemory.h"
+
+// Follows every path control can take through a program image from its entry point, without
+// running it.  Every word control reaches or passes over is code.  The program is verified if
+// each word of code that is not zero is an instruction whose fields are in range, and no STORE
+// or READ it reaches has an address in the code.  A verified program's code stays as it was
+// loaded, so the emulator runs it on engines that do not watch its stores for changes to code.
+// VC8000 addresses are never computed, so every word the program can store into is known.
+class ProgramVerifier {
+
+public:
+
+    // Verifies the program in the first a_size words of a_memory, entered at a_entryPoint.
+    ProgramVerifier(const PagedMemory<MemoryWord>& a_memory, int a_size, int a_entryPoint);
+
+    // Checks whether the program was verified.
+    bool isVerified() const { return m_isVerified; }
+
+    // Returns why the program was not verified, and the location of the word that kept it
+    // from being, or -1.
+    const string& getFailure() const { return m_failure; }
+    int getFailureLocation() const { return m_failureLocation; }
+
+    // Returns the number of words control may reach or pass over.
+    int getCodeWords() const { return m_codeWords; }
+
+    // Returns the locations the program's STOREs and READs may write, in order.
+    const vector<int>& getStoreTargets() const { return m_storeTargets; }
+
+private:
+
+    // Records why the program cannot be verified.
+    void fail(int a_location, const string& a_failure);
+
+    bool m_isVerified = false;          // == true if the program was verified.
+    string m_failure;                   // Why it was not.
+    int m_failureLocation = -1;         // The word that kept it from being, or -1.
+    int m_codeWords = 0;                // Words control may reach or pass over.
+    vector<int> m_storeTargets;         // Words the program may store into.
+};
+
+#endif
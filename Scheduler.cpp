@@ -0,0 +1,366 @@
+//
+//		Implementation of the Scheduler class.
+//
+#include "stdafx.h"
+#include "Scheduler.h"
+
+/*
+NAME:
+
+    Scheduler() - starts the threads that run the instances
+
+SYNOPSIS:
+
+    Scheduler::Scheduler(int a_threads, long long a_quantum);
+    a_threads   --> the number of threads, or 0 for one per processor
+    a_quantum   --> the number of instructions in each time slice
+
+RETURNS:
+
+    constructor, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+Scheduler::Scheduler(int a_threads, long long a_quantum)
+: m_quantum(a_quantum > 0 ? a_quantum : 1)
+{
+    int threads = a_threads > 0 ? a_threads : static_cast<int>(thread::hardware_concurrency());
+    if (threads <= 0) {
+        threads = 1;
+    }
+    for (int worker = 0; worker < threads; worker++) {
+        m_workers.emplace_back(&Scheduler::work, this);
+    }
+}
+
+/*
+NAME:
+
+    ~Scheduler() - stops the threads
+
+SYNOPSIS:
+
+    Scheduler::~Scheduler();
+
+DESCRIPTION:
+
+    Each thread finishes the time slice it is running and exits. Instances still in the
+    queue are not run again.
+
+RETURNS:
+
+    destructor, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+Scheduler::~Scheduler()
+{
+    {
+        lock_guard<mutex> lock(m_lock);
+        m_isStopping = true;
+    }
+    m_isReady.notify_all();
+    for (thread& worker : m_workers) {
+        worker.join();
+    }
+}
+
+/*
+NAME:
+
+    addInstance() - adds an instance of a program and queues it to run
+
+SYNOPSIS:
+
+    int Scheduler::addInstance(const Emulator::Snapshot& a_image, shared_ptr<OutputDevice> a_output);
+    a_image     --> a snapshot of an emulator with the program loaded and not yet run
+    a_output    --> the device the instance's WRITEs and messages go to
+
+DESCRIPTION:
+
+    The emulator shares its pages with the image, so an instance only holds the pages its
+    program writes.
+
+RETURNS:
+
+    int - the number identifying the instance
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+int Scheduler::addInstance(const Emulator::Snapshot& a_image, shared_ptr<OutputDevice> a_output)
+{
+    unique_ptr<Instance> instance(new Instance);
+    instance->m_input = make_shared<QueueInput>();
+    instance->m_emulator.reset(new Emulator(a_image));
+    instance->m_emulator->setDevices(instance->m_input, a_output);
+    instance->m_emulator->setQuantum(m_quantum);
+
+    int number;
+    {
+        lock_guard<mutex> lock(m_lock);
+        m_instances.push_back(move(instance));
+        number = static_cast<int>(m_instances.size()) - 1;
+        m_ready.push_back(number);
+    }
+    m_isReady.notify_one();
+    return number;
+}
+
+/*
+NAME:
+
+    supplyInput(), closeInput() - add to an instance's input
+
+SYNOPSIS:
+
+    void Scheduler::supplyInput(int a_instance, int a_value);
+    void Scheduler::closeInput(int a_instance);
+    a_instance  --> the instance, as returned by addInstance()
+    a_value     --> a number for its READs
+
+DESCRIPTION:
+
+    An instance waiting for input is queued to run again. Both are done under the
+    scheduler's lock, which the thread running an instance also takes before deciding the
+    instance is waiting, so input supplied while it runs is never missed.
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void Scheduler::supplyInput(int a_instance, int a_value)
+{
+    unique_lock<mutex> lock(m_lock);
+    Instance& instance = *m_instances[a_instance];
+    instance.m_input->supply(a_value);
+    if (instance.m_state == State::WaitingForInput) {
+        instance.m_state = State::Ready;
+        m_ready.push_back(a_instance);
+        lock.unlock();
+        m_isReady.notify_one();
+    }
+}
+
+void Scheduler::closeInput(int a_instance)
+{
+    unique_lock<mutex> lock(m_lock);
+    Instance& instance = *m_instances[a_instance];
+    instance.m_input->close();
+    if (instance.m_state == State::WaitingForInput) {
+        instance.m_state = State::Ready;
+        m_ready.push_back(a_instance);
+        lock.unlock();
+        m_isReady.notify_one();
+    }
+}
+
+/*
+NAME:
+
+    getState(), getInstanceCount(), getSliceCount() - report on the instances
+
+SYNOPSIS:
+
+    Scheduler::State Scheduler::getState(int a_instance) const;
+    int Scheduler::getInstanceCount() const;
+    long long Scheduler::getSliceCount() const;
+    a_instance  --> the instance, as returned by addInstance()
+
+RETURNS:
+
+    the state of an instance, the number of instances, and the number of time slices run
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+Scheduler::State Scheduler::getState(int a_instance) const
+{
+    lock_guard<mutex> lock(m_lock);
+    return m_instances[a_instance]->m_state;
+}
+
+int Scheduler::getInstanceCount() const
+{
+    lock_guard<mutex> lock(m_lock);
+    return static_cast<int>(m_instances.size());
+}
+
+long long Scheduler::getSliceCount() const
+{
+    lock_guard<mutex> lock(m_lock);
+    return m_slices;
+}
+
+/*
+NAME:
+
+    waitUntilIdle() - waits until every instance has halted or is waiting for input
+
+SYNOPSIS:
+
+    void Scheduler::waitUntilIdle();
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void Scheduler::waitUntilIdle()
+{
+    unique_lock<mutex> lock(m_lock);
+    m_isIdle.wait(lock, [this] { return m_ready.empty() && m_running == 0; });
+}
+
+/*
+NAME:
+
+    work() - runs time slices until the scheduler is destroyed
+
+SYNOPSIS:
+
+    void Scheduler::work();
+
+DESCRIPTION:
+
+    Takes the instance at the front of the queue and runs one time slice of it without
+    holding the lock. An instance that used up its time slice goes to the back of the
+    queue. One that paused at a READ waits, unless input arrived while it was running. One
+    that halted has its emulator destroyed, freeing the pages it wrote.
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void Scheduler::work()
+{
+    unique_lock<mutex> lock(m_lock);
+    for (;;) {
+        m_isReady.wait(lock, [this] { return m_isStopping || !m_ready.empty(); });
+        if (m_isStopping) {
+            return;
+        }
+        int number = m_ready.front();
+        m_ready.pop_front();
+        Instance& instance = *m_instances[number];
+        instance.m_state = State::Running;
+        m_running++;
+        lock.unlock();
+
+        bool isPaused = runSlice(instance);
+        bool isWaiting = isPaused && instance.m_emulator->isWaitingForInput();
+        if (!isPaused) {
+            instance.m_emulator.reset();
+        }
+
+        lock.lock();
+        m_running--;
+        m_slices++;
+        if (!isPaused) {
+            instance.m_state = State::Halted;
+        }
+        else if (isWaiting && !instance.m_input->hasInput()) {
+            instance.m_state = State::WaitingForInput;
+        }
+        else {
+            instance.m_state = State::Ready;
+            m_ready.push_back(number);
+            m_isReady.notify_one();
+        }
+        if (m_ready.empty() && m_running == 0) {
+            m_isIdle.notify_all();
+        }
+    }
+}
+
+/*
+NAME:
+
+    runSlice() - runs one time slice of an instance
+
+SYNOPSIS:
+
+    bool Scheduler::runSlice(Instance& a_instance);
+    a_instance  --> the instance
+
+RETURNS:
+
+    bool - returns true if the program paused, false if it halted
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+bool Scheduler::runSlice(Instance& a_instance)
+{
+    if (!a_instance.m_isStarted) {
+        a_instance.m_isStarted = true;
+        return a_instance.m_emulator->runProgram();
+    }
+    return a_instance.m_emulator->resumeProgram();
+}
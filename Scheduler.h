@@ -0,0 +1,92 @@
+//
+//		Scheduler class - runs many emulators at once, taking turns on a small pool of threads
+//
+#ifndef _SCHEDULER_H
+#define _SCHEDULER_H
+
+#include "Emulator.h"
+#include "IoDevices.h"
+
+// Each instance is an emulator created from a program image, so its memory is the image's
+// pages until it writes them, and a READ takes its input from a queue filled by
+// supplyInput().  An instance runs for one time slice, a fixed number of instructions, and
+// then goes to the back of the queue of instances ready to run, so every ready instance makes
+// progress in turn.  An instance that reads past the input supplied so far pauses at the
+// READ and leaves the queue until more input is supplied, so instances waiting for input
+// take no thread.  An instance's emulator is destroyed as soon as the program halts.
+class Scheduler {
+
+public:
+
+    // Where an instance is in its life.
+    enum class State {
+        Ready,              // Waiting in the queue for a thread.
+        Running,            // Running its time slice on a thread.
+        WaitingForInput,    // Paused at a READ until input is supplied.
+        Halted              // Finished; its emulator has been destroyed.
+    };
+
+    // Starts a number of threads, or one per processor if it is zero.  Each time slice is
+    // a_quantum instructions.
+    explicit Scheduler(int a_threads = 0, long long a_quantum = 10000);
+
+    // Stops the threads once they finish their current time slices.  Instances that have
+    // not halted are dropped.
+    ~Scheduler();
+
+    Scheduler(const Scheduler&) = delete;
+    Scheduler& operator=(const Scheduler&) = delete;
+
+    // Adds an instance of a program, a snapshot of an emulator with the program loaded and
+    // not yet run, and queues it to run.  Its WRITEs and messages go to a_output.  Returns
+    // the number identifying it.
+    int addInstance(const Emulator::Snapshot& a_image, shared_ptr<OutputDevice> a_output);
+
+    // Supplies a number for an instance's READs, waking it if it is waiting for input.
+    void supplyInput(int a_instance, int a_value);
+
+    // Marks the end of an instance's input.  Its READs then no longer wait, as if reading
+    // past the end of a file.
+    void closeInput(int a_instance);
+
+    // Returns where an instance is in its life.
+    State getState(int a_instance) const;
+
+    // Returns the number of instances added.
+    int getInstanceCount() const;
+
+    // Returns the number of time slices run so far, by every instance.
+    long long getSliceCount() const;
+
+    // Waits until no instance is ready or running: each has halted or is waiting for input.
+    void waitUntilIdle();
+
+private:
+
+    // An emulator and its input.
+    struct Instance {
+        unique_ptr<Emulator> m_emulator;    // Destroyed once the program halts.
+        shared_ptr<QueueInput> m_input;     // Where the program's READs take their input.
+        State m_state = State::Ready;
+        bool m_isStarted = false;           // == true once its first time slice has run.
+    };
+
+    // Runs time slices of the instances in the queue until the scheduler is destroyed.
+    void work();
+
+    // Runs one time slice of an instance.  Returns true if it paused, false if it halted.
+    static bool runSlice(Instance& a_instance);
+
+    mutable mutex m_lock;                   // Guards the members below, except m_workers.
+    condition_variable m_isReady;           // Signalled when an instance joins the queue.
+    condition_variable m_isIdle;            // Signalled when no instance is ready or running.
+    deque<unique_ptr<Instance>> m_instances;    // Every instance, in the order it was added.
+    deque<int> m_ready;                     // The instances waiting for a thread, in turn.
+    int m_running = 0;                      // The number of instances running.
+    long long m_slices = 0;                 // The number of time slices run.
+    long long m_quantum;                    // The instructions in each time slice.
+    bool m_isStopping = false;              // == true once the threads are to finish.
+    vector<thread> m_workers;               // The threads running time slices.
+};
+
+#endif
@@ -26,6 +26,9 @@ public:
     // Lookup a symbol in the symbol table.
     bool LookupSymbol(const string& a_symbol, int& a_loc);
 
+    // Access all of the symbols and their locations.
+    const map<string, int>& GetSymbols() const { return m_symbolTable; }
+
 private:
 
     // This is the actual symbol table.  The symbol is the key to the map.  The value is the location.
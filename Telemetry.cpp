@@ -0,0 +1,146 @@
+//
+//		Implementation of the TelemetrySegment class.
+//
+#include "stdafx.h"
+#include "Telemetry.h"
+
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/*
+NAME:
+
+    TelemetrySegment() - creates or attaches to a named segment of counters
+
+SYNOPSIS:
+
+    TelemetrySegment::TelemetrySegment(const string& a_name, bool a_isCreating);
+    a_name      --> the name of the segment, without the leading / of POSIX names
+    a_isCreating --> true to create the segment, false to attach to an existing one
+
+DESCRIPTION:
+
+    A segment that is created replaces any left behind by an emulator that did not remove
+    it, and its counters are constructed in place with every counter zero. A reader maps the
+    segment read only.
+
+RETURNS:
+
+    constructor, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+TelemetrySegment::TelemetrySegment(const string& a_name, bool a_isCreating)
+: m_name(a_name),
+  m_isCreator(a_isCreating)
+{
+    void* view = nullptr;
+#if defined(_WIN32)
+    string name = "Local\\" + a_name;
+    if (a_isCreating) {
+        m_mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0,
+                                       static_cast<DWORD>(sizeof(TelemetryStats)), name.c_str());
+    }
+    else {
+        m_mapping = OpenFileMappingA(FILE_MAP_READ, FALSE, name.c_str());
+    }
+    if (m_mapping == nullptr) {
+        return;
+    }
+    view = MapViewOfFile(m_mapping, a_isCreating ? FILE_MAP_ALL_ACCESS : FILE_MAP_READ, 0, 0, sizeof(TelemetryStats));
+#else
+    string name = "/" + a_name;
+    int segment = a_isCreating ? shm_open(name.c_str(), O_CREAT | O_TRUNC | O_RDWR, 0644)
+                               : shm_open(name.c_str(), O_RDONLY, 0);
+    if (segment < 0) {
+        return;
+    }
+    struct stat status;
+    if (a_isCreating ? ftruncate(segment, sizeof(TelemetryStats)) == 0
+                     : fstat(segment, &status) == 0 && status.st_size >= static_cast<off_t>(sizeof(TelemetryStats))) {
+        view = mmap(nullptr, sizeof(TelemetryStats), a_isCreating ? PROT_READ | PROT_WRITE : PROT_READ,
+                    MAP_SHARED, segment, 0);
+        if (view == MAP_FAILED) {
+            view = nullptr;
+        }
+    }
+    close(segment);
+    if (view == nullptr && a_isCreating) {
+        shm_unlink(name.c_str());
+    }
+#endif
+    if (view == nullptr) {
+        return;
+    }
+
+    if (a_isCreating) {
+        m_stats = new (view) TelemetryStats();
+        m_stats->m_location.store(-1, memory_order_relaxed);
+    }
+    else {
+        m_stats = static_cast<TelemetryStats*>(view);
+    }
+}
+
+/*
+NAME:
+
+    ~TelemetrySegment() - detaches from the segment
+
+SYNOPSIS:
+
+    TelemetrySegment::~TelemetrySegment();
+
+DESCRIPTION:
+
+    The emulator that created the segment marks it closed and removes its name, so no new
+    reader can attach. Readers still attached keep their view of the final counters.
+
+RETURNS:
+
+    destructor, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+TelemetrySegment::~TelemetrySegment()
+{
+    if (m_stats != nullptr && m_isCreator) {
+        m_stats->m_isRunning.store(0, memory_order_relaxed);
+        m_stats->m_isClosed.store(1, memory_order_release);
+    }
+#if defined(_WIN32)
+    if (m_stats != nullptr) {
+        UnmapViewOfFile(m_stats);
+    }
+    if (m_mapping != nullptr) {
+        CloseHandle(m_mapping);
+    }
+#else
+    if (m_stats != nullptr) {
+        munmap(m_stats, sizeof(TelemetryStats));
+        if (m_isCreator) {
+            shm_unlink(("/" + m_name).c_str());
+        }
+    }
+#endif
+}
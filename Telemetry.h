@@ -0,0 +1,55 @@
+//
+//		Telemetry - counters an emulator publishes in shared memory for other processes to watch
+//
+#ifndef _TELEMETRY_H
+#define _TELEMETRY_H
+
+// The counters, laid out in the shared memory segment.  The emulator is the only writer, and
+// it stores each counter with a relaxed atomic store, so a reader sees every counter whole but
+// may see one more up to date than another.  The atomics are lock free on the hosts the
+// emulator runs on, so they work between processes.
+struct TelemetryStats {
+    const static int OP_CODES = 18;         // Room for the op codes 1 - 17, and 0 for any other word.
+
+    atomic<long long> m_instructions;       // Instructions executed.
+    atomic<long long> m_writes;             // WRITEs executed.
+    atomic<long long> m_readWaits;          // READs that paused for want of input.
+    atomic<long long> m_opCodes[OP_CODES];  // Instructions executed, by op code, sampled.
+    atomic<long long> m_updates;            // Times the counters have been published.
+    atomic<int> m_location;                 // Where the program is running or paused, or -1.
+    atomic<int> m_isRunning;                // == 1 while the emulator is in a run.
+    atomic<int> m_isClosed;                 // == 1 once the emulator has stopped publishing.
+};
+
+// A named segment of shared memory holding a TelemetryStats.  The emulator creates it, and
+// removes its name when done; a reader attaches to it by name.  On POSIX hosts it is made with
+// shm_open(), and on Windows it is a named file mapping.
+class TelemetrySegment {
+
+public:
+
+    // Creates the segment, with every counter zero, if a_isCreating; otherwise attaches to
+    // the segment of that name, for reading.  isOpen() tells whether it succeeded.
+    TelemetrySegment(const string& a_name, bool a_isCreating);
+    ~TelemetrySegment();
+
+    TelemetrySegment(const TelemetrySegment&) = delete;
+    TelemetrySegment& operator=(const TelemetrySegment&) = delete;
+
+    // Checks whether the segment could be created or attached to.
+    bool isOpen() const { return m_stats != nullptr; }
+
+    // Returns the counters.  Only valid if isOpen().
+    TelemetryStats& getStats() { return *m_stats; }
+
+private:
+
+    TelemetryStats* m_stats = nullptr;  // The counters, in the shared memory.
+    string m_name;                      // The name the segment was created with.
+    bool m_isCreator;                   // == true if this removes the name when destroyed.
+#if defined(_WIN32)
+    HANDLE m_mapping = nullptr;         // The file mapping object behind the segment.
+#endif
+};
+
+#endif
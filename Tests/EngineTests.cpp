@@ -0,0 +1,1085 @@
+//
+//		Tests of the emulator's engines and of the C++ translation, run by the VC8000Tests program.
+//
+#include "stdafx.h"
+#include "Emulator.h"
+#include "Errors.h"
+#include "BatchRunner.h"
+#include "CppTranslator.h"
+#include "LockstepEmulator.h"
+#include "MultiCoreEmulator.h"
+#include "Scheduler.h"
+
+namespace {
+
+int failures = 0;   // The number of checks that failed.
+
+/*
+NAME:
+
+    check() - records the result of one check
+
+SYNOPSIS:
+
+    void check(bool a_isPassed, const string& a_description);
+    a_isPassed      --> true if the check passed
+    a_description   --> what was checked
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void check(bool a_isPassed, const string& a_description)
+{
+    cout << (a_isPassed ? "ok     " : "FAILED ") << a_description << endl;
+    if (!a_isPassed) {
+        failures++;
+    }
+}
+
+/*
+NAME:
+
+    word() - builds an instruction word
+
+SYNOPSIS:
+
+    long long word(int a_opCode, int a_reg1, int a_reg2, int a_address);
+    a_opCode    --> the operation code
+    a_reg1      --> the first register
+    a_reg2      --> the second register
+    a_address   --> the address
+
+RETURNS:
+
+    long long - returns the word the assembler would build for the instruction
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+long long word(int a_opCode, int a_reg1, int a_reg2, int a_address)
+{
+    return a_opCode * 10'000'000LL + a_reg1 * 1'000'000LL + a_reg2 * 100'000LL + a_address;
+}
+
+/*
+NAME:
+
+    makeEmulator() - makes an emulator with a program in memory
+
+SYNOPSIS:
+
+    unique_ptr<Emulator> makeEmulator(Emulator::Engine a_engine, const vector<pair<int, long long>>& a_program, const vector<int>& a_input);
+    a_engine    --> the engine to run the program with
+    a_program   --> the location and contents of each word of the program
+    a_input     --> the numbers its READs take
+
+DESCRIPTION:
+
+    The program starts at location 100, and its WRITEs and messages are discarded.
+
+RETURNS:
+
+    unique_ptr<Emulator> - returns the emulator
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+unique_ptr<Emulator> makeEmulator(Emulator::Engine a_engine, const vector<pair<int, long long>>& a_program, const vector<int>& a_input)
+{
+    static ostringstream discarded;
+    unique_ptr<Emulator> emulator(new Emulator(make_shared<VectorInput>(a_input), make_shared<BufferedOutput>(discarded)));
+    emulator->setEngine(a_engine);
+    for (const auto& location : a_program) {
+        emulator->insertMemory(location.first, location.second);
+    }
+    emulator->setEntryPoint(100);
+    return emulator;
+}
+
+/*
+NAME:
+
+    testSwitchAfterJitFlush() - runs the switch engine on code stored before the JIT flushed
+
+SYNOPSIS:
+
+    void testSwitchAfterJitFlush();
+
+DESCRIPTION:
+
+    The program stores a HALT at 120, then READs into its own translated code, which makes
+    the JIT throw its translations away in the middle of the run. The word at 120 must still
+    be decoded again for the switch engine, which otherwise finds the empty word it was
+    loaded with there and passes over it. The switch engine runs with a time slice, so that
+    a stale entry pauses the run rather than hanging it.
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void testSwitchAfterJitFlush()
+{
+#if defined(__x86_64__) || defined(_M_X64)
+    // The READ stores the word already at 101, so only the flush changes.
+    auto emulator = makeEmulator(Emulator::Engine::Jit, {
+        { 100, word(5, 1, 0, 200) },        // load 1,200
+        { 101, word(6, 1, 0, 120) },        // store 1,120
+        { 102, word(13, 0, 0, 110) },       // b 110
+        { 110, word(11, 0, 0, 101) },       // read 0,101
+        { 111, word(17, 0, 0, 0) },         // halt
+        { 200, word(17, 0, 0, 0) }          // dc of a halt
+    }, { static_cast<int>(word(6, 1, 0, 120)) });
+    emulator->runProgram();
+    check(emulator->getTermination() == Emulator::Termination::Halted, "jit run that flushes halts");
+    check(emulator->getMemory(120) == word(17, 0, 0, 0), "jit run stores the halt");
+
+    emulator->setEngine(Emulator::Engine::Switch);
+    emulator->setEntryPoint(120);
+    emulator->setQuantum(1'000);
+    emulator->runProgram();
+    check(emulator->getTermination() == Emulator::Termination::Halted, "switch run after the jit flushed executes the stored halt");
+#endif
+}
+
+/*
+NAME:
+
+    testJitAfterWordChanged() - runs translations again after a translated word changed
+
+SYNOPSIS:
+
+    void testJitAfterWordChanged();
+
+DESCRIPTION:
+
+    The LOAD of a translated block is replaced between JIT runs, first by insertMemory()
+    and then by a store of a switch engine run. Each JIT run must load through the word as
+    it is now, rather than run the translation of the word it replaced.
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void testJitAfterWordChanged()
+{
+#if defined(__x86_64__) || defined(_M_X64)
+    auto emulator = makeEmulator(Emulator::Engine::Jit, {
+        { 100, word(5, 1, 0, 200) },        // load 1,200
+        { 101, word(6, 1, 0, 210) },        // store 1,210
+        { 102, word(17, 0, 0, 0) },         // halt
+        { 110, word(5, 2, 0, 203) },        // load 2,203
+        { 111, word(6, 2, 0, 100) },        // store 2,100
+        { 112, word(17, 0, 0, 0) },         // halt
+        { 200, 111 }, { 201, 222 }, { 202, 333 },
+        { 203, word(5, 1, 0, 202) }         // dc of load 1,202
+    }, { });
+    emulator->runProgram();
+    check(emulator->getMemory(210) == 111, "jit run loads through the translated word");
+
+    emulator->insertMemory(100, word(5, 1, 0, 201));
+    emulator->runProgram();
+    check(emulator->getMemory(210) == 222, "jit run after insertMemory loads through the new word");
+
+    emulator->setEngine(Emulator::Engine::Switch);
+    emulator->setEntryPoint(110);
+    emulator->runProgram();
+    emulator->setEngine(Emulator::Engine::Jit);
+    emulator->setEntryPoint(100);
+    emulator->runProgram();
+    check(emulator->getMemory(210) == 333, "jit run after a switch run stored into its code loads through the stored word");
+#endif
+}
+
+/*
+NAME:
+
+    testCostOfSelfModifyingCode() - estimates a program that stores into its own code
+
+SYNOPSIS:
+
+    void testCostOfSelfModifyingCode();
+
+DESCRIPTION:
+
+    The program stores a branch back to its start over its HALT, so it never halts, though
+    its words as loaded execute three instructions. Nothing is known of its cost.
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void testCostOfSelfModifyingCode()
+{
+    auto emulator = makeEmulator(Emulator::Engine::Switch, {
+        { 100, word(5, 1, 0, 200) },        // load 1,200
+        { 101, word(6, 1, 0, 102) },        // store 1,102
+        { 102, word(17, 0, 0, 0) },         // halt
+        { 200, word(13, 0, 0, 100) }        // dc of a b 100
+    }, {});
+    CostEstimator::Cost cost = emulator->estimateCost().estimate(100);
+    check(cost.m_isUnknown && cost.isUnbounded(), "cost of a program that stores into its code is unknown");
+
+    cost = emulator->estimateCost().estimate(102);
+    check(!cost.m_isUnknown && cost.m_best == 1 && cost.m_worst == 1, "cost from past the store is known");
+}
+
+/*
+NAME:
+
+    testFusedOverflow() - overflows the ADD or SUB of a fused instruction
+
+SYNOPSIS:
+
+    void testFusedOverflow();
+
+DESCRIPTION:
+
+    In the compact build, a load/add/store, load/sub/store or load/sub/store/bp whose
+    arithmetic overflows stops at the ADD or SUB, after its LOAD has set the register and
+    before its STORE, on every engine.
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void testFusedOverflow()
+{
+#if VC8000_COMPACT_WORDS
+    const int big = 2'000'000'000;
+    const struct {
+        const char* m_name;
+        long long m_loaded;
+        vector<pair<int, long long>> m_program;
+    } idioms[] = {
+        { "load/add/store", big, { { 100, word(5, 1, 0, 200) }, { 101, word(1, 1, 0, 201) }, { 102, word(6, 1, 0, 200) },
+                                   { 103, word(17, 0, 0, 0) }, { 200, big }, { 201, big } } },
+        { "load/sub/store", -big, { { 100, word(5, 1, 0, 200) }, { 101, word(2, 1, 0, 201) }, { 102, word(6, 1, 0, 200) },
+                                   { 103, word(17, 0, 0, 0) }, { 200, -big }, { 201, big } } },
+        { "load/sub/store/bp", -big, { { 100, word(5, 1, 0, 200) }, { 101, word(2, 1, 0, 201) }, { 102, word(6, 1, 0, 200) },
+                                      { 103, word(16, 1, 0, 100) }, { 104, word(17, 0, 0, 0) }, { 200, -big }, { 201, big } } }
+    };
+    vector<pair<Emulator::Engine, string>> engines = { { Emulator::Engine::Switch, "switch" } };
+#if VC8000_THREADED_DISPATCH
+    engines.push_back({ Emulator::Engine::Threaded, "threaded" });
+#endif
+#if defined(__x86_64__) || defined(_M_X64)
+    engines.push_back({ Emulator::Engine::Jit, "jit" });
+#endif
+    for (const auto& idiom : idioms) {
+        for (const auto& engine : engines) {
+            auto emulator = makeEmulator(engine.first, idiom.m_program, {});
+            emulator->runProgram();
+            string name = engine.second + " " + idiom.m_name;
+            check(emulator->getTermination() == Emulator::Termination::Overflow, name + " overflows");
+            check(emulator->getRegister(1) == idiom.m_loaded, name + " overflow leaves the loaded value in the register");
+            check(emulator->getMemory(200) == idiom.m_loaded, name + " overflow stores nothing");
+        }
+    }
+#endif
+}
+
+/*
+NAME:
+
+    testInstructionCounts() - counts the instructions of runs on every engine
+
+SYNOPSIS:
+
+    void testInstructionCounts();
+
+DESCRIPTION:
+
+    Each program is run on every engine, which must all count the same instructions,
+    including those after the last taken branch, the HALT, and an instruction in error. Zero
+    words are not counted, and a READ that waits for input is counted by the run that
+    executes it.
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void testInstructionCounts()
+{
+    const struct {
+        const char* m_name;
+        long long m_instructions;
+        vector<int> m_input;
+        vector<pair<int, long long>> m_program;
+    } programs[] = {
+        // the factorial loop of test2.txt: a READ, five times through seven instructions,
+        // a WRITE and a HALT
+        { "factorial loop", 38, { 5 }, {
+            { 100, word(11, 0, 0, 110) }, { 101, word(5, 1, 0, 110) }, { 102, word(3, 1, 0, 210) },
+            { 103, word(6, 1, 0, 210) }, { 104, word(5, 1, 0, 110) }, { 105, word(2, 1, 0, 211) },
+            { 106, word(6, 1, 0, 110) }, { 107, word(16, 1, 0, 101) }, { 108, word(12, 0, 0, 210) },
+            { 109, word(17, 0, 0, 0) }, { 210, 1 }, { 211, 1 } } },
+        { "straight line", 5, {}, {
+            { 100, word(5, 1, 0, 200) }, { 101, word(1, 1, 0, 200) }, { 102, word(6, 1, 0, 201) },
+            { 103, word(12, 0, 0, 201) }, { 104, word(17, 0, 0, 0) }, { 200, 21 } } },
+        { "zero words passed over", 3, {}, {
+            { 100, word(5, 1, 0, 200) }, { 150, word(1, 1, 0, 200) }, { 199, word(17, 0, 0, 0) }, { 200, 21 } } },
+        { "branch then straight line", 4, {}, {
+            { 100, word(13, 0, 0, 150) }, { 150, word(5, 1, 0, 200) }, { 151, word(7, 1, 1, 0) },
+            { 152, word(17, 0, 0, 0) }, { 200, 21 } } },
+        { "invalid op code", 2, {}, {
+            { 100, word(5, 1, 0, 200) }, { 101, 190'000'000 }, { 200, 21 } } },
+        { "end of memory", 3, {}, {
+            { 999'998, word(5, 1, 0, 200) }, { 999'999, word(1, 1, 0, 200) }, { 100, word(13, 0, 0, 999'998) } } },
+        { "read past the input", 4, {}, {
+            { 100, word(5, 1, 0, 200) }, { 101, word(6, 1, 0, 201) }, { 102, word(11, 0, 0, 202) },
+            { 103, word(17, 0, 0, 0) } } },
+#if VC8000_COMPACT_WORDS
+        // the ADD that overflows is counted, and nothing after it in its block
+        { "overflow in a block", 2, {}, {
+            { 100, word(5, 1, 0, 200) }, { 101, word(1, 1, 0, 200) }, { 102, word(6, 1, 0, 201) },
+            { 103, word(5, 2, 0, 200) }, { 104, word(7, 2, 1, 0) }, { 105, word(17, 0, 0, 0) },
+            { 200, 2'000'000'000 } } }
+#endif
+    };
+    vector<pair<Emulator::Engine, string>> engines = { { Emulator::Engine::Switch, "switch" } };
+#if VC8000_THREADED_DISPATCH
+    engines.push_back({ Emulator::Engine::Threaded, "threaded" });
+#endif
+#if defined(__x86_64__) || defined(_M_X64)
+    engines.push_back({ Emulator::Engine::Jit, "jit" });
+#endif
+    for (const auto& program : programs) {
+        for (const auto& engine : engines) {
+            auto emulator = makeEmulator(engine.first, program.m_program, program.m_input);
+            emulator->runProgram();
+            check(emulator->getInstructionsExecuted() == program.m_instructions,
+                  engine.second + " " + program.m_name + " counts " + to_string(emulator->getInstructionsExecuted()) +
+                  " instructions of " + to_string(program.m_instructions));
+        }
+    }
+
+    // a READ with no number ready pauses before it, and is counted when the run resumes
+    for (const auto& engine : engines) {
+        static ostringstream discarded;
+        auto input = make_shared<QueueInput>();
+        Emulator emulator(input, make_shared<BufferedOutput>(discarded));
+        emulator.setEngine(engine.first);
+        emulator.insertMemory(100, word(5, 1, 0, 200));
+        emulator.insertMemory(101, word(6, 1, 0, 201));
+        emulator.insertMemory(102, word(11, 0, 0, 202));
+        emulator.insertMemory(103, word(17, 0, 0, 0));
+        emulator.setEntryPoint(100);
+        emulator.runProgram();
+        check(emulator.isPaused() && emulator.getInstructionsExecuted() == 2, engine.second + " run waiting for input counts 2 instructions");
+        input->supply(7);
+        input->close();
+        emulator.resumeProgram();
+        check(emulator.getInstructionsExecuted() == 2, engine.second + " resumed run counts the READ and HALT");
+    }
+}
+
+}
+
+/*
+NAME:
+
+    testJitReadsUnwrittenPages() - runs translations that read pages never written
+
+SYNOPSIS:
+
+    void testJitReadsUnwrittenPages();
+
+DESCRIPTION:
+
+    A translation reading a page no one has written must leave it unwritten, as the other
+    engines do, and must see the page once a READ of the interpreter, or a word inserted
+    between runs, gives it storage of its own.
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void testJitReadsUnwrittenPages()
+{
+#if defined(__x86_64__) || defined(_M_X64)
+    const vector<pair<int, long long>> program = {
+        { 100, word(5, 1, 0, 5000) },       // load 1,5000
+        { 101, word(15, 1, 0, 103) },       // bz 1,103
+        { 102, word(17, 0, 0, 0) },         // halt
+        { 103, word(11, 0, 0, 5000) },      // read 0,5000
+        { 104, word(13, 0, 0, 100) }        // b 100
+    };
+    const vector<pair<int, long long>> load = { { 100, word(5, 1, 0, 5000) }, { 101, word(17, 0, 0, 0) } };
+    auto emulator = makeEmulator(Emulator::Engine::Jit, load, {});
+    emulator->runProgram();
+    check(emulator->getDirtyPages() == 1, "jit run reading a page leaves it unwritten");
+    emulator->insertMemory(5000, 7);
+    emulator->runProgram();
+    check(emulator->getRegister(1) == 7, "jit run sees a word inserted between runs into a page it read");
+
+    Emulator::RunLimits limits;
+    limits.m_maxInstructions = 1'000;
+    emulator = makeEmulator(Emulator::Engine::Jit, program, { 42 });
+    emulator->setLimits(limits);
+    emulator->runProgram();
+    check(emulator->getTermination() == Emulator::Termination::Halted && emulator->getRegister(1) == 42,
+          "jit run sees the number read into a page it read before");
+#endif
+}
+
+/*
+NAME:
+
+    testResumeUnderSmallLimit() - resumes runs whose instruction limit is shorter than a block
+
+SYNOPSIS:
+
+    void testResumeUnderSmallLimit();
+
+DESCRIPTION:
+
+    Each iteration of the loop is a block of five instructions, and each run may execute
+    three. Every engine must get through at least one block each time the program is
+    resumed, and the runs must add up to the instructions of a run without a limit.
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void testResumeUnderSmallLimit()
+{
+    const vector<pair<int, long long>> program = {
+        { 100, word(5, 1, 0, 200) },        // load 1,200
+        { 101, word(1, 3, 0, 201) },        // add 3,201
+        { 102, word(2, 1, 0, 201) },        // sub 1,201
+        { 103, word(6, 1, 0, 200) },        // store 1,200
+        { 104, word(16, 1, 0, 100) },       // bp 1,100
+        { 105, word(17, 0, 0, 0) },         // halt
+        { 200, 20 }, { 201, 1 }
+    };
+    const pair<Emulator::Engine, string> engines[] = {
+        { Emulator::Engine::Switch, "switch" },
+        { Emulator::Engine::Threaded, "threaded" },
+        { Emulator::Engine::Jit, "jit" }
+    };
+    Emulator::RunLimits limits;
+    limits.m_maxInstructions = 3;
+    for (const auto& engine : engines) {
+        auto emulator = makeEmulator(engine.first, program, {});
+        emulator->setLimits(limits);
+        emulator->runProgram();
+        long long instructions = emulator->getInstructionsExecuted();
+        int resumes = 0;
+        while (emulator->getTermination() == Emulator::Termination::InstructionLimit && resumes < 100) {
+            emulator->resumeProgram();
+            instructions += emulator->getInstructionsExecuted();
+            resumes++;
+        }
+        check(emulator->getTermination() == Emulator::Termination::Halted && emulator->getRegister(3) == 20,
+              engine.second + " run resumed under a limit shorter than a block halts");
+        check(instructions == 101, engine.second + " runs resumed under a limit add up to the instructions executed");
+    }
+}
+
+/*
+NAME:
+
+    testErrorsGoToTheirDevices() - stops two emulators of one thread with errors
+
+SYNOPSIS:
+
+    void testErrorsGoToTheirDevices();
+
+DESCRIPTION:
+
+    As under the Scheduler, the emulators take turns on one thread. Each error must be
+    written once, to the output device of the emulator it stopped, and to no other.
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void testErrorsGoToTheirDevices()
+{
+    ostringstream first, second;
+    Emulator firstEmulator(make_shared<VectorInput>(vector<int>()), make_shared<BufferedOutput>(first));
+    Emulator secondEmulator(make_shared<VectorInput>(vector<int>()), make_shared<BufferedOutput>(second));
+    firstEmulator.insertMemory(100, 190'000'000);
+    secondEmulator.insertMemory(200, 190'000'000);
+    firstEmulator.setEntryPoint(100);
+    secondEmulator.setEntryPoint(200);
+    firstEmulator.runProgram();
+    secondEmulator.runProgram();
+
+    const string error = "Error! Error in OpCode!!\n";
+    check(first.str().find(error) != string::npos && first.str().find(error) == first.str().rfind(error),
+          "first emulator's device has its error once");
+    check(second.str().find(error) != string::npos && second.str().find(error) == second.str().rfind(error),
+          "second emulator's device has its error once");
+    check(Errors::NoError(), "errors written to devices are not recorded for the thread");
+}
+
+/*
+NAME:
+
+    testScheduledInstances() - runs many instances of a program under the Scheduler
+
+SYNOPSIS:
+
+    void testScheduledInstances();
+
+DESCRIPTION:
+
+    Each instance reads a number, counts through a loop far longer than a time slice, and
+    reads a second number before it writes their sum and halts. Every instance must wait
+    for each number, run again once it is supplied, and halt having written its own sum.
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void testScheduledInstances()
+{
+    const int INSTANCES = 64;
+    auto image = makeEmulator(Emulator::Engine::Switch, {
+        { 100, word(11, 0, 0, 300) },       // read 0,300
+        { 101, word(5, 1, 0, 300) },        // load 1,300
+        { 102, word(5, 2, 0, 301) },        // load 2,301
+        { 103, word(15, 2, 0, 107) },       // bz 2,107
+        { 104, word(2, 2, 0, 302) },        // sub 2,302
+        { 105, word(1, 1, 0, 302) },        // add 1,302
+        { 106, word(13, 0, 0, 103) },       // b 103
+        { 107, word(11, 0, 0, 303) },       // read 0,303
+        { 108, word(1, 1, 0, 303) },        // add 1,303
+        { 109, word(6, 1, 0, 304) },        // store 1,304
+        { 110, word(12, 0, 0, 304) },       // write 0,304
+        { 111, word(17, 0, 0, 0) },         // halt
+        { 301, 500 }, { 302, 1 }
+    }, {});
+    Emulator::Snapshot snapshot = image->takeSnapshot();
+
+    vector<ostringstream> outputs(INSTANCES);
+    Scheduler scheduler(4, 100);
+    for (int instance = 0; instance < INSTANCES; instance++) {
+        scheduler.addInstance(snapshot, make_shared<BufferedOutput>(outputs[instance]));
+    }
+
+    bool isWaiting = true;
+    for (int round = 0; round < 2; round++) {
+        scheduler.waitUntilIdle();
+        for (int instance = 0; instance < INSTANCES; instance++) {
+            isWaiting = isWaiting && scheduler.getState(instance) == Scheduler::State::WaitingForInput;
+            scheduler.supplyInput(instance, round == 0 ? instance : 1'000);
+        }
+    }
+    scheduler.waitUntilIdle();
+    check(isWaiting, "scheduled instances wait for each number they read");
+
+    bool isHalted = true;
+    bool isWritten = true;
+    for (int instance = 0; instance < INSTANCES; instance++) {
+        isHalted = isHalted && scheduler.getState(instance) == Scheduler::State::Halted;
+        isWritten = isWritten && outputs[instance].str().find(to_string(instance + 1'500)) != string::npos;
+    }
+    check(isHalted, "scheduled instances halt once their input is supplied");
+    check(isWritten, "each scheduled instance writes the sum of its own numbers");
+    check(scheduler.getSliceCount() > 10 * INSTANCES, "scheduled instances run their loops over many time slices");
+}
+
+/*
+NAME:
+
+    runAlone() - runs a program image on one input, the way a batch run does
+
+SYNOPSIS:
+
+    string runAlone(const Emulator::Snapshot& a_image, const string& a_input);
+    a_image     --> the program image
+    a_input     --> the text the program's READs take their input from
+
+DESCRIPTION:
+
+    The image is restored into an emulator of its own and run by Emulator::runProgram(),
+    with its WRITEs, messages and errors captured.
+
+RETURNS:
+
+    string - returns the text the run wrote
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+string runAlone(const Emulator::Snapshot& a_image, const string& a_input)
+{
+    istringstream input(a_input);
+    ostringstream output;
+    {
+        Emulator emulator(make_shared<ConsoleInput>(input), make_shared<BufferedOutput>(output));
+        emulator.restoreSnapshot(a_image);
+        Errors::InitErrorReporting();
+        Errors::SetOutput(&output);
+        emulator.runProgram();
+        Errors::SetOutput(&cout);
+    }
+    return output.str();
+}
+
+/*
+NAME:
+
+    testLockstepLanes() - runs inputs that take different branches in lockstep lanes
+
+SYNOPSIS:
+
+    void testLockstepLanes();
+
+DESCRIPTION:
+
+    The program sums 1 to n for the number it reads, and writes the sum. The inputs make the
+    lanes part at once or after a number of passes through the loop, and one is too large to
+    be read. Every lane must write what Emulator::runProgram() writes for its input.
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void testLockstepLanes()
+{
+    auto image = makeEmulator(Emulator::Engine::Switch, {
+        { 100, word(11, 0, 0, 300) },       // read 0,300
+        { 101, word(5, 1, 0, 300) },        // load 1,300
+        { 102, word(14, 1, 0, 108) },       // bm 1,108
+        { 103, word(15, 1, 0, 108) },       // bz 1,108
+        { 104, word(7, 2, 1, 0) },          // addr 2,1
+        { 105, word(2, 1, 0, 302) },        // sub 1,302
+        { 106, word(16, 1, 0, 104) },       // bp 1,104
+        { 107, word(6, 2, 0, 301) },        // store 2,301
+        { 108, word(12, 0, 0, 301) },       // write 0,301
+        { 109, word(17, 0, 0, 0) },         // halt
+        { 302, 1 }
+    }, {});
+    Emulator::Snapshot snapshot = image->takeSnapshot();
+    const string inputs[LockstepEmulator::LANES] = { "5", "0", "-3", "100", "5", "2000000", "1", "999" };
+
+    LockstepEmulator lockstep(snapshot);
+    istringstream laneInputs[LockstepEmulator::LANES];
+    ostringstream laneOutputs[LockstepEmulator::LANES];
+    for (int lane = 0; lane < LockstepEmulator::LANES; lane++) {
+        laneInputs[lane].str(inputs[lane]);
+        lockstep.setInput(lane, &laneInputs[lane]);
+        lockstep.setOutput(lane, &laneOutputs[lane]);
+    }
+    lockstep.runProgram();
+
+    bool isSame = true;
+    for (int lane = 0; lane < LockstepEmulator::LANES; lane++) {
+        isSame = isSame && laneOutputs[lane].str() == runAlone(snapshot, inputs[lane]);
+    }
+    check(isSame, "each lockstep lane writes what runProgram writes for its input");
+    check(lockstep.getSplitSteps() > 0, "lockstep lanes part where their inputs take different branches");
+}
+
+/*
+NAME:
+
+    testBatchRuns() - runs two programs on many inputs as a batch
+
+SYNOPSIS:
+
+    void testBatchRuns();
+
+DESCRIPTION:
+
+    One program writes the sum of the two numbers it reads, and the other counts down from
+    the number it reads. The runs of each are added in a block and then in turns, and the
+    batch is run on several threads, first one run at a time and then in lockstep. Every
+    run must write what the program writes when it is run alone on the same input.
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void testBatchRuns()
+{
+    auto sum = makeEmulator(Emulator::Engine::Switch, {
+        { 100, word(11, 0, 0, 300) },       // read 0,300
+        { 101, word(11, 0, 0, 301) },       // read 0,301
+        { 102, word(5, 1, 0, 300) },        // load 1,300
+        { 103, word(1, 1, 0, 301) },        // add 1,301
+        { 104, word(6, 1, 0, 302) },        // store 1,302
+        { 105, word(12, 0, 0, 302) },       // write 0,302
+        { 106, word(17, 0, 0, 0) }          // halt
+    }, {});
+    auto countdown = makeEmulator(Emulator::Engine::Switch, {
+        { 100, word(11, 0, 0, 300) },       // read 0,300
+        { 101, word(5, 1, 0, 300) },        // load 1,300
+        { 102, word(14, 1, 0, 108) },       // bm 1,108
+        { 103, word(15, 1, 0, 108) },       // bz 1,108
+        { 104, word(6, 1, 0, 301) },        // store 1,301
+        { 105, word(12, 0, 0, 301) },       // write 0,301
+        { 106, word(2, 1, 0, 302) },        // sub 1,302
+        { 107, word(13, 0, 0, 102) },       // b 102
+        { 108, word(17, 0, 0, 0) },         // halt
+        { 302, 1 }
+    }, {});
+    vector<Emulator::Snapshot> images = { sum->takeSnapshot(), countdown->takeSnapshot() };
+
+    for (bool isLockstep : { false, true }) {
+        BatchRunner runner;
+        runner.setLockstep(isLockstep);
+        runner.addProgram(images[0]);
+        runner.addProgram(images[1]);
+        for (int run = 0; run < 60; run++) {
+            int program = run < 20 ? 0 : (run < 40 ? 1 : run % 2);
+            string input = program == 0 ? to_string(run) + " " + to_string(run * 7) : to_string(run % 13 - 2);
+            runner.addRun(program, input);
+        }
+        runner.runAll(4);
+
+        bool isSame = true;
+        for (int run = 0; run < runner.getRunCount(); run++) {
+            const BatchRunner::Run& result = runner.getRun(run);
+            isSame = isSame && result.m_isComplete && result.m_output == runAlone(images[result.m_program], result.m_input);
+        }
+        check(isSame, isLockstep ? "each batch run in lockstep writes what it writes when run alone"
+                                 : "each batch run writes what it writes when run alone");
+    }
+}
+
+/*
+NAME:
+
+    testCoresHandOff() - runs two cores that hand off through a word of shared memory
+
+SYNOPSIS:
+
+    void testCoresHandOff();
+
+DESCRIPTION:
+
+    The first core counts down from 40, writing each number, and then stores a flag. The
+    second core waits for the flag, writes it, and counts down from 1040. Since the second
+    core writes nothing before it sees the flag, the numbers must appear in exactly that
+    order. Run on its own from the entry point, the first core must write what
+    Emulator::runProgram() writes.
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void testCoresHandOff()
+{
+    auto image = makeEmulator(Emulator::Engine::Switch, {
+        { 100, word(5, 1, 0, 303) },        // load 1,303
+        { 101, word(6, 1, 0, 301) },        // store 1,301
+        { 102, word(12, 0, 0, 301) },       // write 0,301
+        { 103, word(2, 1, 0, 302) },        // sub 1,302
+        { 104, word(16, 1, 0, 101) },       // bp 1,101
+        { 105, word(5, 3, 0, 304) },        // load 3,304
+        { 106, word(6, 3, 0, 500) },        // store 3,500
+        { 107, word(17, 0, 0, 0) },         // halt
+        { 200, word(5, 1, 0, 500) },        // load 1,500
+        { 201, word(15, 1, 0, 200) },       // bz 1,200
+        { 202, word(12, 0, 0, 500) },       // write 0,500
+        { 203, word(5, 1, 0, 305) },        // load 1,305
+        { 204, word(5, 2, 0, 303) },        // load 2,303
+        { 205, word(6, 1, 0, 401) },        // store 1,401
+        { 206, word(12, 0, 0, 401) },       // write 0,401
+        { 207, word(2, 1, 0, 302) },        // sub 1,302
+        { 208, word(2, 2, 0, 302) },        // sub 2,302
+        { 209, word(16, 2, 0, 205) },       // bp 2,205
+        { 210, word(17, 0, 0, 0) },         // halt
+        { 302, 1 }, { 303, 40 }, { 304, 7'777 }, { 305, 1'040 }
+    }, {});
+    Emulator::Snapshot snapshot = image->takeSnapshot();
+
+    ostringstream output;
+    bool isHalted = false;
+    {
+        MultiCoreEmulator cores(snapshot);
+        cores.setDevices(make_shared<VectorInput>(vector<int>()), make_shared<BufferedOutput>(output));
+        cores.addCore(100);
+        cores.addCore(200);
+        isHalted = cores.runProgram();
+    }
+
+    vector<long long> expected;
+    for (int number = 40; number > 0; number--) {
+        expected.push_back(number);
+    }
+    expected.push_back(7'777);
+    for (int number = 1'040; number > 1'000; number--) {
+        expected.push_back(number);
+    }
+    vector<long long> written;
+    istringstream lines(output.str());
+    string line;
+    while (getline(lines, line)) {
+        if (!line.empty() && isdigit(static_cast<unsigned char>(line[0]))) {
+            written.push_back(stoll(line));
+        }
+    }
+    check(isHalted, "cores that hand off halt without an error");
+    check(written == expected, "cores write in the order their hand off through shared memory allows");
+
+    ostringstream alone;
+    {
+        MultiCoreEmulator cores(snapshot);
+        cores.setDevices(make_shared<VectorInput>(vector<int>()), make_shared<BufferedOutput>(alone));
+        cores.runProgram();
+    }
+    check(alone.str() == runAlone(snapshot, ""), "one core from the entry point writes what runProgram writes");
+}
+
+/*
+NAME:
+
+    testTranslatedReadPastInput() - runs a C++ translation that reads past its input
+
+SYNOPSIS:
+
+    void testTranslatedReadPastInput();
+
+DESCRIPTION:
+
+    The program READs two numbers over words that are not zero, with no input at all, and
+    WRITEs them. Its translation must store 0 for each READ, as the emulator does. The
+    translation is compiled with the host's C++ compiler, so the test is skipped where
+    there is none to run from the command line.
+
+RETURNS:
+
+    void, so returns nothing
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+void testTranslatedReadPastInput()
+{
+#if defined(__GNUC__) && !defined(_WIN32)
+    auto emulator = makeEmulator(Emulator::Engine::Switch, {
+        { 100, word(11, 0, 0, 200) },       // read 0,200
+        { 101, word(11, 0, 0, 201) },       // read 0,201
+        { 102, word(12, 0, 0, 200) },       // write 0,200
+        { 103, word(12, 0, 0, 201) },       // write 0,201
+        { 104, word(17, 0, 0, 0) },         // halt
+        { 200, 5 },
+        { 201, 6 }
+    }, {});
+    const string source = "VC8000TestRead.cpp", program = "./VC8000TestRead", output = "VC8000TestRead.out";
+    {
+        ofstream translation(source);
+        CppTranslator(*emulator, SymbolTable()).TranslateProgram(translation);
+    }
+    if (system(("c++ -std=c++14 -o " + program + " " + source + " 2>/dev/null").c_str()) != 0) {
+        cout << "skipped translated read past the input, no C++ compiler" << endl;
+    }
+    else {
+        int status = system((program + " < /dev/null > " + output).c_str());
+        ifstream results(output);
+        string text((istreambuf_iterator<char>(results)), istreambuf_iterator<char>());
+        check(status == 0 && text.size() >= 4 && text.compare(text.size() - 4, 4, "0\n0\n") == 0,
+              "translated reads past the input store 0");
+    }
+    remove(source.c_str());
+    remove(program.c_str() + 2);
+    remove(output.c_str());
+#endif
+}
+
+/*
+NAME:
+
+    main() - runs the tests of the emulator's engines
+
+SYNOPSIS:
+
+    int main();
+
+RETURNS:
+
+    int - returns 0 if every check passed, 1 otherwise
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+int main()
+{
+    testSwitchAfterJitFlush();
+    testJitAfterWordChanged();
+    testCostOfSelfModifyingCode();
+    testFusedOverflow();
+    testInstructionCounts();
+    testJitReadsUnwrittenPages();
+    testResumeUnderSmallLimit();
+    testErrorsGoToTheirDevices();
+    testScheduledInstances();
+    testLockstepLanes();
+    testBatchRuns();
+    testCoresHandOff();
+    testTranslatedReadPastInput();
+
+    cout << (failures == 0 ? "all tests passed" : to_string(failures) + " checks failed") << endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,328 @@
+//
+//		Implementation of the ZeroScanner class.
+//
+#include "stdafx.h"
+#include "ZeroScanner.h"
+
+#if VC8000_SIMD_SCAN
+#include <immintrin.h>
+#endif
+
+namespace {
+    // The number of words in a 128 bit and in a 256 bit register.
+    const int WORDS_PER_XMM = 16 / sizeof(MemoryWord);
+    const int WORDS_PER_YMM = 32 / sizeof(MemoryWord);
+}
+
+ZeroScanner::Scanner ZeroScanner::s_scanner = ZeroScanner::selectScanner();
+
+/*
+NAME:
+
+    implementation() - returns the name of the scanner used on this processor
+
+SYNOPSIS:
+
+    const char* ZeroScanner::implementation();
+
+RETURNS:
+
+    const char* - "AVX2", "SSE2" or "scalar"
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+const char* ZeroScanner::implementation()
+{
+    if (s_scanner == scanAvx2) {
+        return "AVX2";
+    }
+    if (s_scanner == scanSse2) {
+        return "SSE2";
+    }
+    return "scalar";
+}
+
+/*
+NAME:
+
+    scanScalar() - finds the next non-zero word one word at a time
+
+SYNOPSIS:
+
+    int ZeroScanner::scanScalar(const MemoryWord* a_words, int a_start, int a_end);
+    a_words     --> the words to be searched
+    a_start     --> the index of the first word to check
+    a_end       --> the index just past the last word to check
+
+DESCRIPTION:
+
+    Used on processors without SSE2, and by the vector scanners to find the exact word in
+    the group of words where they saw a non-zero one, and to check the last few words.
+
+RETURNS:
+
+    int - the index of the first non-zero word, or a_end if there is none
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+int ZeroScanner::scanScalar(const MemoryWord* a_words, int a_start, int a_end)
+{
+    for (int loc = a_start; loc < a_end; loc++) {
+        if (a_words[loc] != 0) {
+            return loc;
+        }
+    }
+    return a_end;
+}
+
+/*
+NAME:
+
+    scanSse2() - finds the next non-zero word 32 bytes at a time
+
+SYNOPSIS:
+
+    int ZeroScanner::scanSse2(const MemoryWord* a_words, int a_start, int a_end);
+    a_words     --> the words to be searched
+    a_start     --> the index of the first word to check
+    a_end       --> the index just past the last word to check
+
+DESCRIPTION:
+
+    SSE2 cannot compare 64 bit values, so two registers of words are ORed together and
+    their 32 bit parts compared with zero. The words that remain once a group is not all
+    zero are left to scanScalar().
+
+RETURNS:
+
+    int - the index of the first non-zero word, or a_end if there is none
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+VC8000_TARGET("sse2")
+int ZeroScanner::scanSse2(const MemoryWord* a_words, int a_start, int a_end)
+{
+    int loc = a_start;
+#if VC8000_SIMD_SCAN
+    const __m128i zero = _mm_setzero_si128();
+    for (; loc + 2 * WORDS_PER_XMM <= a_end; loc += 2 * WORDS_PER_XMM) {
+        __m128i bits = _mm_or_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a_words + loc)),
+                                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(a_words + loc + WORDS_PER_XMM)));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(bits, zero)) != 0xFFFF) {
+            break;
+        }
+    }
+#endif
+    return scanScalar(a_words, loc, a_end);
+}
+
+/*
+NAME:
+
+    scanAvx2() - finds the next non-zero word 64 bytes at a time
+
+SYNOPSIS:
+
+    int ZeroScanner::scanAvx2(const MemoryWord* a_words, int a_start, int a_end);
+    a_words     --> the words to be searched
+    a_start     --> the index of the first word to check
+    a_end       --> the index just past the last word to check
+
+DESCRIPTION:
+
+    Two 256 bit registers of words are ORed together and tested for zero with one
+    instruction. The words that remain once a group is not all zero are left to scanScalar().
+
+RETURNS:
+
+    int - the index of the first non-zero word, or a_end if there is none
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+VC8000_TARGET("avx2")
+int ZeroScanner::scanAvx2(const MemoryWord* a_words, int a_start, int a_end)
+{
+    int loc = a_start;
+#if VC8000_SIMD_SCAN
+    for (; loc + 2 * WORDS_PER_YMM <= a_end; loc += 2 * WORDS_PER_YMM) {
+        __m256i bits = _mm256_or_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a_words + loc)),
+                                       _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a_words + loc + WORDS_PER_YMM)));
+        if (!_mm256_testz_si256(bits, bits)) {
+            break;
+        }
+    }
+#endif
+    return scanScalar(a_words, loc, a_end);
+}
+
+/*
+NAME:
+
+    useImplementation() - makes later scans use a scanner chosen by name
+
+SYNOPSIS:
+
+    bool ZeroScanner::useImplementation(const string& a_name);
+    a_name      --> "AVX2", "SSE2" or "scalar"
+
+DESCRIPTION:
+
+    A scanner is only used if the one selectScanner() chose when the program started is it
+    or a faster one, since the processor then supports it.
+
+RETURNS:
+
+    bool - returns true if the scanner is used, false otherwise
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+bool ZeroScanner::useImplementation(const string& a_name)
+{
+    Scanner best = selectScanner();
+    if (a_name == "AVX2" && best == scanAvx2) {
+        s_scanner = scanAvx2;
+    }
+    else if (a_name == "SSE2" && best != scanScalar) {
+        s_scanner = scanSse2;
+    }
+    else if (a_name == "scalar") {
+        s_scanner = scanScalar;
+    }
+    else {
+        return false;
+    }
+    return true;
+}
+
+/*
+NAME:
+
+    hasAvx2() - checks whether AVX2 instructions can be used
+
+SYNOPSIS:
+
+    bool ZeroScanner::hasAvx2();
+
+DESCRIPTION:
+
+    AVX2 can be used only if both the processor and the operating system support it; the
+    operating system must save the 256 bit registers, which is checked with XGETBV. The
+    check does not depend on any static data, so it can be made while other static data
+    is being initialized.
+
+RETURNS:
+
+    bool - returns true if AVX2 can be used
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+bool ZeroScanner::hasAvx2()
+{
+#if VC8000_SIMD_SCAN && defined(__GNUC__)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+#elif VC8000_SIMD_SCAN && defined(_MSC_VER)
+    int info[4] = { 0 };
+    __cpuid(info, 0);
+    int maxLeaf = info[0];
+    __cpuid(info, 1);
+    bool hasAvx = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0;
+    if (hasAvx && maxLeaf >= 7 && (_xgetbv(0) & 6) == 6) {
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+    }
+    return false;
+#else
+    return false;
+#endif
+}
+
+/*
+NAME:
+
+    selectScanner() - chooses the fastest scanner the processor supports
+
+SYNOPSIS:
+
+    ZeroScanner::Scanner ZeroScanner::selectScanner();
+
+RETURNS:
+
+    Scanner - the scanner to use
+
+AUTHOR:
+
+    Ritika Dawadi
+
+DATE:
+
+    4:00pm 5/14/24
+
+*/
+
+ZeroScanner::Scanner ZeroScanner::selectScanner()
+{
+    if (hasAvx2()) {
+        return scanAvx2;
+    }
+#if VC8000_SIMD_SCAN && defined(__GNUC__)
+    if (__builtin_cpu_supports("sse2")) {
+        return scanSse2;
+    }
+#elif VC8000_SIMD_SCAN && defined(_MSC_VER)
+    int info[4] = { 0 };
+    __cpuid(info, 1);
+    if (info[3] & (1 << 26)) {
+        return scanSse2;
+    }
+#endif
+    return scanScalar;
+}
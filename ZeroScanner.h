@@ -0,0 +1,60 @@
+//
+//		ZeroScanner class - finds the next non-zero word in a run of memory words
+//
+#ifndef _ZEROSCANNER_H
+#define _ZEROSCANNER_H
+
+#include "MemoryWord.h"
+
+// The vector scanners use the SSE2 and AVX2 instructions of x86 processors.
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define VC8000_SIMD_SCAN 1
+#else
+#define VC8000_SIMD_SCAN 0
+#endif
+
+// g++ and clang only generate SSE2 and AVX2 instructions in functions marked for them, so that
+// the rest of the program still runs on processors without them.
+#if VC8000_SIMD_SCAN && defined(__GNUC__)
+#define VC8000_TARGET(a_instructions) __attribute__((target(a_instructions)))
+#else
+#define VC8000_TARGET(a_instructions)
+#endif
+
+class ZeroScanner {
+
+public:
+
+    // Returns the index of the first non-zero word in a_words[a_start, a_end), or a_end if
+    // they are all zero.  The fastest scanner the processor supports is used.
+    static int findNonZero(const MemoryWord* a_words, int a_start, int a_end) {
+        return s_scanner(a_words, a_start, a_end);
+    }
+
+    // Returns the name of the scanner chosen for this processor: "AVX2", "SSE2" or "scalar".
+    static const char* implementation();
+
+    // Makes every later scan use the scanner named, as implementation() names them, so that
+    // they can be compared.  Returns false, changing nothing, if there is no such scanner or
+    // the processor does not support it.  Called while no emulator is running.
+    static bool useImplementation(const string& a_name);
+
+    // Checks whether the processor and the operating system support AVX2.
+    static bool hasAvx2();
+
+private:
+
+    typedef int (*Scanner)(const MemoryWord* a_words, int a_start, int a_end);
+
+    // The scanners, which all return the same result.
+    static int scanScalar(const MemoryWord* a_words, int a_start, int a_end);
+    static int scanSse2(const MemoryWord* a_words, int a_start, int a_end);
+    static int scanAvx2(const MemoryWord* a_words, int a_start, int a_end);
+
+    // Checks which instructions the processor supports and returns the scanner to use.
+    static Scanner selectScanner();
+
+    static Scanner s_scanner;           // The scanner chosen when the program starts.
+};
+
+#endif
@@ -23,6 +23,17 @@
 #include <algorithm>
 #include <exception>
 #include <iomanip>
+#include <memory>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <climits>
+#include <condition_variable>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
 using namespace std;
 